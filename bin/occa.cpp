@@ -1,3 +1,4 @@
+#include <ctime>
 #include <fstream>
 
 #include <occa.hpp>
@@ -123,6 +124,110 @@ bool runClear(const json &args) {
   return true;
 }
 
+std::string stringifyAge(const double seconds) {
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(1);
+  if (seconds < 60) {
+    ss << seconds << " seconds";
+  } else if (seconds < 3600) {
+    ss << (seconds / 60) << " minutes";
+  } else if (seconds < 86400) {
+    ss << (seconds / 3600) << " hours";
+  } else {
+    ss << (seconds / 86400) << " days";
+  }
+  return ss.str();
+}
+
+bool runCacheStats(const json &args) {
+  io::cacheEntryVector entries = io::getCacheEntries();
+  const int entryCount = (int) entries.size();
+
+  udim_t totalBytes = 0;
+  int completeEntries = 0;
+  int lockedEntries = 0;
+  double oldestAccess = 0;
+  double newestAccess = 0;
+  for (int i = 0; i < entryCount; ++i) {
+    const io::cacheEntry_t &entry = entries[i];
+    totalBytes += entry.bytes;
+    completeEntries += entry.isComplete;
+    lockedEntries += entry.isLocked;
+    if (!i || (entry.lastAccess < oldestAccess)) {
+      oldestAccess = entry.lastAccess;
+    }
+    if (!i || (newestAccess < entry.lastAccess)) {
+      newestAccess = entry.lastAccess;
+    }
+  }
+
+  const udim_t maxBytes = io::getCacheMaxBytes();
+  const int maxEntries = io::getCacheMaxEntries();
+  const double now = (double) ::time(NULL);
+
+  std::cout << "  Cache         : " << io::cachePath() << '\n'
+            << "  Entries       : " << entryCount
+            << " (" << completeEntries << " complete, "
+            << lockedEntries << " locked)\n"
+            << "  Size          : " << (totalBytes ? stringifyBytes(totalBytes) : "0 bytes") << '\n'
+            << "  Max size      : " << (maxBytes ? stringifyBytes(maxBytes) : "[NOT SET]") << '\n'
+            << "  Max entries   : " << (maxEntries ? toString(maxEntries) : "[NOT SET]") << '\n';
+  if (entryCount) {
+    std::cout << "  Oldest access : " << stringifyAge(now - oldestAccess) << " ago\n"
+              << "  Newest access : " << stringifyAge(now - newestAccess) << " ago\n";
+  }
+  return true;
+}
+
+bool runCacheGc(const json &args) {
+  const json &options = args["options"];
+
+  const std::string maxSizeArg = options["max-size"];
+  const std::string maxEntriesArg = options["max-entries"];
+  const std::string minAgeArg = options["min-age"];
+
+  const udim_t maxBytes = (
+    maxSizeArg.size()
+    ? parseBytes(maxSizeArg)
+    : io::getCacheMaxBytes()
+  );
+  const int maxEntries = (
+    maxEntriesArg.size()
+    ? fromString<int>(maxEntriesArg)
+    : io::getCacheMaxEntries()
+  );
+  const double minAge = (
+    minAgeArg.size()
+    ? fromString<double>(minAgeArg)
+    : io::getCacheMinAge()
+  );
+
+  if (!maxBytes && !maxEntries) {
+    printError("No cache limits given, use --max-size, --max-entries,"
+               " or set OCCA_CACHE_MAX_SIZE or OCCA_CACHE_MAX_ENTRIES");
+    ::exit(1);
+  }
+
+  const int evictedEntries = io::evictCacheEntries(maxBytes, maxEntries, minAge);
+  std::cout << "  Evicted " << evictedEntries << " cache entries\n";
+  return true;
+}
+
+bool runCachePrune(const json &args) {
+  const json &options = args["options"];
+
+  const std::string minAgeArg = options["min-age"];
+  const double minAge = (
+    minAgeArg.size()
+    ? fromString<double>(minAgeArg)
+    : io::getCacheMinAge()
+  );
+
+  const int removed = io::pruneCache(minAge);
+  std::cout << "  Removed " << removed << " incomplete cache entries and stale locks\n";
+  return true;
+}
+
 bool runVersion(const json &args) {
   if (args["options/okl"]) {
     std::cout << OKL_VERSION_STR << '\n';
@@ -236,7 +341,18 @@ bool runCompile(const json &args) {
   kernelProps["defines"].asObject() += getOptionDefines(options["define"]);
 
   device device(deviceProps);
-  device.buildKernel(filename, kernelName, kernelProps);
+  kernel builtKernel = device.buildKernel(filename, kernelName, kernelProps);
+
+  const std::string library = options["library"];
+  if (library.size()) {
+    if (!builtKernel.isInitialized()
+        || !io::addCacheEntryToLibrary(io::hashDir(builtKernel.hash()), library)) {
+      printError("Unable to add [" + kernelName + "] to library [" + library + "]");
+      ::exit(1);
+    }
+    std::cout << "Added [" << kernelName << "] to ["
+              << io::libraryCachePath(library) << "]\n";
+  }
 
   return true;
 }
@@ -245,6 +361,9 @@ bool runEnv(const json &args) {
   std::cout << "  Basic:\n"
             << "    - OCCA_DIR                   : " << envEcho("OCCA_DIR") << "\n"
             << "    - OCCA_CACHE_DIR             : " << envEcho("OCCA_CACHE_DIR") << "\n"
+            << "    - OCCA_CACHE_MAX_SIZE        : " << envEcho("OCCA_CACHE_MAX_SIZE") << "\n"
+            << "    - OCCA_CACHE_MAX_ENTRIES     : " << envEcho("OCCA_CACHE_MAX_ENTRIES") << "\n"
+            << "    - OCCA_CACHE_FILE_HASHES     : " << envEcho("OCCA_CACHE_FILE_HASHES") << "\n"
             << "    - OCCA_VERBOSE               : " << envEcho("OCCA_VERBOSE") << "\n"
             << "    - OCCA_UNSAFE                : " << OCCA_UNSAFE << "\n"
 
@@ -270,6 +389,7 @@ bool runEnv(const json &args) {
             << "    - OCCA_INCLUDE_PATH          : " << envEcho("OCCA_INCLUDE_PATH") << "\n"
             << "    - OCCA_LIBRARY_PATH          : " << envEcho("OCCA_LIBRARY_PATH") << "\n"
             << "    - OCCA_KERNEL_PATH           : " << envEcho("OCCA_KERNEL_PATH") << "\n"
+            << "    - OCCA_HASH_VERSION          : " << envEcho("OCCA_HASH_VERSION", getHashVersion()) << "\n"
             << "    - OCCA_OPENCL_COMPILER_FLAGS : " << envEcho("OCCA_OPENCL_COMPILER_FLAGS") << "\n"
             << "    - OCCA_CUDA_COMPILER         : " << envEcho("OCCA_CUDA_COMPILER") << "\n"
             << "    - OCCA_CUDA_COMPILER_FLAGS   : " << envEcho("OCCA_CUDA_COMPILER_FLAGS") << "\n"
@@ -329,6 +449,45 @@ int main(const int argc, const char **argv) {
     .addOption(cli::option('y', "yes",
                            "Automatically answer everything with [y/yes]"));
 
+  cli::command cacheStatsCommand;
+  cacheStatsCommand
+    .withName("stats")
+    .withCallback(runCacheStats)
+    .withDescription("Prints the cached kernel count and size");
+
+  cli::command cacheGcCommand;
+  cacheGcCommand
+    .withName("gc")
+    .withCallback(runCacheGc)
+    .withDescription("Evicts least recently used cached kernels until the cache fits its limits")
+    .addOption(cli::option('s', "max-size",
+                           "Maximum cache size, such as 10GB (Default: cache/max_size setting)")
+               .withArg())
+    .addOption(cli::option('n', "max-entries",
+                           "Maximum cached kernel directories (Default: cache/max_entries setting)")
+               .withArg())
+    .addOption(cli::option("min-age",
+                           "Keep entries accessed in the last N seconds (Default: 60)")
+               .withArg());
+
+  cli::command cachePruneCommand;
+  cachePruneCommand
+    .withName("prune")
+    .withCallback(runCachePrune)
+    .withDescription("Removes incomplete cached kernels and stale locks")
+    .addOption(cli::option("min-age",
+                           "Keep entries accessed in the last N seconds (Default: 60)")
+               .withArg());
+
+  cli::command cacheCommand;
+  cacheCommand
+    .withName("cache")
+    .withDescription("Inspect and trim the kernel cache")
+    .requiresCommand()
+    .addCommand(cacheStatsCommand)
+    .addCommand(cacheGcCommand)
+    .addCommand(cachePruneCommand);
+
   cli::command translateCommand;
   translateCommand
     .withName("translate")
@@ -379,6 +538,9 @@ int main(const int argc, const char **argv) {
                            "Add additional define")
                .reusable()
                .withArg())
+    .addOption(cli::option("library",
+                           "Package the compiled kernels into a library loaded with device::loadKernels(library)")
+               .withArg())
     .addArgument("FILE",
                  "An .okl file",
                  true)
@@ -422,6 +584,7 @@ int main(const int argc, const char **argv) {
     .requiresCommand()
     .addCommand(versionCommand)
     .addCommand(clearCommand)
+    .addCommand(cacheCommand)
     .addCommand(translateCommand)
     .addCommand(compileCommand)
     .addCommand(envCommand)
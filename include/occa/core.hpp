@@ -2,7 +2,9 @@
 #define OCCA_CORE_HEADER
 
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/core/device.hpp>
+#include <occa/core/graph.hpp>
 #include <occa/core/kernel.hpp>
 #include <occa/core/kernelArg.hpp>
 #include <occa/core/kernelBuilder.hpp>
@@ -14,6 +14,7 @@
 #endif
 
 #include <occa/core/device.hpp>
+#include <occa/core/graph.hpp>
 #include <occa/core/kernel.hpp>
 #include <occa/core/memory.hpp>
 #include <occa/core/stream.hpp>
@@ -43,6 +44,9 @@ namespace occa {
   void setStream(stream s);
 
   streamTag tagStream();
+
+  void beginCapture();
+  graph endCapture();
   //====================================
 
   //---[ Kernel Functions ]-------------
@@ -50,6 +54,9 @@ namespace occa {
                      const std::string &kernelName,
                      const occa::properties &props = occa::properties());
 
+  namedKernelMap buildKernels(const std::string &filename,
+                              const occa::properties &props = occa::properties());
+
   kernel buildKernelFromString(const std::string &content,
                                const std::string &kernelName,
                                const occa::properties &props = occa::properties());
@@ -90,6 +97,11 @@ namespace occa {
                       const void *src,
                       const occa::properties &props);
 
+  occa::memory mmap(const std::string &filename,
+                    const udim_t offset = 0,
+                    const udim_t bytes = 0,
+                    const occa::properties &props = occa::properties());
+
   void memcpy(void *dest, const void *src,
               const dim_t bytes,
               const occa::properties &props = properties());
@@ -0,0 +1,94 @@
+#ifndef OCCA_CORE_BUILDSTATS_HEADER
+#define OCCA_CORE_BUILDSTATS_HEADER
+
+#include <string>
+
+#include <occa/tools/json.hpp>
+
+namespace occa {
+  // Kernel build stages
+  //   hashing:      Hashing the source and kernel properties
+  //   dependencies: Checking if cached kernels had their dependencies change
+  //   parsing:      Parsing and transforming OKL sources
+  //   codegen:      Writing the transformed sources
+  //   compiling:    Running the compiler
+  //   loading:      Loading binaries (dlopen, modules, programs)
+  namespace buildStage {
+    static const int hashing      = 0;
+    static const int dependencies = 1;
+    static const int parsing      = 2;
+    static const int codegen      = 3;
+    static const int compiling    = 4;
+    static const int loading      = 5;
+    static const int count        = 6;
+
+    std::string name(const int stage);
+  }
+
+  class buildStats_t {
+  public:
+    // Seconds spent in each build stage
+    double stageTimes[buildStage::count];
+
+    // Kernels found in the device kernel cache
+    int memoryCacheHits;
+    // Kernels loaded from a cached binary
+    int diskCacheHits;
+    // Kernels which reused a binary built with other properties
+    int sharedBinaryHits;
+    // Kernels which were compiled
+    int cacheMisses;
+
+    buildStats_t();
+
+    void clear();
+
+    double totalTime() const;
+
+    buildStats_t& operator += (const buildStats_t &other);
+
+    json toJson() const;
+  };
+
+  // Totals from every kernel build in this process
+  buildStats_t getBuildStats();
+
+  void resetBuildStats();
+
+  namespace buildStats {
+    // Adds to the process totals and the kernel build in this thread
+    void addStageTime(const int stage,
+                      const double seconds);
+
+    void addMemoryCacheHit();
+    void addDiskCacheHit();
+    void addSharedBinaryHit();
+    void addCacheMiss();
+
+    // Times a build stage until it goes out of scope
+    class stageTimer {
+    private:
+      int stage;
+      double startTime;
+
+    public:
+      stageTimer(const int stage_);
+      ~stageTimer();
+    };
+
+    // Collects the stats from a kernel build in this thread
+    //   while it's in scope
+    class kernelScope {
+    private:
+      buildStats_t *previousStats;
+
+    public:
+      buildStats_t stats;
+
+      kernelScope();
+      ~kernelScope();
+    };
+  }
+}
+
+#endif
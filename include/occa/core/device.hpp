@@ -1,11 +1,17 @@
 #ifndef OCCA_CORE_DEVICE_HEADER
 #define OCCA_CORE_DEVICE_HEADER
 
+#include <condition_variable>
+#include <exception>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 
+#include <occa/core/graph.hpp>
 #include <occa/core/kernel.hpp>
 #include <occa/core/memory.hpp>
+#include <occa/core/memoryPool.hpp>
 #include <occa/core/stream.hpp>
 #include <occa/defines.hpp>
 #include <occa/dtype.hpp>
@@ -17,11 +23,16 @@ namespace occa {
   class modeKernel_t; class kernel;
   class modeDevice_t; class device;
   class modeStreamTag_t; class streamTag;
+  class kernelBuildState_t; class kernelFuture;
   class deviceInfo;
 
-  typedef std::map<std::string, kernel>   cachedKernelMap;
-  typedef cachedKernelMap::iterator       cachedKernelMapIterator;
-  typedef cachedKernelMap::const_iterator cCachedKernelMapIterator;
+  // Kernels are only referenced by their wrappers,
+  //   ~modeKernel_t() removes itself from the cache
+  typedef std::map<std::string, modeKernel_t*> cachedKernelMap;
+  typedef cachedKernelMap::iterator            cachedKernelMapIterator;
+  typedef cachedKernelMap::const_iterator      cCachedKernelMapIterator;
+
+  typedef std::map<std::string, jsonObject> kernelDependencyMap;
 
   //---[ modeDevice_t ]---------------------
   class modeDevice_t {
@@ -43,8 +54,24 @@ namespace occa {
     std::vector<modeStream_t*> streams;
 
     udim_t bytesAllocated;
+    memoryPool_t memoryPool;
+
+    // Guards the kernel ring and cache since kernels can be built
+    //   concurrently by the build thread pool
+    std::mutex kernelMutex;
 
     cachedKernelMap cachedKernels;
+    // build.json dependencies, only read once per kernel hash
+    kernelDependencyMap kernelDependencies;
+    // Kernels from device::loadKernels(), kept until the device is freed
+    std::vector<kernel> loadedKernels;
+
+    // Builds submitted to the build thread pool which haven't finished,
+    //   freeResources() waits for them and cancels the ones not started
+    std::mutex buildMutex;
+    std::condition_variable buildCondition;
+    int pendingBuilds;
+    bool cancelBuilds;
 
     modeDevice_t(const occa::properties &properties_);
 
@@ -60,6 +87,11 @@ namespace occa {
     // Must be called before ~modeDevice_t()!
     void freeResources();
 
+    void addPendingBuild();
+    // Returns false if the build was cancelled
+    bool startPendingBuild();
+    void finishPendingBuild();
+
     void dontUseRefs();
     void addDeviceRef(device *dev);
     void removeDeviceRef(device *dev);
@@ -74,6 +106,12 @@ namespace occa {
     void addStreamRef(modeStream_t *stream);
     void removeStreamRef(modeStream_t *stream);
 
+    // Graph capturing launches and copies on the current stream, if any
+    inline graph_t* getCaptureGraph() const {
+      modeStream_t *modeStream = currentStream.getModeStream();
+      return modeStream ? modeStream->captureGraph : NULL;
+    }
+
     void addStreamTagRef(modeStreamTag_t *streamTag);
     void removeStreamTagRef(modeStreamTag_t *streamTag);
 
@@ -111,9 +149,10 @@ namespace occa {
 
     std::string getKernelHash(modeKernel_t *kernel);
 
-    kernel& getCachedKernel(const hash_t &kernelHash,
-                            const std::string &kernelName);
+    modeKernel_t* getCachedKernel(const hash_t &kernelHash,
+                                  const std::string &kernelName);
 
+    void addCachedKernel(modeKernel_t *kernel);
     void removeCachedKernel(modeKernel_t *kernel);
 
     virtual modeKernel_t* buildKernel(const std::string &filename,
@@ -121,6 +160,12 @@ namespace occa {
                                       const hash_t hash,
                                       const occa::properties &props) = 0;
 
+    // Builds every @kernel in [filename] from one transformed source
+    virtual bool buildKernels(const std::string &filename,
+                              const hash_t hash,
+                              const occa::properties &props,
+                              std::vector<modeKernel_t*> &kernels) = 0;
+
     virtual modeKernel_t* buildKernelFromBinary(const std::string &filename,
                                                 const std::string &kernelName,
                                                 const occa::properties &props) = 0;
@@ -131,6 +176,13 @@ namespace occa {
                                  const void* src,
                                  const occa::properties &props) = 0;
 
+    // Uploads [bytes] from [filename] in chunks
+    //   - Host modes map the file instead
+    virtual modeMemory_t* mmap(const std::string &filename,
+                               const udim_t offset,
+                               const udim_t bytes,
+                               const occa::properties &props);
+
     virtual udim_t memorySize() const = 0;
     //  |===============================
     //==================================
@@ -192,6 +244,12 @@ namespace occa {
     udim_t memorySize() const;
     udim_t memoryAllocated() const;
 
+    // Memory pool from the memory property pool: true
+    memoryPoolStats_t memoryPoolStats() const;
+    // Frees cached blocks until at most [bytes] are cached,
+    //   trimMemoryPool() releases all of them
+    void trimMemoryPool(const udim_t bytes = 0);
+
     void finish();
 
     bool hasSeparateMemorySpace();
@@ -208,6 +266,13 @@ namespace occa {
                        const streamTag &endTag);
     //  |===============================
 
+    //  |---[ Graph ]-------------------
+    // Captures on the current stream
+    void beginCapture();
+    graph endCapture();
+    bool isCapturing() const;
+    //  |===============================
+
     //  |---[ Kernel ]------------------
     void setupKernelInfo(const occa::properties &props,
                          const hash_t &sourceHash,
@@ -216,10 +281,22 @@ namespace occa {
 
     hash_t applyDependencyHash(const hash_t &kernelHash) const;
 
+    // Dependency files and their hashes from the kernel's build.json,
+    //   NULL if it wasn't built yet
+    const jsonObject* findDependencyHashes(const hash_t &kernelHash) const;
+
+    kernel getCachedKernel(const hash_t &kernelHash,
+                           const std::string &kernelName) const;
+
     occa::kernel buildKernel(const std::string &filename,
                              const std::string &kernelName,
                              const occa::properties &props = occa::properties()) const;
 
+    // Builds all @kernels in [filename], keyed by their name
+    //   - The source is transformed and compiled once for all kernels
+    namedKernelMap buildKernels(const std::string &filename,
+                                const occa::properties &props = occa::properties()) const;
+
     occa::kernel buildKernelFromString(const std::string &content,
                                        const std::string &kernelName,
                                        const occa::properties &props = occa::properties()) const;
@@ -228,7 +305,33 @@ namespace occa {
                                        const std::string &kernelName,
                                        const occa::properties &props = occa::properties()) const;
 
-    void loadKernels(const std::string &library = "");
+    kernelFuture buildKernelAsync(const std::string &filename,
+                                  const std::string &kernelName,
+                                  const occa::properties &props = occa::properties()) const;
+
+    kernelFuture buildKernelFromStringAsync(const std::string &content,
+                                            const std::string &kernelName,
+                                            const occa::properties &props = occa::properties()) const;
+
+  private:
+    // Lets buildKernel skip hashing while the files in the build stay the same
+    void memoizeKernelHash(const std::string &memoKey,
+                           const hash_t &kernelHash,
+                           const std::string &realFilename) const;
+
+    std::string writeStringSource(const std::string &content,
+                                  const hash_t &kernelHash) const;
+
+    kernelFuture submitKernelBuild(const std::string &filename,
+                                   const std::string &kernelName,
+                                   const hash_t &kernelHash,
+                                   occa::properties &kernelProps) const;
+
+  public:
+    // Loads cached kernels built for this device into the kernel cache
+    //   - Library kernels are first installed into the cache
+    //   - Returns the number of loaded kernels
+    int loadKernels(const std::string &library = "");
     //  |===============================
 
     //  |---[ Memory ]------------------
@@ -260,6 +363,10 @@ namespace occa {
     occa::memory malloc(const dim_t bytes,
                         const occa::properties &props);
 
+    // Properties:
+    //   dirty_tracking: After the first full sync, syncs only copy the
+    //                   ranges declared with occa::markDirty
+    //   dirty_granularity: Dirty ranges are rounded to these bytes (default: page size)
     void* umalloc(const dim_t entries,
                   const dtype_t &dtype,
                   const void *src = NULL,
@@ -287,6 +394,19 @@ namespace occa {
     template <class TM = void>
     TM* umalloc(const dim_t entries,
                 const occa::properties &props);
+
+    // Memory with [bytes] from [filename] starting at [offset]
+    //   - [bytes] = 0 uses the rest of the file
+    //   - Host modes map the file without copying it
+    //   - Separate memory spaces upload the file in chunks
+    // Properties:
+    //   read_only: Use a read-only mapping, otherwise it's copy-on-write
+    //   advise: 'sequential' | 'willneed' | 'random' | 'normal' (or a list)
+    //   chunk_bytes: Upload chunk size (default: 64MB)
+    occa::memory mmap(const std::string &filename,
+                      const udim_t offset = 0,
+                      const udim_t bytes = 0,
+                      const occa::properties &props = occa::properties());
     //  |===============================
   };
 
@@ -311,6 +431,44 @@ namespace occa {
                                     const occa::properties &props);
   //====================================
 
+  //---[ kernelFuture ]-----------------
+  // Shared between a kernelFuture and its build job
+  // The build job only sets modeKernel/error, wrappers are
+  //   only created or freed by the thread owning the future
+  class kernelBuildState_t {
+  public:
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool isDone;
+
+    occa::device device;
+    occa::kernel kernel;
+    modeKernel_t *modeKernel;
+    std::exception_ptr error;
+
+    kernelBuildState_t(const occa::device &device_);
+    ~kernelBuildState_t();
+  };
+
+  // Handle to a kernel built by the build thread pool
+  // Destroying the last handle waits for the build to finish
+  class kernelFuture {
+  private:
+    std::shared_ptr<kernelBuildState_t> state;
+
+  public:
+    kernelFuture();
+    kernelFuture(std::shared_ptr<kernelBuildState_t> state_);
+    ~kernelFuture();
+
+    bool isInitialized() const;
+    bool isReady() const;
+
+    void wait() const;
+    occa::kernel get() const;
+  };
+  //====================================
+
   //---[ Utils ]------------------------
   occa::properties getModeSpecificProps(const std::string &mode,
                                         const occa::properties &props);
@@ -0,0 +1,126 @@
+#ifndef OCCA_CORE_GRAPH_HEADER
+#define OCCA_CORE_GRAPH_HEADER
+
+#include <vector>
+
+#include <occa/defines.hpp>
+#include <occa/core/kernel.hpp>
+#include <occa/core/memory.hpp>
+#include <occa/tools/gc.hpp>
+#include <occa/tools/properties.hpp>
+
+namespace occa {
+  class graph_t; class graph;
+
+  //---[ graphNode_t ]------------------
+  class graphNode_t {
+  public:
+    virtual ~graphNode_t();
+
+    virtual void run() const = 0;
+  };
+
+  // The bound launch holds references to its memory arguments
+  class kernelGraphNode_t : public graphNode_t {
+  public:
+    boundKernel launch;
+
+    kernelGraphNode_t(const boundKernel &launch_);
+
+    void run() const;
+  };
+
+  // Either side of the copy can be a host pointer
+  class memcpyGraphNode_t : public graphNode_t {
+  public:
+    occa::memory dest;
+    occa::memory src;
+    void *destPtr;
+    const void *srcPtr;
+    udim_t bytes;
+    udim_t destOffset;
+    udim_t srcOffset;
+    occa::properties props;
+
+    memcpyGraphNode_t(occa::memory dest_,
+                      occa::memory src_,
+                      void *destPtr_,
+                      const void *srcPtr_,
+                      const udim_t bytes_,
+                      const udim_t destOffset_,
+                      const udim_t srcOffset_,
+                      const occa::properties &props_);
+
+    void run() const;
+  };
+  //====================================
+
+  //---[ graph_t ]----------------------
+  class graph_t : public gc::withRefs {
+  public:
+    std::vector<graphNode_t*> nodes;
+    std::vector<kernelGraphNode_t*> launches;
+
+    graph_t();
+    ~graph_t();
+
+    void addLaunch(const boundKernel &launch);
+
+    void addCopy(occa::memory dest,
+                 occa::memory src,
+                 void *destPtr,
+                 const void *srcPtr,
+                 const udim_t bytes,
+                 const udim_t destOffset,
+                 const udim_t srcOffset,
+                 const occa::properties &props);
+
+    void run() const;
+  };
+  //====================================
+
+  //---[ graph ]------------------------
+  // Kernel launches and memory copies recorded between
+  //   device::beginCapture() and device::endCapture().
+  // Only work issued while the capturing stream is the current stream is
+  //   recorded, other streams keep running work and can capture their own graph
+  // Replays skip argument setup and validation, only scalar
+  //   arguments can be updated between replays
+  class graph {
+  private:
+    graph_t *graph_;
+
+  public:
+    graph();
+    graph(graph_t *graph__);
+
+    graph(const graph &other);
+    graph& operator = (const graph &other);
+    ~graph();
+
+  private:
+    void setGraph(graph_t *graph__);
+    void removeRef();
+    void assertInitialized() const;
+
+  public:
+    bool isInitialized() const;
+
+    int size() const;
+    int launchCount() const;
+
+    boundKernel& getLaunch(const int index);
+
+    void setArg(const int launchIndex,
+                const int argIndex,
+                const kernelArg &arg);
+
+    void run() const;
+    void operator () () const;
+
+    void free();
+  };
+  //====================================
+}
+
+#endif
@@ -7,6 +7,7 @@
 
 #include <occa/defines.hpp>
 #include <occa/core/kernelArg.hpp>
+#include <occa/core/memory.hpp>
 #include <occa/lang/kernelMetadata.hpp>
 #include <occa/tools/gc.hpp>
 #include <occa/tools/properties.hpp>
@@ -14,6 +15,7 @@
 
 namespace occa {
   class modeKernel_t; class kernel;
+  class boundKernel;
   class modeMemory_t; class memory;
   class modeDevice_t; class device;
   class kernelBuilder;
@@ -26,11 +28,35 @@ namespace occa {
   typedef hashedKernelMap::iterator           hashedKernelMapIterator;
   typedef hashedKernelMap::const_iterator     cHashedKernelMapIterator;
 
+  typedef std::map<std::string, kernel>       namedKernelMap;
+  typedef namedKernelMap::iterator            namedKernelMapIterator;
+  typedef namedKernelMap::const_iterator      cNamedKernelMapIterator;
+
   typedef std::vector<kernelBuilder>          kernelBuilderVector;
   typedef kernelBuilderVector::iterator       kernelBuilderVectorIterator;
   typedef kernelBuilderVector::const_iterator cKernelBuilderVectorIterator;
 
 
+  namespace typeValidationMode {
+    static const int none   = 0;
+    static const int always = 1;
+    static const int once   = 2;
+  }
+
+  //---[ argValidation_t ]------------------
+  // Per-argument checks compiled once from the kernel metadata
+  class argValidation_t {
+  public:
+    bool isConst;
+    bool isPtr;
+    dtype_t dtype;
+    // Last memory dtype that passed the canBeCastedTo check
+    const dtype_t *castableDtype;
+
+    argValidation_t(const lang::argMetadata_t &argInfo);
+  };
+  //====================================
+
   //---[ modeKernel_t ]---------------------
   class modeKernel_t : public gc::ringEntry_t {
   public:
@@ -46,6 +72,12 @@ namespace occa {
     std::vector<kernelArgData> arguments;
     lang::kernelMetadata_t metadata;
 
+    // Argument validation plan
+    bool argValidationIsSetup;
+    bool argTypesValidated;
+    int typeValidation;
+    std::vector<argValidation_t> argValidations;
+
     // References
     gc::ring_t<kernel> kernelRing;
 
@@ -59,15 +91,20 @@ namespace occa {
     void removeKernelRef(kernel *ker);
     bool needsFree() const;
 
+    virtual bool hasArgumentLimit() const;
     void assertArgumentLimit() const;
     void assertArgInDevice(const kernelArgData &arg) const;
 
-    void setArguments(kernelArg *args,
+    void setArguments(const kernelArg **args,
                       const int count);
     void pushArgument(const kernelArg &arg);
 
     void setSourceMetadata(lang::parser_t &parser);
 
+    void setupArgValidation();
+    bool argTypesChanged() const;
+    void validateArguments();
+
     void setupRun();
 
     //---[ Virtual Methods ]------------
@@ -143,6 +180,48 @@ namespace occa {
   };
   //====================================
 
+  //---[ boundKernel ]------------------
+  // Launch handle with its arguments resolved and validated once.
+  // Managed memory arguments still go through setupForKernelCall on each
+  //   launch since their sync state can change between launches
+  // Memory arguments are kept alive by the handle, launching after one
+  //   was explicitly freed throws
+  class boundKernel {
+    friend class occa::kernel;
+
+  private:
+    occa::kernel kernel_;
+    std::vector<kernelArgData> arguments;
+    std::vector<int> memoryArgs;
+    std::vector<occa::memory> memoryRefs;
+    std::vector<int> managedArgs;
+    std::vector<bool> managedArgIsConst;
+
+    // Binds the arguments currently set in the kernel
+    boundKernel(const occa::kernel &kernel__);
+
+    void bindArguments();
+
+  public:
+    boundKernel();
+    boundKernel(const occa::kernel &kernel__,
+                const kernelArg **args,
+                const int count);
+
+    bool isInitialized() const;
+
+    occa::kernel getKernel() const;
+
+    int argumentCount() const;
+
+    void setArg(const int index,
+                const kernelArg &arg);
+
+    void run() const;
+    void operator () () const;
+  };
+  //====================================
+
 
   //---[ Kernel Properties ]------------
   // Properties:
@@ -11,8 +11,6 @@ namespace occa {
   class modeDevice_t; class device;
   class kernelArgData;
 
-  typedef std::vector<kernelArgData> kArgVector;
-
   //---[ KernelArg ]--------------------
   namespace kArgInfo {
     static const char none       = 0;
@@ -51,6 +49,9 @@ namespace occa {
     kernelArgData_t data;
     udim_t size;
     char info;
+    // Values passed by pointer which are copied with the argument,
+    //   such as type2 and type4 values
+    std::vector<char> ownedData;
 
     kernelArgData();
     kernelArgData(const kernelArgData &other);
@@ -64,9 +65,36 @@ namespace occa {
 
     bool isNull() const;
 
+    // Copies [bytes] from [src] into [ownedData] and points to it
+    void setOwnedData(const void *src,
+                      const udim_t bytes);
+
     void setupForKernelCall(const bool isConst) const;
   };
 
+  // Stores the first few arguments inline to avoid heap allocations
+  //   when building a kernelArg from a single value or memory object
+  class kArgVector {
+  public:
+    static const int inlineCapacity = 2;
+
+  private:
+    int argCount;
+    kernelArgData inlineArgs[inlineCapacity];
+    std::vector<kernelArgData> heapArgs;
+
+  public:
+    kArgVector();
+
+    int size() const;
+
+    kernelArgData& operator [] (const int index);
+    const kernelArgData& operator [] (const int index) const;
+
+    void push_back(const kernelArgData &arg);
+    void clear();
+  };
+
   class kernelArg {
   public:
     kArgVector args;
@@ -92,14 +120,15 @@ namespace occa {
     kernelArg(const float arg);
     kernelArg(const double arg);
 
+    // Vector values are copied since launches can outlive them
     template <class TM>
     kernelArg(const type2<TM> &arg) {
-      add((void*) const_cast<type2<TM>*>(&arg), sizeof(type2<TM>), false);
+      addValue(&arg, sizeof(type2<TM>));
     }
 
     template <class TM>
     kernelArg(const type4<TM> &arg) {
-      add((void*) const_cast<type4<TM>*>(&arg), sizeof(type4<TM>), false);
+      addValue(&arg, sizeof(type4<TM>));
     }
 
     template <class TM>
@@ -126,6 +155,9 @@ namespace occa {
     void add(void *arg, size_t bytes,
              bool lookAtUva = true, bool argIsUva = false);
 
+    // Adds a copy of the [bytes] value at [arg], passed by pointer
+    void addValue(const void *arg, size_t bytes);
+
     static int argumentCount(const std::vector<kernelArg> &arguments);
   };
 
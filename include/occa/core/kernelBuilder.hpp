@@ -47,6 +47,10 @@ namespace occa {
 
     occa::kernel operator [] (occa::device device);
 
+    // Builds the builders' kernels concurrently through the build thread pool
+    static void buildAll(occa::device device,
+                         const std::vector<kernelBuilder*> &builders);
+
     void run(occa::scope &scope);
 
     void free();
@@ -329,3 +329,330 @@ void operator () (const kernelArg &arg1, const kernelArg &arg2, const kernelArg
                   const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
                   const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
                   const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49, const kernelArg &arg50) const;
+
+boundKernel bind() const;
+
+boundKernel bind(const kernelArg &arg1) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                 const kernelArg &arg46) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                 const kernelArg &arg46, const kernelArg &arg47) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                 const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                 const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49) const;
+
+boundKernel bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                 const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                 const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                 const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                 const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                 const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                 const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                 const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                 const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                 const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49, const kernelArg &arg50) const;
@@ -33,6 +33,12 @@ namespace occa {
                               const bool usingOkl,
                               const occa::properties &kernelProps);
 
+    // Launched kernels still load the device binary for each kernel
+    virtual bool buildKernels(const std::string &filename,
+                              const hash_t kernelHash,
+                              const occa::properties &kernelProps,
+                              std::vector<modeKernel_t*> &kernels);
+
     modeKernel_t* buildLauncherKernel(const hash_t kernelHash,
                                       const std::string &hashDir,
                                       const std::string &kernelName,
@@ -8,6 +8,7 @@
 #include <occa/io/output.hpp>
 #include <occa/tools/gc.hpp>
 #include <occa/tools/properties.hpp>
+#include <occa/tools/uva.hpp>
 
 namespace occa {
   class modeMemory_t; class memory;
@@ -23,6 +24,9 @@ namespace occa {
     static const int isManaged = (1 << 0);
     static const int inDevice  = (1 << 1);
     static const int isStale   = (1 << 2);
+    // Syncs only copy the dirty ranges after the first full copy
+    static const int tracksDirty = (1 << 3);
+    static const int wasSynced   = (1 << 4);
   }
 
   //---[ modeMemory_t ]---------------------
@@ -41,6 +45,10 @@ namespace occa {
     const dtype_t *dtype_;
     udim_t size;
     bool isOrigin;
+    // Allocated by the device memoryPool_t
+    bool isPooled;
+
+    dirtyRanges_t dirtyRanges;
 
     modeMemory_t(modeDevice_t *modeDevice_,
                  udim_t size_,
@@ -51,6 +59,9 @@ namespace occa {
     void removeMemoryRef(memory *mem);
     bool needsFree() const;
 
+    // NULLs all memory wrappers
+    void removeMemoryRefs();
+
     bool isManaged() const;
     bool inDevice() const;
     bool isStale() const;
@@ -183,6 +194,11 @@ namespace occa {
     void syncToDevice(const dim_t bytes, const dim_t offset);
     void syncToHost(const dim_t bytes, const dim_t offset);
 
+    // Declares bytes modified where the memory currently lives,
+    //   only used by memory allocated with [dirty_tracking: true]
+    void markDirty(const dim_t bytes = -1, const dim_t offset = 0);
+    const dirtyRanges_t& dirtyRanges() const;
+
     bool uvaIsStale() const;
     void uvaMarkStale();
     void uvaMarkFresh();
@@ -0,0 +1,94 @@
+#ifndef OCCA_CORE_MEMORYPOOL_HEADER
+#define OCCA_CORE_MEMORYPOOL_HEADER
+
+#include <map>
+#include <vector>
+
+#include <occa/defines.hpp>
+#include <occa/types.hpp>
+#include <occa/tools/hash.hpp>
+#include <occa/tools/json.hpp>
+
+namespace occa {
+  class modeDevice_t;
+  class modeMemory_t;
+  class modeStream_t;
+  class properties;
+
+  class memoryPoolStats_t {
+  public:
+    // Freed blocks kept for reuse
+    udim_t cachedBytes;
+    udim_t cachedBlocks;
+    // Allocations served from cached blocks
+    udim_t reusedBlocks;
+    // Allocations which needed a new block
+    udim_t allocatedBlocks;
+    // Cached blocks given back to the device
+    udim_t releasedBlocks;
+
+    memoryPoolStats_t();
+
+    json toJson() const;
+  };
+
+  //---[ memoryPool_t ]-----------------
+  // Caching allocator for device::malloc, enabled with the memory property
+  //   pool: true
+  // Freed blocks are kept per device and reused by allocations with the same
+  //   size class and memory properties
+  //   - Size classes are at most 25% larger than the requested bytes
+  //   - Blocks freed on another stream wait for that stream before reuse
+  //   - pool_max_bytes caps the cached bytes, the largest blocks go first
+  // Cached bytes aren't counted in device::memoryAllocated()
+  class memoryPool_t {
+  private:
+    class block_t {
+    public:
+      modeMemory_t *modeMemory;
+      modeStream_t *modeStream;
+
+      block_t(modeMemory_t *modeMemory_,
+              modeStream_t *modeStream_);
+    };
+
+    typedef std::pair<udim_t, hash_t> blockKey_t;
+    typedef std::map<blockKey_t, std::vector<block_t> > blockMap;
+
+    modeDevice_t *modeDevice;
+    blockMap freeBlocks;
+    // Block sizes by modeMemory_t, including blocks in use
+    std::map<modeMemory_t*, blockKey_t> blockKeys;
+    memoryPoolStats_t stats;
+
+  public:
+    static const udim_t minBlockBytes = 256;
+
+    memoryPool_t(modeDevice_t *modeDevice_);
+
+    static udim_t sizeClass(const udim_t bytes);
+
+    static bool isEnabled(const occa::properties &props);
+
+    modeMemory_t* malloc(const udim_t bytes,
+                         const void *src,
+                         const occa::properties &props);
+
+    // Returns false if [modeMemory] isn't from the pool
+    bool free(modeMemory_t *modeMemory);
+
+    // Forgets an in-use [modeMemory] which is about to be deleted
+    void remove(modeMemory_t *modeMemory);
+
+    // Frees cached blocks until at most [bytes] are cached
+    void trim(const udim_t bytes = 0);
+
+    // Blocks freed on a destroyed stream no longer wait on it
+    void removeStream(modeStream_t *modeStream);
+
+    const memoryPoolStats_t& getStats() const;
+  };
+  //====================================
+}
+
+#endif
@@ -11,6 +11,7 @@
 namespace occa {
   class modeStream_t; class stream;
   class modeDevice_t; class device;
+  class graph_t;
 
   //---[ modeStream_t ]---------------------
   class modeStream_t : public gc::ringEntry_t {
@@ -21,6 +22,10 @@ namespace occa {
 
     modeDevice_t *modeDevice;
 
+    // Set between device::beginCapture() and device::endCapture()
+    //   while this is the device's current stream
+    graph_t *captureGraph;
+
     modeStream_t(modeDevice_t *modeDevice_,
                  const occa::properties &properties_);
 
@@ -2,7 +2,9 @@
 #define OCCA_IO_CACHE_HEADER
 
 #include <iostream>
+#include <vector>
 
+#include <occa/types.hpp>
 #include <occa/tools/hash.hpp>
 
 namespace occa {
@@ -29,6 +31,8 @@ namespace occa {
     void markCachedFileComplete(const std::string &hashDir,
                                 const std::string &filename);
 
+    // Completed files are found in the cache index or with
+    //   the .success/ marker next to the file
     bool cachedFileIsComplete(const std::string &hashDir,
                               const std::string &filename);
 
@@ -37,6 +41,91 @@ namespace occa {
     void writeBuildFile(const std::string &filename,
                         const hash_t &hash,
                         const occa::properties &props);
+
+    // Adds the kernel build stats to build["stats"] in an existing build file
+    void writeBuildStats(const std::string &filename,
+                         const hash_t &hash,
+                         const occa::json &stats);
+
+    //---[ Cache Eviction ]-------------
+    // Cache entries are the [cachePath()]/<hash>/ directories
+    //   - The directory mtime is the last access time
+    //   - Entries with held locks (being built) are never evicted
+    //   - Entries younger than [minAge] seconds are kept since
+    //     other processes might be about to load them
+    //
+    // Settings:
+    //   cache/max_size:    Size cap, such as 1024 or "10 GB" (OCCA_CACHE_MAX_SIZE)
+    //   cache/max_entries: Entry cap (OCCA_CACHE_MAX_ENTRIES)
+    //   cache/min_age:     Seconds before an entry can be evicted, defaults to 60
+    // Processes which add cache entries run the eviction on exit if a cap is set
+    class cacheEntry_t {
+    public:
+      std::string hashDir;
+      udim_t bytes;
+      double lastAccess;
+      bool isComplete;
+      bool isLocked;
+
+      cacheEntry_t();
+    };
+
+    typedef std::vector<cacheEntry_t> cacheEntryVector;
+
+    // Updates the entry's access time, once per process
+    void markCacheAccess(const std::string &hashDir);
+
+    cacheEntryVector getCacheEntries();
+
+    udim_t getCacheMaxBytes();
+    int getCacheMaxEntries();
+    double getCacheMinAge();
+
+    // Removes least recently used entries until both caps are met
+    //   - A cap of 0 means unlimited
+    //   - Returns the number of evicted entries
+    int evictCacheEntries(const udim_t maxBytes,
+                          const int maxEntries,
+                          const double minAge);
+
+    int evictCacheEntries();
+
+    // Removes incomplete entries, stale locks and compacts the cache index
+    //   - Returns the number of removed entries and locks
+    int pruneCache(const double minAge);
+    //==================================
+
+    //---[ Binary Sharing ]-------------
+    // Builds with the same emitted source and compiler command produce the same
+    //   binary, which is shared between cache entries through the cache index
+    //   - Shared binaries are hard-linked into the new entry, or copied if the
+    //     filesystem doesn't support links
+    //
+    // Settings:
+    //   cache/share_binaries: Defaults to true
+    bool sharesBinaries();
+
+    // Links a finished binary with the same [contentHash] to [binaryFilename]
+    //   - Returns the shared binary or "" if there wasn't one
+    std::string linkCachedBinary(const hash_t &contentHash,
+                                 const std::string &binaryFilename);
+
+    void addCachedBinary(const hash_t &contentHash,
+                         const std::string &binaryFilename);
+    //==================================
+
+    //---[ Kernel Libraries ]-----------
+    // Packaged cache entries are copied into [libraryPath()]/<library>/<hash>/
+    //   to deploy them with device::loadKernels(library)
+    std::string libraryCachePath(const std::string &library);
+
+    bool addCacheEntryToLibrary(const std::string &hashDir,
+                                const std::string &library);
+
+    // Copies the library entry into the cache if it's missing
+    //   - Returns the entry's cache directory or "" if it couldn't be installed
+    std::string installLibraryCacheEntry(const std::string &libraryEntryDir);
+    //==================================
   }
 }
 
@@ -0,0 +1,127 @@
+#ifndef OCCA_IO_CACHEINDEX_HEADER
+#define OCCA_IO_CACHEINDEX_HEADER
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <occa/defines.hpp>
+#include <occa/types.hpp>
+#include <occa/tools/json.hpp>
+
+namespace occa {
+  class hash_t;
+
+  namespace io {
+    //---[ cacheIndex_t ]---------------
+    // Append-only index of finished cache entries, stored in [cachePath()]/index
+    //   - Writers append each record with one write() while holding a flock()
+    //   - Readers mmap the index and only parse new records after a lookup misses
+    //   - Records which are still being written are skipped until they're complete
+    //   - Completed files are recorded with their stat() stamp, hits are checked
+    //     against the file in case it was removed or rebuilt outside of OCCA
+    //   - Checked hits are trusted until new records are mapped or the header's
+    //     generation changes, which is bumped when entries are evicted
+    // The directory layout (.success/ files and build.json) is still written
+    //   and used as a fallback
+    // File hashes from hashFile() can also be stored to skip rehashing
+    //   unchanged files in new processes
+    // Binaries are also indexed by the hash of their source and compiler command
+    //   to share them between cache entries
+    // Detected compiler capabilities are stored by compiler command
+    class cacheIndex_t {
+    public:
+      static const int completedFileRecord = 1;
+      static const int dependenciesRecord  = 2;
+      static const int fileHashRecord      = 4;
+      static const int binaryRecord        = 5;
+      static const int toolchainRecord     = 6;
+
+    private:
+      std::mutex mutex;
+      std::string filename;
+      bool isDisabled;
+      int fd;
+      char *mappedPtr;
+      udim_t mappedBytes;
+      udim_t parsedBytes;
+
+      std::unordered_set<std::string> verifiedFiles;
+      udim_t verifiedBytes;
+      uint64_t verifiedGeneration;
+
+      std::unordered_map<std::string, std::string> completedFiles;
+      std::unordered_map<std::string, std::string> dependencies;
+      std::unordered_map<std::string, std::string> fileHashes;
+      std::unordered_map<std::string, std::string> binaries;
+      std::unordered_map<std::string, std::string> toolchains;
+
+    public:
+      cacheIndex_t();
+      ~cacheIndex_t();
+
+      bool isComplete(const std::string &hashDir,
+                      const std::string &cachedFile);
+
+      void markComplete(const std::string &hashDir,
+                        const std::string &cachedFile);
+
+      bool getDependencies(const hash_t &kernelHash,
+                           jsonObject &dependencyHashes);
+
+      void setDependencies(const hash_t &kernelHash,
+                           const json &dependencyHashes);
+
+      bool getFileHash(const std::string &path,
+                       std::string &value);
+
+      void setFileHash(const std::string &path,
+                       const std::string &value);
+
+      bool getBinary(const hash_t &contentHash,
+                     std::string &binaryFilename);
+
+      void setBinary(const hash_t &contentHash,
+                     const std::string &binaryFilename);
+
+      bool getToolchain(const std::string &compiler,
+                        std::string &value);
+
+      void setToolchain(const std::string &compiler,
+                        const std::string &value);
+
+      // Forget entries from an evicted cache directory in this process
+      void removeDir(const std::string &hashDir);
+
+      // Rewrite the index without removed or missing entries
+      void compact();
+
+      int completedFileCount();
+
+    private:
+      bool open();
+      void close();
+      void refresh();
+
+      uint64_t mappedGeneration() const;
+      void bumpGeneration();
+
+      void parseRecords();
+      void applyRecord(const int type,
+                       const std::string &key,
+                       const std::string &value);
+
+      void forgetDir(const std::string &hashDir);
+
+      void append(const int type,
+                  const std::string &key,
+                  const std::string &value);
+    };
+    //==================================
+
+    cacheIndex_t& cacheIndex();
+  }
+}
+
+#endif
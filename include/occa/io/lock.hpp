@@ -7,6 +7,13 @@ namespace occa {
   class hash_t;
 
   namespace io {
+    // Inter-process lock on [OCCA_CACHE_DIR]/locks/<hash>_<tag>
+    //   - The lock is an advisory flock() on the lock directory, released
+    //     by the kernel if the holder dies
+    //   - If flock() is not supported, the directory itself is the lock and
+    //     holders are considered stale once their PID is gone, or once the
+    //     lock is too old if the holder runs on another host
+    // Copies don't own the lock
     class lock_t {
     private:
       mutable std::string lockDir;
@@ -14,6 +21,7 @@ namespace occa {
       float staleWarning;
       float staleAge;
       mutable bool released;
+      mutable int lockFd;
 
     public:
       lock_t();
@@ -22,6 +30,9 @@ namespace occa {
              const std::string &tag,
              const float staleAge_ = -1);
 
+      lock_t(const lock_t &other);
+      lock_t& operator = (const lock_t &other);
+
       ~lock_t();
 
       bool isInitialized() const;
@@ -33,6 +44,17 @@ namespace occa {
       bool isMine();
 
       bool isReleased();
+
+      // Checks if a process currently holds the lock in [lockDir]
+      static bool isHeld(const std::string &lockDir);
+
+    private:
+      std::string pidFile() const;
+
+      bool tryLock();
+      bool holderIsStale() const;
+      void removeLockDir() const;
+      void closeLockFd() const;
     };
   }
 }
@@ -16,6 +16,9 @@ namespace occa {
     extern const std::string launcherSourceFile;
     extern const std::string launcherBinaryFile;
     extern const std::string launcherBuildFile;
+    extern const std::string buildLogFile;
+    extern const std::string pchHeaderFile;
+    extern const std::string pchDependenciesFile;
   }
 
   namespace io {
@@ -14,6 +14,7 @@ namespace occa {
       class serialParser : public parser_t {
       public:
         static const std::string exclusiveIndexName;
+        static const std::string kernelEntryPrefix;
 
         serialParser(const occa::properties &settings_ = occa::properties());
 
@@ -27,6 +28,12 @@ namespace occa {
 
         static void setupKernel(functionDeclStatement &kernelSmnt);
 
+        void setupKernelEntries();
+
+        void setupKernelEntry(functionDeclStatement &kernelSmnt);
+
+        static std::string kernelEntryName(const std::string &kernelName);
+
         void setupExclusives();
 
         void setupExclusiveDeclarations(statementExprMap &exprMap);
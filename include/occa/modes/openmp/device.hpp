@@ -26,6 +26,16 @@ namespace occa {
                                         const std::string &kernelName,
                                         const hash_t kernelHash,
                                         const occa::properties &kernelProps);
+
+      virtual bool buildKernels(const std::string &filename,
+                                const hash_t kernelHash,
+                                const occa::properties &kernelProps,
+                                std::vector<modeKernel_t*> &kernels);
+
+    private:
+      // Adds the compiler's OpenMP flag when it's supported
+      occa::properties openmpKernelProps(const occa::properties &kernelProps,
+                                         bool &usingOpenMP);
     };
   }
 }
@@ -1,14 +1,27 @@
 #ifndef OCCA_MODES_SERIAL_DEVICE_HEADER
 #define OCCA_MODES_SERIAL_DEVICE_HEADER
 
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include <occa/defines.hpp>
 #include <occa/core/device.hpp>
 
 namespace occa {
   namespace serial {
+    class stream;
+
+    // dlclose() is called once the last kernel using the binary is freed
+    typedef std::shared_ptr<void> sharedDlHandle_t;
+
     class device : public occa::modeDevice_t {
       mutable hash_t hash_;
 
+      // Precompiled header flags for each PCH hash, set once it was checked
+      std::mutex pchMutex;
+      std::map<std::string, std::string> pchFlags;
+
     public:
       device(const occa::properties &properties_);
       virtual ~device();
@@ -28,6 +41,12 @@ namespace occa {
       virtual void waitFor(streamTag tag);
       virtual double timeBetween(const streamTag &startTag,
                                  const streamTag &endTag);
+
+      stream& getSerialStream() const;
+
+      // Kernels and memory can still be used by enqueued jobs
+      //   so we wait on all streams before freeing them
+      void finishAllStreams() const;
       //================================
 
       //---[ Kernel ]-------------------
@@ -51,6 +70,38 @@ namespace occa {
                                 const occa::properties &kernelProps,
                                 const bool isLauncerKernel);
 
+      virtual bool buildKernels(const std::string &filename,
+                                const hash_t kernelHash,
+                                const occa::properties &kernelProps,
+                                std::vector<modeKernel_t*> &kernels);
+
+      // Returns the cached binary for [filename], compiling it if needed
+      //   - [compiled] is set if it was compiled, which also sets [metadata]
+      //   - Returns an empty string if the OKL source couldn't be parsed
+      std::string buildBinary(const std::string &filename,
+                              const std::string &label,
+                              const hash_t kernelHash,
+                              const occa::properties &kernelProps,
+                              const bool isLauncherKernel,
+                              lang::sourceMetadata_t &metadata,
+                              bool &compiled);
+
+      static sharedDlHandle_t openBinary(const std::string &filename);
+
+      // Returns the flags to use a precompiled header with the standard and
+      //   OCCA headers emitted by the serial parser, or "" if it isn't supported
+      //   - It's built once in the cache for each compiler and flags
+      //   - Rebuilt if any header it was compiled from changed, including
+      //     system headers
+      // Setting: serial/pch, defaults to true
+      std::string precompiledHeaderFlags(const occa::properties &kernelProps,
+                                         const std::string &compilerFlags);
+
+      static bool precompiledHeaderIsStale(const std::string &hashDir);
+
+      static void writePrecompiledHeaderDependencies(const std::string &hashDir,
+                                                     const std::string &depFilename);
+
       virtual modeKernel_t* buildKernelFromBinary(const std::string &filename,
                                                   const std::string &kernelName,
                                                   const occa::properties &kernelProps);
@@ -59,6 +110,12 @@ namespace occa {
                                                   const std::string &kernelName,
                                                   const occa::properties &kernelProps,
                                                   lang::kernelMetadata_t &metadata);
+
+      modeKernel_t* buildKernelFromBinary(sharedDlHandle_t dlHandle,
+                                          const std::string &filename,
+                                          const std::string &kernelName,
+                                          const occa::properties &kernelProps,
+                                          lang::kernelMetadata_t &metadata);
       //================================
 
       //---[ Memory ]-------------------
@@ -66,6 +123,11 @@ namespace occa {
                                    const void *src,
                                    const occa::properties &props);
 
+      virtual modeMemory_t* mmap(const std::string &filename,
+                                 const udim_t offset,
+                                 const udim_t bytes,
+                                 const occa::properties &props);
+
       virtual udim_t memorySize() const;
       //================================
     };
@@ -1,6 +1,7 @@
 #ifndef OCCA_MODES_SERIAL_KERNEL_HEADER
 #define OCCA_MODES_SERIAL_KERNEL_HEADER
 
+#include <memory>
 #include <vector>
 
 #include <occa/defines.hpp>
@@ -11,10 +12,15 @@ namespace occa {
   namespace serial {
     class device;
 
+    typedef void (*kernelEntry_t)(void **args);
+
     class kernel : public occa::modeKernel_t {
     protected:
-      void *dlHandle;
+      // Shared by kernels loaded from the same binary
+      std::shared_ptr<void> dlHandle;
       functionPtr_t function;
+      // Generated by the serial parser, unpacks the arguments with their types
+      kernelEntry_t entry;
       mutable std::vector<void*> vArgs;
 
     public:
@@ -32,8 +38,14 @@ namespace occa {
 
       const lang::kernelMetadata_t& getMetadata() const;
 
+      bool hasArgumentLimit() const;
+
       void run() const;
 
+      // Calls the kernel function with the unpacked argument pointers
+      void launch(void **args,
+                  const int argCount) const;
+
       friend class device;
     };
   }
@@ -8,6 +8,11 @@ namespace occa {
   namespace serial {
     class memory : public occa::modeMemory_t {
     public:
+      // Pages mapped by device::mmap or for placed allocations,
+      //   unmapped instead of freed
+      void *mappedPtr;
+      udim_t mappedBytes;
+
       memory(modeDevice_t *modeDevice_,
              udim_t size_,
              const occa::properties &properties_ = occa::properties());
@@ -33,6 +38,12 @@ namespace occa {
                     const udim_t srcOffset,
                     const occa::properties &props);
       void detach();
+
+    private:
+      void copy(void *dest,
+                const void *src,
+                const udim_t bytes,
+                const occa::properties &props) const;
     };
   }
 }
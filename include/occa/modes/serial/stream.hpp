@@ -1,18 +1,101 @@
 #ifndef OCCA_MODES_SERIAL_STREAM_HEADER
 #define OCCA_MODES_SERIAL_STREAM_HEADER
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include <occa/defines.hpp>
 #include <occa/core/stream.hpp>
 
 namespace occa {
   namespace serial {
+    class streamTag;
+
+    //---[ streamJob ]------------------
+    // Work enqueued in an asynchronous stream, ran by the stream worker thread
+    class streamJob {
+    public:
+      std::atomic<streamJob*> next;
+
+      streamJob();
+      virtual ~streamJob();
+
+      virtual void run() = 0;
+    };
+
+    class memcpyJob : public streamJob {
+    public:
+      void *dest;
+      const void *src;
+      udim_t bytes;
+
+      memcpyJob(void *dest_,
+                const void *src_,
+                const udim_t bytes_);
+
+      void run();
+    };
+
+    class tagJob : public streamJob {
+    public:
+      streamTag *tag;
+
+      tagJob(streamTag *tag_);
+
+      void run();
+    };
+    //==================================
+
+    //---[ stream ]---------------------
+    // Streams created with { async: true } own a worker thread which runs
+    //   enqueued kernel launches and async copies in order.
+    // Otherwise, work is ran synchronously by the calling thread
     class stream : public occa::modeStream_t {
+    private:
+      bool isAsync;
+
+      // Multi-producer, single-consumer intrusive queue
+      //   - Producers only swap the tail
+      //   - The worker is the only one popping from the head
+      std::atomic<streamJob*> queueTail;
+      streamJob *queueHead;
+      streamJob *stubJob;
+
+      std::atomic<udim_t> submittedJobs;
+      std::atomic<udim_t> completedJobs;
+
+      std::thread worker;
+      std::atomic<bool> workerIsSleeping;
+      std::atomic<int> waitingThreads;
+      bool workerIsDone;
+      std::mutex workerMutex;
+      std::condition_variable workerCondition;
+      std::condition_variable completionCondition;
+
     public:
       stream(modeDevice_t *modeDevice_,
              const occa::properties &properties_);
 
       virtual ~stream();
+
+      bool isAsynchronous() const;
+
+      // Takes ownership of the job
+      void enqueue(streamJob *job);
+
+      void finish();
+      void waitFor(const streamTag &tag);
+
+    private:
+      void pushJob(streamJob *job);
+      streamJob* popJob();
+
+      void runWorker();
+      void notifyWaitingThreads();
     };
+    //==================================
   }
 }
 
@@ -3,18 +3,33 @@
 #ifndef OCCA_MODES_SERIAL_STREAMTAG_HEADER
 #define OCCA_MODES_SERIAL_STREAMTAG_HEADER
 
+#include <atomic>
+
 #include <occa/core/streamTag.hpp>
 
 namespace occa {
   namespace serial {
+    class stream;
+
     class streamTag : public occa::modeStreamTag_t {
     public:
       double time;
 
+      // Set for tags recorded in asynchronous streams,
+      //   the time is filled once the stream worker reaches the tag
+      stream *stream_;
+      std::atomic<bool> completed;
+
       streamTag(modeDevice_t *modeDevice_,
                 double time_);
 
+      streamTag(modeDevice_t *modeDevice_,
+                stream *stream__);
+
       virtual ~streamTag();
+
+      bool isCompleted() const;
+      void wait() const;
     };
   }
 }
@@ -10,9 +10,11 @@
 #include <occa/tools/lex.hpp>
 #include <occa/tools/misc.hpp>
 #include <occa/tools/properties.hpp>
+#include <occa/tools/rwLock.hpp>
 #include <occa/tools/string.hpp>
 #include <occa/tools/styling.hpp>
 #include <occa/tools/sys.hpp>
+#include <occa/tools/threadPool.hpp>
 #include <occa/tools/tls.hpp>
 #include <occa/tools/uva.hpp>
 #include <occa/tools/vector.hpp>
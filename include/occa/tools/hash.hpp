@@ -8,7 +8,15 @@
 #include <occa/types.hpp>
 
 namespace occa {
-  // Uses FNV hashing
+  // Hash versions, OCCA_HASH_VERSION picks the one used by hash()
+  //   1: Byte-wise FNV-style hash, used by older cache directories
+  //   2: 256-bit hash over 64-byte blocks with 8 cross-mixed 64-bit lanes,
+  //      vectorized with AVX2 when available
+  namespace hashVersion {
+    static const int fnv   = 1;
+    static const int lanes = 2;
+  }
+
   class hash_t {
   public:
     bool initialized;
@@ -47,8 +55,12 @@ namespace occa {
   std::ostream& operator << (std::ostream &out,
                            const hash_t &hash);
 
+  int getHashVersion();
+
   hash_t hash(const void *ptr, udim_t bytes);
 
+  hash_t hash(const void *ptr, udim_t bytes, const int version);
+
   template <class TM>
   inline hash_t hash(const TM &t) {
     return hash(&t, sizeof(TM));
@@ -64,7 +76,20 @@ namespace occa {
 
   hash_t hash(const char *c);
   hash_t hash(const std::string &str);
+
+  // hashFile() results are memoized by the file's stat() metadata
+  //   (device, inode, size, mtime and ctime) until the file changes
+  //   - Set cache/persist_file_hashes (OCCA_CACHE_FILE_HASHES) to
+  //     share them between processes through the cache index
   hash_t hashFile(const std::string &filename);
+
+  // Sets [stamp] from the file's stat() metadata used by hashFile()
+  //   Returns false for files modified too recently to trust their mtime,
+  //   since a write in the same timestamp tick wouldn't change it
+  bool getFileStamp(const std::string &filename,
+                    std::string &stamp);
+
+  void clearFileHashCache();
 }
 
 #endif
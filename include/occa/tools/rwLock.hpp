@@ -0,0 +1,55 @@
+#ifndef OCCA_TOOLS_RWLOCK_HEADER
+#define OCCA_TOOLS_RWLOCK_HEADER
+
+#include <occa/defines.hpp>
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+#  include <pthread.h>
+#else
+#  include <windows.h>
+#endif
+
+namespace occa {
+  // Lock shared by readers, writers have exclusive access
+  class rwLock_t {
+  private:
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_t lock;
+#else
+    SRWLOCK lock;
+#endif
+
+    rwLock_t(const rwLock_t &other);
+    rwLock_t& operator = (const rwLock_t &other);
+
+  public:
+    rwLock_t();
+    ~rwLock_t();
+
+    void lockRead();
+    void unlockRead();
+
+    void lockWrite();
+    void unlockWrite();
+  };
+
+  class readLock {
+  private:
+    rwLock_t &lock;
+
+  public:
+    readLock(rwLock_t &lock_);
+    ~readLock();
+  };
+
+  class writeLock {
+  private:
+    rwLock_t &lock;
+
+  public:
+    writeLock(rwLock_t &lock_);
+    ~writeLock();
+  };
+}
+
+#endif
@@ -251,6 +251,10 @@ namespace occa {
   void stringifyBytesFraction(std::stringstream &ss,
                               uint64_t fraction);
 
+  // Parses sizes such as "512", "64 KB", "1.5GB" or "2g"
+  // Returns 0 for invalid sizes
+  udim_t parseBytes(const std::string &str);
+
   //---[ Color Strings ]----------------
   namespace color {
     enum color_t {
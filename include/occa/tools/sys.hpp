@@ -69,9 +69,38 @@ namespace occa {
 
     int getPID();
     int getTID();
+    std::string getHostname();
     void pinToCore(const int core);
     //==================================
 
+    //---[ Process Spawning ]-----------
+    class spawnResult {
+    public:
+      int exitCode;
+      bool timedOut;
+      // Interleaved stdout and stderr
+      std::string output;
+
+      spawnResult();
+
+      bool succeeded() const;
+    };
+
+    strVector splitCommand(const std::string &cmdline);
+    bool commandNeedsShell(const std::string &cmdline);
+
+    // Runs args[0] (searched in PATH) without going through a shell
+    //   - At most [build/jobs] processes are spawned at the same time
+    //   - Processes still running after [timeout] seconds are killed
+    //   - Negative timeouts use the [build/timeout] setting, 0 disables it
+    spawnResult spawn(const strVector &args,
+                      const double timeout = -1);
+
+    // Only commands using shell features are ran through /bin/sh
+    spawnResult spawn(const std::string &cmdline,
+                      const double timeout = -1);
+    //==================================
+
     //---[ Processor Info ]-------------
     std::string getFieldFrom(const std::string &command,
                              const std::string &field);
@@ -83,6 +112,20 @@ namespace occa {
     udim_t installedRAM();
     udim_t availableRAM();
 
+    // The resolved compiler binary and its stat metadata, empty if it wasn't found
+    std::string compilerStamp(const std::string &compiler);
+
+    // Detected compiler capabilities, such as the vendor and OpenMP flag
+    //   - Stored in the cache index by compiler command
+    //   - Outdated once the compiler binary is replaced
+    bool getCompilerCapability(const std::string &compiler,
+                               const std::string &capability,
+                               std::string &value);
+
+    void setCompilerCapability(const std::string &compiler,
+                               const std::string &capability,
+                               const std::string &value);
+
     int compilerVendor(const std::string &compiler);
 
     std::string compilerCpp11Flags(const std::string &compiler);
@@ -103,6 +146,7 @@ namespace occa {
 
     //---[ Dynamic Methods ]------------
     void* malloc(udim_t bytes);
+    void* malloc(udim_t bytes, udim_t alignment);
     void free(void *ptr);
 
     void* dlopen(const std::string &filename,
@@ -112,6 +156,9 @@ namespace occa {
                         const std::string &functionName,
                         const io::lock_t &lock = io::lock_t());
 
+    functionPtr_t dlsymIfExists(void *dlHandle,
+                                const std::string &functionName);
+
     void dlclose(void *dlHandle);
 
     void runFunction(functionPtr_t f, const int argc, void **args);
@@ -121,6 +168,55 @@ namespace occa {
 
     std::string prettyStackSymbol(void *frame, const char *symbol);
     //==================================
+
+    //---[ Memory Placement ]-----------
+    udim_t pageBytes();
+    udim_t hugePageBytes();
+
+    // Maps [bytes] of zeroed anonymous pages aligned to [alignment]
+    //   - Released with munmap, which also drops their memory policies
+    //   - Returns NULL if they couldn't be mapped
+    void* mapPages(const udim_t bytes,
+                   const udim_t alignment);
+
+    // Online NUMA nodes, empty if they can't be found
+    intVector numaNodes();
+
+    // Policies apply to the pages in [ptr, ptr + bytes)
+    //   and return false if they couldn't be set
+    bool interleaveMemory(void *ptr,
+                          const udim_t bytes,
+                          const intVector &nodes);
+
+    bool bindMemory(void *ptr,
+                    const udim_t bytes,
+                    const int node);
+
+    bool adviseHugePages(void *ptr,
+                         const udim_t bytes);
+    //==================================
+
+    //---[ Memory Mapping ]-------------
+    udim_t fileBytes(const std::string &filename);
+
+    // Maps [bytes] from [filename] starting at [offset], which should be page-aligned
+    //   - Read-only mappings are shared with the file
+    //   - Writable mappings are private copy-on-write mappings
+    //   - The file is opened read-only in both cases
+    void* mmapFile(const std::string &filename,
+                   const udim_t offset,
+                   const udim_t bytes,
+                   const bool readOnly);
+
+    void munmap(void *ptr,
+                const udim_t bytes);
+
+    // Access pattern hints: 'normal', 'sequential', 'random', 'willneed'
+    //   - Returns false if the hint couldn't be set
+    bool adviseMemory(void *ptr,
+                      const udim_t bytes,
+                      const std::string &advice);
+    //==================================
   }
 
   void _message(const std::string &header,
@@ -0,0 +1,48 @@
+#ifndef OCCA_TOOLS_THREADPOOL_HEADER
+#define OCCA_TOOLS_THREADPOOL_HEADER
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <occa/defines.hpp>
+
+namespace occa {
+  class threadPoolJob {
+  public:
+    virtual ~threadPoolJob();
+
+    virtual void run() = 0;
+  };
+
+  // Fixed-size pool of worker threads running jobs in submission order
+  class threadPool {
+  private:
+    std::vector<std::thread> workers;
+    std::deque<threadPoolJob*> jobs;
+    std::mutex jobsMutex;
+    std::condition_variable jobsCondition;
+    bool isDone;
+
+  public:
+    threadPool(const int threadCount);
+    ~threadPool();
+
+    int size() const;
+
+    // Takes ownership of the job
+    void enqueue(threadPoolJob *job);
+
+  private:
+    void runWorker();
+  };
+
+  // Shared pool used for kernel builds
+  // Properties:
+  //   build/threads : Number of threads, defaults to the core count
+  threadPool& buildThreadPool();
+}
+
+#endif
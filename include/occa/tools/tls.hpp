@@ -18,6 +18,10 @@ namespace occa {
   private:
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
     pthread_key_t pkey;
+    // Used to initialize the value in other threads
+    TM initialValue;
+
+    static void deleteValue(void *ptr);
 #else
     thread_local TM value_;
 #endif
@@ -1,8 +1,12 @@
 namespace occa {
   template <class TM>
-  tls<TM>::tls(const TM &val) {
+  tls<TM>::tls(const TM &val)
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-    pthread_key_create(&pkey, NULL);
+    : initialValue(val)
+#endif
+  {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_key_create(&pkey, deleteValue);
     pthread_setspecific(pkey, new TM(val));
 #else
     value_ = val;
@@ -11,9 +15,13 @@ namespace occa {
 
   template <class TM>
   template <class TM2>
-  tls<TM>::tls(const tls<TM2> &t) {
+  tls<TM>::tls(const tls<TM2> &t)
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-    pthread_key_create(&pkey, NULL);
+    : initialValue(t.value())
+#endif
+  {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_key_create(&pkey, deleteValue);
     pthread_setspecific(pkey, new TM(t.value()));
 #else
     value_ = t.value_;
@@ -53,10 +61,23 @@ namespace occa {
     return val;
   }
 
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+  template <class TM>
+  void tls<TM>::deleteValue(void *ptr) {
+    delete (TM*) ptr;
+  }
+#endif
+
   template <class TM>
   TM& tls<TM>::value() {
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-    return *((TM*) pthread_getspecific(pkey));
+    TM *ptr = (TM*) pthread_getspecific(pkey);
+    if (!ptr) {
+      // First access from this thread
+      ptr = new TM(initialValue);
+      pthread_setspecific(pkey, ptr);
+    }
+    return *ptr;
 #else
     return value_;
 #endif
@@ -65,7 +86,13 @@ namespace occa {
   template <class TM>
   const TM& tls<TM>::value() const {
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-    return *((TM*) pthread_getspecific(pkey));
+    TM *ptr = (TM*) pthread_getspecific(pkey);
+    if (!ptr) {
+      // First access from this thread
+      ptr = new TM(initialValue);
+      pthread_setspecific(pkey, ptr);
+    }
+    return *ptr;
 #else
     return value_;
 #endif
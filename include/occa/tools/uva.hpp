@@ -2,10 +2,13 @@
 #define OCCA_UVA_HEADER
 
 #include <iostream>
+#include <map>
 #include <vector>
 
 #include <occa/defines.hpp>
 #include <occa/io/output.hpp>
+#include <occa/tools/properties.hpp>
+#include <occa/tools/rwLock.hpp>
 #include <occa/types.hpp>
 
 namespace occa {
@@ -13,9 +16,9 @@ namespace occa {
   class memory;
   class modeMemory_t;
   class ptrRange;
+  class ptrRangeMap;
 
-  typedef std::map<ptrRange, occa::modeMemory_t*> ptrRangeMap;
-  typedef std::vector<occa::modeMemory_t*>        memoryVector;
+  typedef std::vector<occa::modeMemory_t*> memoryVector;
 
   extern ptrRangeMap uvaMap;
   extern memoryVector uvaStaleMemory;
@@ -42,6 +45,115 @@ namespace occa {
   //====================================
 
 
+  //---[ ptrRangeMap ]------------------
+  // Maps pointers to the memory whose range contains them
+  //   - Ranges are kept sorted in blocks of at most [maxBlockEntries]
+  //   - Lookups are binary searches over the block starts and one block, O(log n)
+  //   - Inserts and erases only shift entries inside one block
+  // Lookups can run concurrently, inserts and erases are exclusive
+  class ptrRangeMap {
+  private:
+    class entry_t {
+    public:
+      char *start, *end;
+      occa::modeMemory_t *modeMemory;
+    };
+    typedef std::vector<entry_t> entryVector;
+
+    std::vector<entryVector> blocks;
+    // First start in each block, searched before the block
+    std::vector<char*> blockStarts;
+    size_t entries;
+    mutable rwLock_t lock;
+
+    ptrRangeMap(const ptrRangeMap &other);
+    ptrRangeMap& operator = (const ptrRangeMap &other);
+
+  public:
+    static const int maxBlockEntries = 512;
+
+    ptrRangeMap();
+
+    // Replaces the range overlapping [range] if one exists
+    // Empty ranges only match their start pointer
+    void insert(const ptrRange &range,
+                occa::modeMemory_t *modeMemory);
+
+    // Removes the range containing [ptr]
+    void erase(void *ptr);
+
+    // Returns NULL if no range contains [ptr]
+    occa::modeMemory_t* find(void *ptr) const;
+
+    size_t size() const;
+
+    void clear();
+
+  private:
+    // Index of the last block starting at or before [ptr], or -1
+    int findBlock(const char *ptr) const;
+
+    // Index of the last entry starting at or before [ptr], or -1
+    static int findEntry(const entryVector &block,
+                         const char *ptr);
+
+    static bool contains(const entry_t &entry,
+                         const char *ptr);
+
+    static bool overlaps(const entry_t &entry,
+                         const ptrRange &range);
+  };
+  //====================================
+
+
+  //---[ dirtyRanges_t ]----------------
+  // Byte ranges of managed memory which changed since the last sync
+  //   - Ranges are rounded out to [granularity] bytes and coalesced
+  class dirtyRanges_t {
+  public:
+    // Range starts mapped to their ends
+    typedef std::map<udim_t, udim_t> rangeMap;
+
+    rangeMap ranges;
+    udim_t granularity;
+
+    dirtyRanges_t();
+
+    // [maxBytes] bounds ranges rounded past the end of the memory
+    void add(const udim_t offset,
+             const udim_t bytes,
+             const udim_t maxBytes);
+
+    // Only removes [offset, offset + bytes), splitting ranges around it
+    void remove(const udim_t offset,
+                const udim_t bytes);
+
+    void clear();
+
+    bool isEmpty() const;
+    udim_t bytes() const;
+
+    // [[start, end], ...]
+    json toJson() const;
+  };
+
+  // Bytes copied by UVA syncs and bytes skipped with dirty ranges
+  class uvaSyncStats_t {
+  public:
+    udim_t copiedBytes;
+    udim_t savedBytes;
+
+    uvaSyncStats_t();
+
+    json toJson() const;
+  };
+
+  uvaSyncStats_t getUvaSyncStats();
+
+  void resetUvaSyncStats();
+  //====================================
+
+
   //---[ UVA ]--------------------------
   occa::modeMemory_t* uvaToMemory(void *ptr);
 
@@ -60,6 +172,16 @@ namespace occa {
                      const udim_t bytes = (udim_t) -1,
                      const udim_t offset = 0);
 
+  // Copies all of [mem] between the host and device
+  //   - Memory tracking dirty ranges only copies its dirty ranges
+  //     after its first full copy
+  void syncDirtyRanges(occa::modeMemory_t *mem,
+                       const bool toDevice,
+                       const occa::properties &props = occa::properties());
+
+  // Declares [ptr, ptr + bytes) as modified where the memory currently lives
+  void markDirty(void *ptr, const udim_t bytes);
+
   bool needsSync(void *ptr);
   void sync(void *ptr);
   void dontSync(void *ptr);
@@ -53,7 +53,7 @@ def operator_args(N, indent, argtype, argname=None):
 def array_args(N, indent):
     content = ''
     for n in range(1, N + 1):
-        content += 'arg{n}'.format(n=n)
+        content += '&arg{n}'.format(n=n)
         if n < N:
             if n % 10:
                 content += ', '
@@ -93,7 +93,8 @@ def run_function_from_argument(N):
 @to_file('include/occa/core/kernelOperators.hpp')
 def operator_declarations(N):
     return '\n\n'.join(
-        operator_declaration(n) for n in range(N + 1)
+        [operator_declaration(n) for n in range(N + 1)]
+        + [bind_declaration(n) for n in range(N + 1)]
     )
 
 
@@ -106,10 +107,20 @@ def operator_declaration(N):
     return content
 
 
+def bind_declaration(N):
+    content = 'boundKernel bind('
+    indent = ' ' * len(content)
+    content += operator_args(N, indent, 'const kernelArg &')
+    content += ') const;'
+
+    return content
+
+
 @to_file('src/core/kernelOperators.cpp')
 def operator_definitions(N):
     return '\n'.join(
-        operator_definition(n) for n in range(N + 1)
+        [operator_definition(n) for n in range(N + 1)]
+        + [bind_definition(n) for n in range(N + 1)]
     )
 
 
@@ -120,7 +131,7 @@ def operator_definition(N):
     if N > 0:
         content += ''') const {{
   assertInitialized();
-  kernelArg args[] = {{
+  const kernelArg *args[] = {{
     {array_args}
   }};
   modeKernel->setArguments(args, {N});
@@ -137,6 +148,29 @@ def operator_definition(N):
     return content
 
 
+def bind_definition(N):
+    content = 'boundKernel kernel::bind('
+    indent = ' ' * len(content)
+    content += operator_args(N, indent, 'const kernelArg &')
+    if N > 0:
+        content += ''') const {{
+  assertInitialized();
+  const kernelArg *args[] = {{
+    {array_args}
+  }};
+  return boundKernel(*this, args, {N});
+}}
+'''.format(N=N,
+           array_args=array_args(N, ' ' * 4))
+    else:
+        content += ''') const {
+  assertInitialized();
+  return boundKernel(*this, NULL, 0);
+}
+'''
+    return content
+
+
 @to_file('include/occa/core/inlinedKernelScope.hpp')
 def inlined_kernel_scope_definitions(N):
     return '\n\n'.join(
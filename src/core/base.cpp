@@ -70,6 +70,14 @@ namespace occa {
     return getDevice().tagStream();
   }
 
+  void beginCapture() {
+    getDevice().beginCapture();
+  }
+
+  graph endCapture() {
+    return getDevice().endCapture();
+  }
+
   //---[ Kernel Functions ]-------------
   kernel buildKernel(const std::string &filename,
                      const std::string &kernelName,
@@ -80,6 +88,12 @@ namespace occa {
                                    props);
   }
 
+  namedKernelMap buildKernels(const std::string &filename,
+                              const occa::properties &props) {
+
+    return getDevice().buildKernels(filename, props);
+  }
+
   kernel buildKernelFromString(const std::string &content,
                                const std::string &kernelName,
                                const occa::properties &props) {
@@ -123,15 +137,19 @@ namespace occa {
     return getDevice().umalloc(entries, dtype::byte, src, props);
   }
 
+  occa::memory mmap(const std::string &filename,
+                    const udim_t offset,
+                    const udim_t bytes,
+                    const occa::properties &props) {
+    return getDevice().mmap(filename, offset, bytes, props);
+  }
+
   void memcpy(void *dest, const void *src,
               const dim_t bytes,
               const occa::properties &props) {
 
-    ptrRangeMap::iterator srcIt  = uvaMap.find(const_cast<void*>(src));
-    ptrRangeMap::iterator destIt = uvaMap.find(dest);
-
-    occa::modeMemory_t *srcMem  = ((srcIt  != uvaMap.end()) ? (srcIt->second)  : NULL);
-    occa::modeMemory_t *destMem = ((destIt != uvaMap.end()) ? (destIt->second) : NULL);
+    occa::modeMemory_t *srcMem  = uvaMap.find(const_cast<void*>(src));
+    occa::modeMemory_t *destMem = uvaMap.find(dest);
 
     const udim_t srcOff  = (srcMem
                             ? (((char*) src)  - srcMem->uvaPtr)
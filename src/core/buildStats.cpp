@@ -0,0 +1,185 @@
+#include <mutex>
+
+#include <occa/core/buildStats.hpp>
+#include <occa/tools/sys.hpp>
+#include <occa/tools/tls.hpp>
+
+namespace occa {
+  namespace {
+    std::mutex& statsMutex() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    buildStats_t& processStats() {
+      static buildStats_t stats;
+      return stats;
+    }
+
+    // Stats for the kernel being built in this thread
+    buildStats_t*& currentStats() {
+      static tls<buildStats_t*> stats(NULL);
+      return stats.value();
+    }
+
+    template <class func_t>
+    void addStats(func_t func) {
+      {
+        std::lock_guard<std::mutex> guard(statsMutex());
+        func(processStats());
+      }
+      buildStats_t *stats = currentStats();
+      if (stats) {
+        func(*stats);
+      }
+    }
+  }
+
+  namespace buildStage {
+    std::string name(const int stage) {
+      switch (stage) {
+      case hashing     : return "hashing";
+      case dependencies: return "dependencies";
+      case parsing     : return "parsing";
+      case codegen     : return "codegen";
+      case compiling   : return "compiling";
+      case loading     : return "loading";
+      }
+      return "";
+    }
+  }
+
+  buildStats_t::buildStats_t() {
+    clear();
+  }
+
+  void buildStats_t::clear() {
+    for (int i = 0; i < buildStage::count; ++i) {
+      stageTimes[i] = 0;
+    }
+    memoryCacheHits  = 0;
+    diskCacheHits    = 0;
+    sharedBinaryHits = 0;
+    cacheMisses      = 0;
+  }
+
+  double buildStats_t::totalTime() const {
+    double total = 0;
+    for (int i = 0; i < buildStage::count; ++i) {
+      total += stageTimes[i];
+    }
+    return total;
+  }
+
+  buildStats_t& buildStats_t::operator += (const buildStats_t &other) {
+    for (int i = 0; i < buildStage::count; ++i) {
+      stageTimes[i] += other.stageTimes[i];
+    }
+    memoryCacheHits  += other.memoryCacheHits;
+    diskCacheHits    += other.diskCacheHits;
+    sharedBinaryHits += other.sharedBinaryHits;
+    cacheMisses      += other.cacheMisses;
+    return *this;
+  }
+
+  json buildStats_t::toJson() const {
+    json stages(json::object_);
+    for (int i = 0; i < buildStage::count; ++i) {
+      stages.set(buildStage::name(i), stageTimes[i]);
+    }
+    stages.set("total", totalTime());
+
+    json cache(json::object_);
+    cache.set("memory_hits", memoryCacheHits);
+    cache.set("disk_hits", diskCacheHits);
+    cache.set("shared_binary_hits", sharedBinaryHits);
+    cache.set("misses", cacheMisses);
+
+    json j(json::object_);
+    j.set("stages", stages);
+    j.set("cache", cache);
+    return j;
+  }
+
+  buildStats_t getBuildStats() {
+    std::lock_guard<std::mutex> guard(statsMutex());
+    return processStats();
+  }
+
+  void resetBuildStats() {
+    std::lock_guard<std::mutex> guard(statsMutex());
+    processStats().clear();
+  }
+
+  namespace buildStats {
+    namespace {
+      struct stageTimeAdder {
+        int stage;
+        double seconds;
+
+        void operator () (buildStats_t &stats) const {
+          stats.stageTimes[stage] += seconds;
+        }
+      };
+
+      struct counterAdder {
+        int buildStats_t::*counter;
+
+        void operator () (buildStats_t &stats) const {
+          ++(stats.*counter);
+        }
+      };
+
+      void addCounter(int buildStats_t::*counter) {
+        counterAdder adder;
+        adder.counter = counter;
+        addStats(adder);
+      }
+    }
+
+    void addStageTime(const int stage,
+                      const double seconds) {
+      stageTimeAdder adder;
+      adder.stage = stage;
+      adder.seconds = seconds;
+      addStats(adder);
+    }
+
+    void addMemoryCacheHit() {
+      addCounter(&buildStats_t::memoryCacheHits);
+    }
+
+    void addDiskCacheHit() {
+      addCounter(&buildStats_t::diskCacheHits);
+    }
+
+    void addSharedBinaryHit() {
+      addCounter(&buildStats_t::sharedBinaryHits);
+    }
+
+    void addCacheMiss() {
+      addCounter(&buildStats_t::cacheMisses);
+    }
+
+    stageTimer::stageTimer(const int stage_) :
+      stage(stage_),
+      startTime(sys::currentTime()) {}
+
+    stageTimer::~stageTimer() {
+      addStageTime(stage, sys::currentTime() - startTime);
+    }
+
+    kernelScope::kernelScope() :
+      previousStats(currentStats()) {
+      currentStats() = &stats;
+    }
+
+    kernelScope::~kernelScope() {
+      // Nested builds are part of the outer build
+      if (previousStats) {
+        *previousStats += stats;
+      }
+      currentStats() = previousStats;
+    }
+  }
+}
@@ -1,8 +1,13 @@
+#include <fstream>
+
 #include <occa/core/device.hpp>
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/modes.hpp>
 #include <occa/tools/env.hpp>
+#include <occa/tools/exception.hpp>
 #include <occa/tools/sys.hpp>
+#include <occa/tools/threadPool.hpp>
 #include <occa/io.hpp>
 
 namespace occa {
@@ -11,7 +16,10 @@ namespace occa {
     mode((std::string) properties_["mode"]),
     properties(properties_),
     needsLauncherKernel(false),
-    bytesAllocated(0) {}
+    bytesAllocated(0),
+    memoryPool(this),
+    pendingBuilds(0),
+    cancelBuilds(false) {}
 
   modeDevice_t::~modeDevice_t() {
     // Null all wrappers
@@ -24,12 +32,51 @@ namespace occa {
 
   // Must be called before ~modeDevice_t()!
   void modeDevice_t::freeResources() {
+    // Build jobs use the device until they finish
+    {
+      std::unique_lock<std::mutex> lock(buildMutex);
+      cancelBuilds = true;
+      while (pendingBuilds) {
+        buildCondition.wait(lock);
+      }
+    }
+
+    // Captured nodes hold references to kernels and memory
+    gc::ringEntry_t *head = streamRing.head;
+    if (head) {
+      gc::ringEntry_t *entry = head;
+      do {
+        modeStream_t *modeStream = (modeStream_t*) entry;
+        delete modeStream->captureGraph;
+        modeStream->captureGraph = NULL;
+        entry = entry->rightRingEntry;
+      } while (entry != head);
+    }
+    loadedKernels.clear();
+    memoryPool.trim();
+
     freeRing<modeKernel_t>(kernelRing);
     freeRing<modeMemory_t>(memoryRing);
     freeRing<modeStream_t>(streamRing);
     freeRing<modeStreamTag_t>(streamTagRing);
   }
 
+  void modeDevice_t::addPendingBuild() {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    ++pendingBuilds;
+  }
+
+  bool modeDevice_t::startPendingBuild() {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    return !cancelBuilds;
+  }
+
+  void modeDevice_t::finishPendingBuild() {
+    std::lock_guard<std::mutex> lock(buildMutex);
+    --pendingBuilds;
+    buildCondition.notify_all();
+  }
+
   void modeDevice_t::dontUseRefs() {
     deviceRing.dontUseRefs();
   }
@@ -47,13 +94,71 @@ namespace occa {
   }
 
   void modeDevice_t::addKernelRef(modeKernel_t *kernel) {
+    std::lock_guard<std::mutex> lock(kernelMutex);
     kernelRing.addRef(kernel);
   }
 
   void modeDevice_t::removeKernelRef(modeKernel_t *kernel) {
+    std::lock_guard<std::mutex> lock(kernelMutex);
     kernelRing.removeRef(kernel);
   }
 
+  modeMemory_t* modeDevice_t::mmap(const std::string &filename,
+                                   const udim_t offset,
+                                   const udim_t bytes,
+                                   const occa::properties &props) {
+    udim_t chunkBytes = 64 << 20;
+    if (props["chunk_bytes"].isString()) {
+      chunkBytes = parseBytes(props["chunk_bytes"].string());
+    } else if (props["chunk_bytes"].isNumber()) {
+      chunkBytes = (udim_t) (double) props["chunk_bytes"];
+    }
+    OCCA_ERROR("Memory property [chunk_bytes] should be positive",
+               chunkBytes > 0);
+    chunkBytes = std::min(chunkBytes, bytes);
+
+    std::ifstream file(io::filename(filename).c_str(),
+                       std::ios::in | std::ios::binary);
+    OCCA_ERROR("Unable to open file [" << filename << "]",
+               file.is_open());
+    file.seekg((std::streamoff) offset);
+
+    modeMemory_t *modeMemory = malloc(bytes, NULL, props);
+
+    occa::properties asyncProps = props;
+    asyncProps["async"] = true;
+
+    // Reading a chunk overlaps with the upload of the previous chunk
+    char *buffers[2] = {
+      (char*) sys::malloc(chunkBytes),
+      (char*) sys::malloc(chunkBytes)
+    };
+    bool readFile = true;
+    for (udim_t chunkOffset = 0; readFile && (chunkOffset < bytes); chunkOffset += chunkBytes) {
+      const udim_t readBytes = std::min(chunkBytes, bytes - chunkOffset);
+      char *buffer = buffers[(chunkOffset / chunkBytes) % 2];
+
+      file.read(buffer, (std::streamsize) readBytes);
+      readFile = ((udim_t) file.gcount() == readBytes);
+
+      // The next chunk reuses the buffer from the previous upload
+      finish();
+      if (readFile) {
+        modeMemory->copyFrom(buffer, readBytes, chunkOffset, asyncProps);
+      }
+    }
+    finish();
+
+    sys::free(buffers[0]);
+    sys::free(buffers[1]);
+
+    if (!readFile) {
+      delete modeMemory;
+      OCCA_FORCE_ERROR("Unable to read [" << bytes << "] bytes from file [" << filename << "]");
+    }
+    return modeMemory;
+  }
+
   void modeDevice_t::addMemoryRef(modeMemory_t *memory) {
     memoryRing.addRef(memory);
   }
@@ -68,6 +173,7 @@ namespace occa {
 
   void modeDevice_t::removeStreamRef(modeStream_t *stream) {
     streamRing.removeRef(stream);
+    memoryPool.removeStream(stream);
   }
 
   void modeDevice_t::addStreamTagRef(modeStreamTag_t *streamTag) {
@@ -97,6 +203,12 @@ namespace occa {
     infoProps["kernel/dependencies"] = sourceMetadata.getDependencyJson();
 
     io::writeBuildFile(filename, kernelHash, infoProps);
+
+    // Launcher build files have no dependencies
+    if (io::basename(filename) == kc::buildFile) {
+      io::cacheIndex().setDependencies(kernelHash,
+                                       infoProps["kernel/dependencies"]);
+    }
   }
 
   std::string modeDevice_t::getKernelHash(const std::string &fullHash,
@@ -111,22 +223,38 @@ namespace occa {
   }
 
   std::string modeDevice_t::getKernelHash(modeKernel_t *kernel) {
-    return getKernelHash(kernel->properties["hash"],
+    return getKernelHash(kernel->hash,
                          kernel->name);
   }
 
-  kernel& modeDevice_t::getCachedKernel(const hash_t &kernelHash,
-                                        const std::string &kernelName) {
+  modeKernel_t* modeDevice_t::getCachedKernel(const hash_t &kernelHash,
+                                              const std::string &kernelName) {
+    std::lock_guard<std::mutex> lock(kernelMutex);
+    cachedKernelMapIterator it = cachedKernels.find(
+      getKernelHash(kernelHash, kernelName)
+    );
+    if (it != cachedKernels.end()) {
+      return it->second;
+    }
+    return NULL;
+  }
 
-    return cachedKernels[getKernelHash(kernelHash, kernelName)];
+  void modeDevice_t::addCachedKernel(modeKernel_t *kernel) {
+    if (kernel == NULL) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(kernelMutex);
+    cachedKernels[getKernelHash(kernel)] = kernel;
   }
 
   void modeDevice_t::removeCachedKernel(modeKernel_t *kernel) {
-    if (kernel == NULL) {
+    if (kernel == NULL || !kernel->hash.initialized) {
       return;
     }
+    std::lock_guard<std::mutex> lock(kernelMutex);
     cachedKernelMapIterator it = cachedKernels.find(getKernelHash(kernel));
-    if (it != cachedKernels.end()) {
+    // Make sure we don't remove a newer kernel with the same hash
+    if ((it != cachedKernels.end()) && (it->second == kernel)) {
       cachedKernels.erase(it);
     }
   }
@@ -305,6 +433,19 @@ namespace occa {
     return 0;
   }
 
+  memoryPoolStats_t device::memoryPoolStats() const {
+    if (modeDevice) {
+      return modeDevice->memoryPool.getStats();
+    }
+    return memoryPoolStats_t();
+  }
+
+  void device::trimMemoryPool(const udim_t bytes) {
+    if (modeDevice) {
+      modeDevice->memoryPool.trim(bytes);
+    }
+  }
+
   void device::finish() {
     if (!modeDevice) {
       return;
@@ -314,7 +455,7 @@ namespace occa {
       for (size_t i = 0; i < staleEntries; ++i) {
         occa::modeMemory_t *mem = uvaStaleMemory[i];
 
-        mem->copyTo(mem->uvaPtr, mem->size, 0, "async: true");
+        syncDirtyRanges(mem, false, "async: true");
 
         mem->memInfo &= ~uvaFlag::inDevice;
         mem->memInfo &= ~uvaFlag::isStale;
@@ -364,43 +505,166 @@ namespace occa {
   }
   //  |=================================
 
+  //  |---[ Graph ]---------------------
+  void device::beginCapture() {
+    assertInitialized();
+    modeStream_t *modeStream = modeDevice->currentStream.getModeStream();
+    OCCA_ERROR("Device has no current stream to capture",
+               modeStream != NULL);
+    OCCA_ERROR("Stream is already capturing a graph",
+               modeStream->captureGraph == NULL);
+    modeStream->captureGraph = new graph_t();
+  }
+
+  graph device::endCapture() {
+    assertInitialized();
+    modeStream_t *modeStream = modeDevice->currentStream.getModeStream();
+    OCCA_ERROR("Stream is not capturing a graph",
+               modeStream && modeStream->captureGraph);
+    graph_t *captureGraph = modeStream->captureGraph;
+    modeStream->captureGraph = NULL;
+    return graph(captureGraph);
+  }
+
+  bool device::isCapturing() const {
+    return (modeDevice &&
+            modeDevice->getCaptureGraph());
+  }
+  //  |=================================
+
   //  |---[ Kernel ]--------------------
+  namespace {
+    hash_t hashSourceFile(const std::string &filename) {
+      buildStats::stageTimer timer(buildStage::hashing);
+      return hashFile(filename);
+    }
+
+    // Kernel hashes from device::buildKernel, keyed by the device hash,
+    //   filename and properties so devices with the same mode share them
+    //   - Used while the source and its dependencies keep their stamps,
+    //     without rehashing them
+    struct kernelHashMemo_t {
+      hash_t kernelHash;
+      std::string realFilename;
+      strVector files;
+      strVector stamps;
+    };
+
+    typedef std::map<std::string, kernelHashMemo_t> kernelHashMemoMap;
+
+    std::mutex& kernelHashMemoMutex() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    kernelHashMemoMap& kernelHashMemos() {
+      static kernelHashMemoMap memos;
+      return memos;
+    }
+
+    bool findKernelHashMemo(const std::string &memoKey,
+                            hash_t &kernelHash,
+                            std::string &realFilename) {
+      kernelHashMemo_t memo;
+      {
+        std::lock_guard<std::mutex> lock(kernelHashMemoMutex());
+        kernelHashMemoMap::iterator it = kernelHashMemos().find(memoKey);
+        if (it == kernelHashMemos().end()) {
+          return false;
+        }
+        memo = it->second;
+      }
+
+      const int fileCount = (int) memo.files.size();
+      for (int i = 0; i < fileCount; ++i) {
+        std::string stamp;
+        if (!getFileStamp(memo.files[i], stamp)
+            || (stamp != memo.stamps[i])) {
+          return false;
+        }
+      }
+
+      kernelHash = memo.kernelHash;
+      realFilename = memo.realFilename;
+      return true;
+    }
+
+    // Compiled kernels keep their build stats in the build.json
+    void writeBuildStats(const std::string &hashDir,
+                         const hash_t &kernelHash,
+                         const buildStats_t &stats) {
+      if (stats.cacheMisses) {
+        io::writeBuildStats(hashDir + kc::buildFile,
+                            kernelHash,
+                            stats.toJson());
+      }
+    }
+  }
+
   void device::setupKernelInfo(const occa::properties &props,
                                const hash_t &sourceHash,
                                occa::properties &kernelProps,
                                hash_t &kernelHash) const {
     assertInitialized();
 
-    kernelProps = kernelProperties(props);
+    {
+      buildStats::stageTimer timer(buildStage::hashing);
+      kernelProps = kernelProperties(props);
 
-    kernelHash = (
-      hash()
-      ^ modeDevice->kernelHash(kernelProps)
-      ^ kernelHeaderHash(kernelProps)
-      ^ sourceHash
-    );
+      kernelHash = (
+        hash()
+        ^ modeDevice->kernelHash(kernelProps)
+        ^ kernelHeaderHash(kernelProps)
+        ^ sourceHash
+      );
+    }
 
+    buildStats::stageTimer timer(buildStage::dependencies);
     kernelHash = applyDependencyHash(kernelHash);
   }
 
-  hash_t device::applyDependencyHash(const hash_t &kernelHash) const {
-    // Check if the build.json exists to compare dependencies
-    const std::string buildFile = io::hashDir(kernelHash) + kc::buildFile;
-    if (!io::exists(buildFile)) {
-      return kernelHash;
+  const jsonObject* device::findDependencyHashes(const hash_t &kernelHash) const {
+    kernelDependencyMap &kernelDependencies = modeDevice->kernelDependencies;
+    const std::string fullHash = kernelHash.getFullString();
+
+    kernelDependencyMap::iterator depIt = kernelDependencies.find(fullHash);
+    if (depIt == kernelDependencies.end()) {
+      jsonObject dependencyHashes;
+      if (!io::cacheIndex().getDependencies(kernelHash, dependencyHashes)) {
+        // Check if the build.json exists to compare dependencies
+        const std::string buildFile = io::hashDir(kernelHash) + kc::buildFile;
+        if (!io::exists(buildFile)) {
+          return NULL;
+        }
+
+        json buildJson = json::read(buildFile);
+        json dependenciesJson = buildJson["kernel/dependencies"];
+        io::cacheIndex().setDependencies(kernelHash, dependenciesJson);
+
+        if (dependenciesJson.isObject()) {
+          dependencyHashes = dependenciesJson.object();
+        }
+      }
+
+      // The build.json doesn't change once written, cache its dependencies
+      depIt = kernelDependencies.insert(
+        std::make_pair(fullHash, dependencyHashes)
+      ).first;
     }
+    return &(depIt->second);
+  }
 
-    json buildJson = json::read(buildFile);
-    json dependenciesJson = buildJson["kernel/dependencies"];
-    if (!dependenciesJson.isInitialized()) {
+  hash_t device::applyDependencyHash(const hash_t &kernelHash) const {
+    const jsonObject *dependencyHashesPtr = findDependencyHashes(kernelHash);
+    if (!dependencyHashesPtr || dependencyHashesPtr->empty()) {
       return kernelHash;
     }
+    const jsonObject &dependencyHashes = *dependencyHashesPtr;
 
     hash_t newKernelHash = kernelHash;
     bool foundDependencyChanges = false;
 
-    jsonObject dependencyHashes = dependenciesJson.object();
-    jsonObject::iterator it = dependencyHashes.begin();
+    jsonObject::const_iterator it = dependencyHashes.begin();
     while (it != dependencyHashes.end()) {
       const std::string &dependency = it->first;
       const hash_t dependencyHash = hash_t::fromString(it->second);
@@ -428,22 +692,73 @@ namespace occa {
     return kernelHash;
   }
 
+  void device::memoizeKernelHash(const std::string &memoKey,
+                                 const hash_t &kernelHash,
+                                 const std::string &realFilename) const {
+    // Kernels without a build.json can't list their dependencies
+    const jsonObject *dependencyHashes = findDependencyHashes(kernelHash);
+    if (!dependencyHashes) {
+      return;
+    }
+
+    kernelHashMemo_t memo;
+    memo.kernelHash = kernelHash;
+    memo.realFilename = realFilename;
+    memo.files.push_back(realFilename);
+    jsonObject::const_iterator it = dependencyHashes->begin();
+    while (it != dependencyHashes->end()) {
+      memo.files.push_back(it->first);
+      ++it;
+    }
+
+    const int fileCount = (int) memo.files.size();
+    for (int i = 0; i < fileCount; ++i) {
+      std::string stamp;
+      if (!getFileStamp(memo.files[i], stamp)) {
+        return;
+      }
+      memo.stamps.push_back(stamp);
+    }
+
+    std::lock_guard<std::mutex> lock(kernelHashMemoMutex());
+    kernelHashMemos()[memoKey] = memo;
+  }
+
   kernel device::buildKernel(const std::string &filename,
                              const std::string &kernelName,
                              const occa::properties &props) const {
+    buildStats::kernelScope buildScope;
+
+    // Repeated builds skip the path lookup and hashing
+    const std::string memoKey = (
+      hash().getFullString()
+      + '|' + filename
+      + '|' + occa::hash(props).getFullString()
+    );
+
     occa::properties allProps;
     hash_t kernelHash;
-    const std::string realFilename = io::findInPaths(filename, env::OCCA_KERNEL_PATH);
-    setupKernelInfo(props, hashFile(realFilename),
-                    allProps, kernelHash);
-
-    // TODO: [#185] Fix kernel cache frees
-    // // Check cache first
-    // kernel &cachedKernel = modeDevice->getCachedKernel(kernelHash,
-    //                                                    kernelName);
-    // if (cachedKernel.isInitialized()) {
-    //   return cachedKernel;
-    // }
+    std::string realFilename;
+    if (findKernelHashMemo(memoKey, kernelHash, realFilename)) {
+      kernel cachedKernel = getCachedKernel(kernelHash, kernelName);
+      if (cachedKernel.isInitialized()) {
+        buildStats::addMemoryCacheHit();
+        return cachedKernel;
+      }
+      allProps = kernelProperties(props);
+    } else {
+      realFilename = io::findInPaths(filename, env::OCCA_KERNEL_PATH);
+      setupKernelInfo(props, hashSourceFile(realFilename),
+                      allProps, kernelHash);
+
+      // Check cache first
+      kernel cachedKernel = getCachedKernel(kernelHash, kernelName);
+      if (cachedKernel.isInitialized()) {
+        buildStats::addMemoryCacheHit();
+        memoizeKernelHash(memoKey, kernelHash, realFilename);
+        return cachedKernel;
+      }
+    }
 
     const std::string hashDir = io::hashDir(realFilename, kernelHash);
     allProps["hash"] = kernelHash.getFullString();
@@ -455,6 +770,11 @@ namespace occa {
 
     if (cachedKernel.isInitialized()) {
       cachedKernel.modeKernel->hash = kernelHash;
+      cachedKernel.modeKernel->setupArgValidation();
+      cachedKernel.modeKernel->properties["build_stats"] = buildScope.stats.toJson();
+      modeDevice->addCachedKernel(cachedKernel.modeKernel);
+      writeBuildStats(hashDir, kernelHash, buildScope.stats);
+      memoizeKernelHash(memoKey, kernelHash, realFilename);
     } else {
       sys::rmrf(hashDir);
     }
@@ -462,6 +782,58 @@ namespace occa {
     return cachedKernel;
   }
 
+  namedKernelMap device::buildKernels(const std::string &filename,
+                                      const occa::properties &props) const {
+    assertInitialized();
+
+    buildStats::kernelScope buildScope;
+
+    occa::properties allProps;
+    hash_t kernelHash;
+    const std::string realFilename = io::findInPaths(filename, env::OCCA_KERNEL_PATH);
+    setupKernelInfo(props, hashSourceFile(realFilename),
+                    allProps, kernelHash);
+    allProps["hash"] = kernelHash.getFullString();
+
+    std::vector<modeKernel_t*> modeKernels;
+    if (!modeDevice->buildKernels(realFilename,
+                                  kernelHash,
+                                  allProps,
+                                  modeKernels)) {
+      sys::rmrf(io::hashDir(realFilename, kernelHash));
+    }
+
+    // Kernels share the build, they all get its stats
+    const json statsJson = buildScope.stats.toJson();
+
+    namedKernelMap kernels;
+    const int kernelCount = (int) modeKernels.size();
+    for (int i = 0; i < kernelCount; ++i) {
+      kernel builtKernel(modeKernels[i]);
+      const std::string &kernelName = builtKernel.name();
+
+      // Keep using kernels that were already built, the new one is freed
+      kernel cachedKernel = getCachedKernel(kernelHash, kernelName);
+      if (cachedKernel.isInitialized()) {
+        buildStats::addMemoryCacheHit();
+        kernels[kernelName] = cachedKernel;
+        continue;
+      }
+
+      builtKernel.modeKernel->hash = kernelHash;
+      builtKernel.modeKernel->setupArgValidation();
+      builtKernel.modeKernel->properties["build_stats"] = statsJson;
+      modeDevice->addCachedKernel(builtKernel.modeKernel);
+      kernels[kernelName] = builtKernel;
+    }
+
+    writeBuildStats(io::hashDir(realFilename, kernelHash),
+                    kernelHash,
+                    buildScope.stats);
+
+    return kernels;
+  }
+
   kernel device::buildKernelFromString(const std::string &content,
                                        const std::string &kernelName,
                                        const occa::properties &props) const {
@@ -470,6 +842,20 @@ namespace occa {
     setupKernelInfo(props, occa::hash(content),
                     allProps, kernelHash);
 
+    // Skip writing the source if the kernel was already built
+    kernel cachedKernel = getCachedKernel(kernelHash, kernelName);
+    if (cachedKernel.isInitialized()) {
+      buildStats::addMemoryCacheHit();
+      return cachedKernel;
+    }
+
+    return buildKernel(writeStringSource(content, kernelHash),
+                       kernelName,
+                       props);
+  }
+
+  std::string device::writeStringSource(const std::string &content,
+                                        const hash_t &kernelHash) const {
     io::lock_t lock(kernelHash, "occa-device");
     std::string stringSourceFile = io::hashDir(kernelHash);
     stringSourceFile += "string_source.cpp";
@@ -481,9 +867,153 @@ namespace occa {
       lock.release();
     }
 
-    return buildKernel(stringSourceFile,
-                       kernelName,
-                       props);
+    return stringSourceFile;
+  }
+
+  kernelFuture device::buildKernelAsync(const std::string &filename,
+                                        const std::string &kernelName,
+                                        const occa::properties &props) const {
+    assertInitialized();
+
+    // Hashing and cache checks are done in the calling thread
+    occa::properties allProps;
+    hash_t kernelHash;
+    const std::string realFilename = io::findInPaths(filename, env::OCCA_KERNEL_PATH);
+    setupKernelInfo(props, hashSourceFile(realFilename),
+                    allProps, kernelHash);
+
+    return submitKernelBuild(realFilename,
+                             kernelName,
+                             kernelHash,
+                             allProps);
+  }
+
+  kernelFuture device::buildKernelFromStringAsync(const std::string &content,
+                                                  const std::string &kernelName,
+                                                  const occa::properties &props) const {
+    assertInitialized();
+
+    occa::properties allProps;
+    hash_t kernelHash;
+    setupKernelInfo(props, occa::hash(content),
+                    allProps, kernelHash);
+
+    // Skip writing the source if the kernel was already built
+    if (!modeDevice->getCachedKernel(kernelHash, kernelName)) {
+      writeStringSource(content, kernelHash);
+    }
+
+    return buildKernelAsync(io::hashDir(kernelHash) + "string_source.cpp",
+                            kernelName,
+                            props);
+  }
+
+  namespace {
+    class kernelBuildJob : public threadPoolJob {
+    public:
+      kernelBuildState_t *state;
+      modeDevice_t *modeDevice;
+      // Settings are thread-local
+      occa::properties settings_;
+
+      std::string filename;
+      std::string kernelName;
+      hash_t kernelHash;
+      occa::properties kernelProps;
+
+      kernelBuildJob(kernelBuildState_t *state_,
+                     modeDevice_t *modeDevice_,
+                     const std::string &filename_,
+                     const std::string &kernelName_,
+                     const hash_t &kernelHash_,
+                     const occa::properties &kernelProps_) :
+        state(state_),
+        modeDevice(modeDevice_),
+        settings_(settings()),
+        filename(filename_),
+        kernelName(kernelName_),
+        kernelHash(kernelHash_),
+        kernelProps(kernelProps_) {}
+
+      void run() {
+        settings() = settings_;
+
+        // Hashing was done in the submitting thread,
+        //   it's only part of the process stats
+        buildStats::kernelScope buildScope;
+
+        modeKernel_t *modeKernel = NULL;
+        std::exception_ptr error;
+        try {
+          OCCA_ERROR("Device was freed before building [" << kernelName << "]",
+                     modeDevice->startPendingBuild());
+
+          // Cross-process dedup still goes through the io::lock_t
+          //   taken by the mode's buildKernel
+          modeKernel = modeDevice->buildKernel(filename,
+                                               kernelName,
+                                               kernelHash,
+                                               kernelProps);
+          if (modeKernel) {
+            modeKernel->hash = kernelHash;
+            modeKernel->setupArgValidation();
+            modeKernel->properties["build_stats"] = buildScope.stats.toJson();
+            writeBuildStats(io::hashDir(filename, kernelHash),
+                            kernelHash,
+                            buildScope.stats);
+          } else {
+            sys::rmrf(io::hashDir(filename, kernelHash));
+          }
+        } catch (...) {
+          error = std::current_exception();
+        }
+
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->modeKernel = modeKernel;
+          state->error = error;
+          state->isDone = true;
+          state->condition.notify_all();
+        }
+        // The device can be freed after this
+        modeDevice->finishPendingBuild();
+      }
+    };
+  }
+
+  kernelFuture device::submitKernelBuild(const std::string &filename,
+                                         const std::string &kernelName,
+                                         const hash_t &kernelHash,
+                                         occa::properties &kernelProps) const {
+    std::shared_ptr<kernelBuildState_t> state(
+      new kernelBuildState_t(*this)
+    );
+
+    state->kernel = getCachedKernel(kernelHash, kernelName);
+    if (state->kernel.isInitialized()) {
+      buildStats::addMemoryCacheHit();
+      state->isDone = true;
+      return kernelFuture(state);
+    }
+
+    kernelProps["hash"] = kernelHash.getFullString();
+
+    modeDevice->addPendingBuild();
+    buildThreadPool().enqueue(
+      new kernelBuildJob(state.get(),
+                         modeDevice,
+                         filename,
+                         kernelName,
+                         kernelHash,
+                         kernelProps)
+    );
+
+    return kernelFuture(state);
+  }
+
+  kernel device::getCachedKernel(const hash_t &kernelHash,
+                                 const std::string &kernelName) const {
+    return kernel(modeDevice->getCachedKernel(kernelHash, kernelName));
   }
 
   kernel device::buildKernelFromBinary(const std::string &filename,
@@ -491,58 +1021,115 @@ namespace occa {
                                        const occa::properties &props) const {
     assertInitialized();
 
-    return kernel(modeDevice->buildKernelFromBinary(filename,
-                                                    kernelName,
-                                                    props));
+    kernel k(modeDevice->buildKernelFromBinary(filename,
+                                               kernelName,
+                                               props));
+    if (k.isInitialized()) {
+      k.modeKernel->setupArgValidation();
+    }
+    return k;
   }
 
-  void device::loadKernels(const std::string &library) {
-    // TODO 1.1: Load kernels
-#if 0
+  int device::loadKernels(const std::string &library) {
     assertInitialized();
 
-    std::string devHash = hash().getFullString();
-    strVector dirs = io::directories("occa://" + library);
-    const int dirCount = (int) dirs.size();
-    int kernelsLoaded = 0;
+    const std::string devHash = modeDevice->versionedHash().getFullString();
+    const std::string searchPath = (
+      library.size()
+      ? io::libraryCachePath(library)
+      : io::cachePath()
+    );
+
+    const bool verbose = modeDevice->properties.get("verbose", false);
 
+    // Kernels are loaded through the build thread pool,
+    //   the build.json files are only read here
+    std::vector<kernelFuture> futures;
+    strVector futureLabels;
+
+    strVector dirs = io::directories(searchPath);
+    const int dirCount = (int) dirs.size();
     for (int d = 0; d < dirCount; ++d) {
       const std::string buildFile = dirs[d] + kc::buildFile;
-
-      if (!io::isFile(buildFile)) {
+      if (!io::isFile(buildFile)
+          || !io::exists(dirs[d] + ".success/" + kc::binaryFile)) {
         continue;
       }
 
-      json info = json::read(buildFile)["info"];
+      json info = json::read(buildFile);
       if ((std::string) info["device/hash"] != devHash) {
         continue;
       }
-      ++kernelsLoaded;
-
-      const std::string sourceFilename = dirs[d] + kc::parsedSourceFile;
 
-      json &kInfo = info["kernel"];
-      hash_t hash = hash_t::fromString(kInfo["hash"]);
-      jsonArray metadataArray = kInfo["metadata"].array();
-      occa::properties kernelProps = kInfo["props"];
+      const std::string hashDir = (
+        library.size()
+        ? io::installLibraryCacheEntry(dirs[d])
+        : dirs[d]
+      );
+      if (!hashDir.size()) {
+        continue;
+      }
+      // Entries are only loaded, never rebuilt
+      if (!io::cachedFileIsComplete(hashDir, kc::binaryFile)) {
+        if (verbose) {
+          io::stderr << "Skipping cached kernels in ["
+                     << io::shortname(hashDir) << "]: missing ["
+                     << kc::binaryFile << "]\n";
+        }
+        continue;
+      }
 
+      const hash_t kernelHash = hash_t::fromString((std::string) info["kernel/hash"]);
+      occa::properties kernelProps = info["kernel/props"];
       // Ignore how the kernel was setup, turn off verbose
       kernelProps["verbose"] = false;
 
-      const int kernels = metadataArray.size();
-      for (int k = 0; k < kernels; ++k) {
-        buildKernel(sourceFilename,
-                    hash,
-                    kernelProps,
-                    lang::kernelMetadata_t::fromJson(metadataArray[k]));
+      // Launched modes export the kernels from their launcher
+      const std::string launcherBuildFile = hashDir + kc::launcherBuildFile;
+      const jsonArray metadataArray = (
+        io::isFile(launcherBuildFile)
+        ? json::read(launcherBuildFile)["kernel/metadata"].array()
+        : info["kernel/metadata"].array()
+      );
+
+      const int kernelCount = (int) metadataArray.size();
+      for (int k = 0; k < kernelCount; ++k) {
+        const std::string kernelName = metadataArray[k]["name"];
+        futures.push_back(
+          submitKernelBuild(hashDir + kc::sourceFile,
+                            kernelName,
+                            kernelHash,
+                            kernelProps)
+        );
+        futureLabels.push_back(
+          "[" + kernelName + "] from [" + io::shortname(hashDir) + "]"
+        );
+      }
+    }
+
+    int kernelsLoaded = 0;
+    const int futureCount = (int) futures.size();
+    for (int i = 0; i < futureCount; ++i) {
+      // Skip kernels whose cached binary no longer loads, for example after
+      //   an OCCA update, they get rebuilt when needed
+      try {
+        kernel k = futures[i].get();
+        if (k.isInitialized()) {
+          modeDevice->loadedKernels.push_back(k);
+          ++kernelsLoaded;
+        }
+      } catch (occa::exception &e) {
+        if (verbose) {
+          io::stderr << "Unable to load cached kernel " << futureLabels[i]
+                     << ": " << e.message << '\n';
+        }
       }
     }
 
-    // Print loaded info
-    if (properties().get("verbose", false) && kernelsLoaded) {
+    if (verbose && kernelsLoaded) {
       io::stdout << "Loaded " << kernelsLoaded;
       if (library.size()) {
-        io::stdout << " ["<< library << "]";
+        io::stdout << " [" << library << "]";
       } else {
         io::stdout << " cached";
       }
@@ -550,7 +1137,8 @@ namespace occa {
                      ? " kernel\n"
                      : " kernels\n");
     }
-#endif
+
+    return kernelsLoaded;
   }
   //  |=================================
 
@@ -572,7 +1160,11 @@ namespace occa {
 
     occa::properties memProps = memoryProperties(props);
 
-    memory mem(modeDevice->malloc(bytes, src, memProps));
+    memory mem(
+      memoryPool_t::isEnabled(memProps)
+      ? modeDevice->memoryPool.malloc(bytes, src, memProps)
+      : modeDevice->malloc(bytes, src, memProps)
+    );
     mem.setDtype(dtype);
 
     modeDevice->bytesAllocated += bytes;
@@ -648,6 +1240,19 @@ namespace occa {
     mem.dontUseRefs();
     mem.setupUva();
 
+    if (memProps.get("dirty_tracking", false)) {
+      modeMemory_t *modeMemory = mem.getModeMemory();
+      modeMemory->memInfo |= uvaFlag::tracksDirty;
+
+      // Page granularity by default
+      const json &granularity = memProps["dirty_granularity"];
+      modeMemory->dirtyRanges.granularity = (
+        granularity.isString()
+        ? parseBytes(granularity.string())
+        : (granularity.isNumber() ? (udim_t) (double) granularity : sys::pageBytes())
+      );
+    }
+
     if (memProps.get("managed", true)) {
       mem.startManaging();
     }
@@ -658,6 +1263,35 @@ namespace occa {
     return ptr;
   }
 
+  occa::memory device::mmap(const std::string &filename,
+                            const udim_t offset,
+                            const udim_t bytes,
+                            const occa::properties &props) {
+    assertInitialized();
+
+    const udim_t fileBytes = sys::fileBytes(filename);
+    OCCA_ERROR("Offset [" << offset << "] is past the end of file [" << filename << "]",
+               offset <= fileBytes);
+
+    const udim_t mapBytes = bytes ? bytes : (fileBytes - offset);
+    OCCA_ERROR("Trying to map [" << mapBytes << "] bytes from offset [" << offset << "]"
+               << " of file [" << filename << "] with [" << fileBytes << "] bytes",
+               mapBytes <= (fileBytes - offset));
+
+    if (mapBytes == 0) {
+      return memory();
+    }
+
+    occa::properties memProps = memoryProperties(props);
+
+    memory mem(
+      modeDevice->mmap(filename, offset, mapBytes, memProps)
+    );
+    modeDevice->bytesAllocated += mapBytes;
+
+    return mem;
+  }
+
   void* device::umalloc(const dim_t entries,
                         const dtype_t &dtype,
                         const occa::properties &props) {
@@ -677,6 +1311,71 @@ namespace occa {
   }
   //====================================
 
+  //---[ kernelFuture ]-----------------
+  kernelBuildState_t::kernelBuildState_t(const occa::device &device_) :
+    isDone(false),
+    device(device_),
+    modeKernel(NULL) {}
+
+  kernelBuildState_t::~kernelBuildState_t() {
+    // Free kernels that were never fetched, unless the device freed them
+    if (modeKernel && device.isInitialized()) {
+      occa::kernel unusedKernel(modeKernel);
+    }
+  }
+
+  kernelFuture::kernelFuture() {}
+
+  kernelFuture::kernelFuture(std::shared_ptr<kernelBuildState_t> state_) :
+    state(state_) {}
+
+  kernelFuture::~kernelFuture() {
+    // The build job holds a raw pointer to the state
+    if (state && state.unique()) {
+      wait();
+    }
+  }
+
+  bool kernelFuture::isInitialized() const {
+    return (bool) state;
+  }
+
+  bool kernelFuture::isReady() const {
+    if (!state) {
+      return false;
+    }
+    std::lock_guard<std::mutex> lock(state->mutex);
+    return state->isDone;
+  }
+
+  void kernelFuture::wait() const {
+    OCCA_ERROR("Kernel future not initialized",
+               state);
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (!state->isDone) {
+      state->condition.wait(lock);
+    }
+  }
+
+  occa::kernel kernelFuture::get() const {
+    wait();
+
+    kernelBuildState_t &state_ = *state;
+    if (state_.error) {
+      std::rethrow_exception(state_.error);
+    }
+    // Wrap and cache the kernel in the calling thread
+    if (state_.modeKernel) {
+      OCCA_ERROR("Device was freed before fetching the kernel",
+                 state_.device.isInitialized());
+      state_.kernel = occa::kernel(state_.modeKernel);
+      state_.device.getModeDevice()->addCachedKernel(state_.modeKernel);
+      state_.modeKernel = NULL;
+    }
+    return state_.kernel;
+  }
+  //====================================
+
   //---[ Utils ]------------------------
   occa::properties getModeSpecificProps(const std::string &mode,
                                         const occa::properties &props) {
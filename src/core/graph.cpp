@@ -0,0 +1,174 @@
+#include <occa/core/graph.hpp>
+
+namespace occa {
+  //---[ graphNode_t ]------------------
+  graphNode_t::~graphNode_t() {}
+
+  kernelGraphNode_t::kernelGraphNode_t(const boundKernel &launch_) :
+    launch(launch_) {}
+
+  void kernelGraphNode_t::run() const {
+    launch.run();
+  }
+
+  memcpyGraphNode_t::memcpyGraphNode_t(occa::memory dest_,
+                                       occa::memory src_,
+                                       void *destPtr_,
+                                       const void *srcPtr_,
+                                       const udim_t bytes_,
+                                       const udim_t destOffset_,
+                                       const udim_t srcOffset_,
+                                       const occa::properties &props_) :
+    dest(dest_),
+    src(src_),
+    destPtr(destPtr_),
+    srcPtr(srcPtr_),
+    bytes(bytes_),
+    destOffset(destOffset_),
+    srcOffset(srcOffset_),
+    props(props_) {}
+
+  void memcpyGraphNode_t::run() const {
+    // Arguments were checked when captured
+    modeMemory_t *destMemory = dest.getModeMemory();
+    modeMemory_t *srcMemory = src.getModeMemory();
+    OCCA_ERROR("Captured memory has been freed",
+               (destMemory || destPtr) && (srcMemory || srcPtr));
+
+    if (destMemory && srcMemory) {
+      destMemory->copyFrom(srcMemory, bytes, destOffset, srcOffset, props);
+    } else if (destMemory) {
+      destMemory->copyFrom(srcPtr, bytes, destOffset, props);
+    } else {
+      srcMemory->copyTo(destPtr, bytes, srcOffset, props);
+    }
+  }
+  //====================================
+
+  //---[ graph_t ]----------------------
+  graph_t::graph_t() {}
+
+  graph_t::~graph_t() {
+    const int nodeCount = (int) nodes.size();
+    for (int i = 0; i < nodeCount; ++i) {
+      delete nodes[i];
+    }
+  }
+
+  void graph_t::addLaunch(const boundKernel &launch) {
+    kernelGraphNode_t *node = new kernelGraphNode_t(launch);
+    nodes.push_back(node);
+    launches.push_back(node);
+  }
+
+  void graph_t::addCopy(occa::memory dest,
+                        occa::memory src,
+                        void *destPtr,
+                        const void *srcPtr,
+                        const udim_t bytes,
+                        const udim_t destOffset,
+                        const udim_t srcOffset,
+                        const occa::properties &props) {
+    nodes.push_back(
+      new memcpyGraphNode_t(dest, src,
+                            destPtr, srcPtr,
+                            bytes,
+                            destOffset, srcOffset,
+                            props)
+    );
+  }
+
+  void graph_t::run() const {
+    const int nodeCount = (int) nodes.size();
+    for (int i = 0; i < nodeCount; ++i) {
+      nodes[i]->run();
+    }
+  }
+  //====================================
+
+  //---[ graph ]------------------------
+  graph::graph() :
+    graph_(NULL) {}
+
+  graph::graph(graph_t *graph__) :
+    graph_(NULL) {
+    setGraph(graph__);
+  }
+
+  graph::graph(const graph &other) :
+    graph_(NULL) {
+    setGraph(other.graph_);
+  }
+
+  graph& graph::operator = (const graph &other) {
+    setGraph(other.graph_);
+    return *this;
+  }
+
+  graph::~graph() {
+    removeRef();
+  }
+
+  void graph::setGraph(graph_t *graph__) {
+    if (graph_ == graph__) {
+      return;
+    }
+    if (graph__) {
+      graph__->addRef();
+    }
+    removeRef();
+    graph_ = graph__;
+  }
+
+  void graph::removeRef() {
+    if (graph_ && !graph_->removeRef()) {
+      delete graph_;
+    }
+    graph_ = NULL;
+  }
+
+  void graph::assertInitialized() const {
+    OCCA_ERROR("Graph not initialized",
+               graph_ != NULL);
+  }
+
+  bool graph::isInitialized() const {
+    return (graph_ != NULL);
+  }
+
+  int graph::size() const {
+    return graph_ ? (int) graph_->nodes.size() : 0;
+  }
+
+  int graph::launchCount() const {
+    return graph_ ? (int) graph_->launches.size() : 0;
+  }
+
+  boundKernel& graph::getLaunch(const int index) {
+    assertInitialized();
+    const int launches = launchCount();
+    OCCA_ERROR("Launch index [" << index << "] is out of range [0, " << launches << ")",
+               (0 <= index) && (index < launches));
+    return graph_->launches[index]->launch;
+  }
+
+  void graph::setArg(const int launchIndex,
+                     const int argIndex,
+                     const kernelArg &arg) {
+    getLaunch(launchIndex).setArg(argIndex, arg);
+  }
+
+  void graph::run() const {
+    assertInitialized();
+    graph_->run();
+  }
+
+  void graph::operator () () const {
+    run();
+  }
+
+  void graph::free() {
+    removeRef();
+  }
+  //====================================
+}
@@ -1,4 +1,5 @@
 #include <occa/core/device.hpp>
+#include <occa/core/graph.hpp>
 #include <occa/core/kernel.hpp>
 #include <occa/core/memory.hpp>
 #include <occa/io.hpp>
@@ -9,6 +10,14 @@
 #include <occa/tools/uva.hpp>
 
 namespace occa {
+  //---[ argValidation_t ]--------------
+  argValidation_t::argValidation_t(const lang::argMetadata_t &argInfo) :
+    isConst(argInfo.isConst),
+    isPtr(argInfo.isPtr),
+    dtype(argInfo.dtype),
+    castableDtype(NULL) {}
+  //====================================
+
   //---[ modeKernel_t ]-----------------
   modeKernel_t::modeKernel_t(modeDevice_t *modeDevice_,
                              const std::string &name_,
@@ -17,7 +26,10 @@ namespace occa {
     modeDevice(modeDevice_),
     name(name_),
     sourceFilename(sourceFilename_),
-    properties(properties_) {
+    properties(properties_),
+    argValidationIsSetup(false),
+    argTypesValidated(false),
+    typeValidation(typeValidationMode::none) {
     modeDevice->addKernelRef(this);
   }
 
@@ -30,6 +42,7 @@ namespace occa {
     }
     // Remove ref from device
     if (modeDevice) {
+      modeDevice->removeCachedKernel(this);
       modeDevice->removeKernelRef(this);
     }
   }
@@ -50,7 +63,14 @@ namespace occa {
     return kernelRing.needsFree();
   }
 
+  bool modeKernel_t::hasArgumentLimit() const {
+    return true;
+  }
+
   void modeKernel_t::assertArgumentLimit() const {
+    if (!hasArgumentLimit()) {
+      return;
+    }
     // Check argument limit
     OCCA_ERROR("(" << name << ") Kernels can have at most [" << OCCA_MAX_ARGS << "] arguments",
                ((int) arguments.size() + 1) < OCCA_MAX_ARGS);
@@ -63,12 +83,13 @@ namespace occa {
                !argDevice || (argDevice == modeDevice));
   }
 
-  void modeKernel_t::setArguments(kernelArg *args,
+  void modeKernel_t::setArguments(const kernelArg **args,
                                   const int count) {
+    // clear() keeps the capacity, reusing the argument buffer across launches
     arguments.clear();
     arguments.reserve(count);
     for (int i = 0; i < count; ++i) {
-      pushArgument(args[i]);
+      pushArgument(*(args[i]));
     }
   }
 
@@ -83,63 +104,137 @@ namespace occa {
     assertArgumentLimit();
   }
 
-  void modeKernel_t::setupRun() {
+  void modeKernel_t::setupArgValidation() {
+    // Properties:
+    //   type_validation : true | false | 'once'
+    typeValidation = typeValidationMode::none;
+    if (metadata.isInitialized()) {
+      const occa::properties &props = properties;
+      const json &validation = props["type_validation"];
+      if (validation.isString() && (validation.string() == "once")) {
+        typeValidation = typeValidationMode::once;
+      } else if (props.get("type_validation", true)) {
+        typeValidation = typeValidationMode::always;
+      }
+    }
+
+    argValidations.clear();
+    if (typeValidation != typeValidationMode::none) {
+      const int metaArgc = (int) metadata.arguments.size();
+      argValidations.reserve(metaArgc);
+      for (int i = 0; i < metaArgc; ++i) {
+        argValidations.push_back(
+          argValidation_t(metadata.arguments[i])
+        );
+      }
+    }
+
+    argTypesValidated = false;
+    argValidationIsSetup = true;
+  }
+
+  bool modeKernel_t::argTypesChanged() const {
     const int argc = (int) arguments.size();
+    if (argc != (int) argValidations.size()) {
+      return true;
+    }
+    for (int i = 0; i < argc; ++i) {
+      const kernelArgData &arg = arguments[i];
+      modeMemory_t *mem = arg.getModeMemory();
+      const bool isPtr = mem || arg.isNull();
+      if (isPtr != argValidations[i].isPtr) {
+        return true;
+      }
+      if (mem && (&(mem->dtype_->self()) != argValidations[i].castableDtype)) {
+        return true;
+      }
+    }
+    return false;
+  }
 
-    const bool validateTypes = (
-      metadata.isInitialized()
-      && properties.get("type_validation", true)
-    );
+  void modeKernel_t::validateArguments() {
+    const int argc = (int) arguments.size();
+    const int metaArgc = (int) argValidations.size();
 
-    if (validateTypes) {
-      const int metaArgc = (int) metadata.arguments.size();
+    OCCA_ERROR("(" << name << ") Kernel expects ["
+               << metaArgc << "] argument"
+               << (metaArgc != 1 ? "s," : ",")
+               << " received ["
+               << argc << ']',
+               argc == metaArgc);
 
-      OCCA_ERROR("(" << name << ") Kernel expects ["
-                 << metaArgc << "] argument"
-                 << (metaArgc != 1 ? "s," : ",")
-                 << " received ["
-                 << argc << ']',
-                 argc == metaArgc);
+    // TODO: Get original arg #
+    for (int i = 0; i < argc; ++i) {
+      const kernelArgData &arg = arguments[i];
+      argValidation_t &argInfo = argValidations[i];
 
-      // TODO: Get original arg #
-      for (int i = 0; i < argc; ++i) {
-        kernelArgData &arg = arguments[i];
-        lang::argMetadata_t &argInfo = metadata.arguments[i];
-
-        modeMemory_t *mem = arg.getModeMemory();
-        const bool isNull = arg.isNull();
-        const bool isPtr = mem || isNull;
-        if (isPtr != argInfo.isPtr) {
-          if (argInfo.isPtr) {
-            OCCA_FORCE_ERROR("(" << name << ") Kernel expects an occa::memory for argument ["
-                             << (i + 1) << "]");
-          } else {
-            OCCA_FORCE_ERROR("(" << name << ") Kernel expects a non-occa::memory type for argument ["
-                             << (i + 1) << "]");
-          }
+      modeMemory_t *mem = arg.getModeMemory();
+      const bool isNull = arg.isNull();
+      const bool isPtr = mem || isNull;
+      if (isPtr != argInfo.isPtr) {
+        if (argInfo.isPtr) {
+          OCCA_FORCE_ERROR("(" << name << ") Kernel expects an occa::memory for argument ["
+                           << (i + 1) << "]");
+        } else {
+          OCCA_FORCE_ERROR("(" << name << ") Kernel expects a non-occa::memory type for argument ["
+                           << (i + 1) << "]");
         }
+      }
 
-        if (!isPtr || isNull) {
-          continue;
-        }
+      if (!isPtr || isNull) {
+        continue;
+      }
+
+      // Only flatten and compare dtypes when the memory dtype changes
+      const dtype_t &memDtype = mem->dtype_->self();
+      if (&memDtype == argInfo.castableDtype) {
+        continue;
+      }
 
-        OCCA_ERROR("(" << name << ") Argument [" << (i + 1) << "] has wrong runtime type.\n"
-                   << "Expected type: " << argInfo.dtype << '\n'
-                   << "Received type: " << *(mem->dtype_) << '\n',
-                   mem->dtype_->canBeCastedTo(argInfo.dtype));
+      OCCA_ERROR("(" << name << ") Argument [" << (i + 1) << "] has wrong runtime type.\n"
+                 << "Expected type: " << argInfo.dtype << '\n'
+                 << "Received type: " << memDtype << '\n',
+                 memDtype.canBeCastedTo(argInfo.dtype));
 
-        arg.setupForKernelCall(argInfo.isConst);
+      argInfo.castableDtype = &memDtype;
+    }
+
+    argTypesValidated = true;
+  }
+
+  void modeKernel_t::setupRun() {
+    if (!argValidationIsSetup) {
+      setupArgValidation();
+    }
+
+    const int argc = (int) arguments.size();
+
+    if (typeValidation == typeValidationMode::none) {
+      // Non-OKL kernel setup
+      // All memory arguments are expected to be non-const for UVA purposes
+      for (int i = 0; i < argc; ++i) {
+        kernelArgData &arg = arguments[i];
+        if (arg.modeMemory) {
+          arg.setupForKernelCall(false);
+        }
       }
       return;
     }
 
-    // Non-OKL kernel setup
-    // All memory arguments are expected to be non-const for UVA purposes
+    // 'once' skips validation until a memory argument's dtype changes
+    const bool skipValidation = (
+      (typeValidation == typeValidationMode::once)
+      && argTypesValidated
+      && !argTypesChanged()
+    );
+    if (!skipValidation) {
+      validateArguments();
+    }
+
     for (int i = 0; i < argc; ++i) {
       kernelArgData &arg = arguments[i];
-      modeMemory_t *mem = arg.getModeMemory();
-      if (mem) {
-        arg.setupForKernelCall(false);
+      if (arg.modeMemory) {
+        arg.setupForKernelCall(argValidations[i].isConst);
       }
     }
   }
@@ -306,6 +401,13 @@ namespace occa {
   void kernel::run() const {
     assertInitialized();
 
+    // Record the launch instead of running it
+    graph_t *captureGraph = modeKernel->modeDevice->getCaptureGraph();
+    if (captureGraph) {
+      captureGraph->addLaunch(boundKernel(*this));
+      return;
+    }
+
     modeKernel->setupRun();
     modeKernel->run();
   }
@@ -320,6 +422,126 @@ namespace occa {
   //====================================
 
 
+  //---[ boundKernel ]------------------
+  boundKernel::boundKernel() {}
+
+  boundKernel::boundKernel(const occa::kernel &kernel__,
+                           const kernelArg **args,
+                           const int count) :
+    kernel_(kernel__) {
+    // Reuse the regular launch checks to resolve and validate arguments
+    kernel_.getModeKernel()->setArguments(args, count);
+    bindArguments();
+  }
+
+  boundKernel::boundKernel(const occa::kernel &kernel__) :
+    kernel_(kernel__) {
+    bindArguments();
+  }
+
+  void boundKernel::bindArguments() {
+    modeKernel_t *modeKernel = kernel_.getModeKernel();
+
+    if (!modeKernel->argValidationIsSetup) {
+      modeKernel->setupArgValidation();
+    }
+    const bool validateTypes = (
+      modeKernel->typeValidation != typeValidationMode::none
+    );
+    if (validateTypes) {
+      modeKernel->validateArguments();
+    }
+
+    arguments = modeKernel->arguments;
+
+    // Only managed memory in a separate memory space needs per-launch setup
+    const int argc = (int) arguments.size();
+    for (int i = 0; i < argc; ++i) {
+      modeMemory_t *mem = arguments[i].modeMemory;
+      if (!mem) {
+        continue;
+      }
+      memoryArgs.push_back(i);
+      memoryRefs.push_back(occa::memory(mem));
+
+      if (!mem->isManaged()
+          || !mem->modeDevice->hasSeparateMemorySpace()) {
+        continue;
+      }
+      managedArgs.push_back(i);
+      managedArgIsConst.push_back(
+        validateTypes && modeKernel->argValidations[i].isConst
+      );
+    }
+  }
+
+  bool boundKernel::isInitialized() const {
+    return kernel_.getModeKernel() != NULL;
+  }
+
+  occa::kernel boundKernel::getKernel() const {
+    return kernel_;
+  }
+
+  int boundKernel::argumentCount() const {
+    return (int) arguments.size();
+  }
+
+  void boundKernel::setArg(const int index,
+                           const kernelArg &arg) {
+    const int argc = (int) arguments.size();
+    OCCA_ERROR("(" << kernel_.name() << ") Bound argument index ["
+               << index << "] is out of range [0, " << argc << ")",
+               (0 <= index) && (index < argc));
+
+    kernelArgData &boundArg = arguments[index];
+    OCCA_ERROR("(" << kernel_.name() << ") Only scalar arguments can be updated,"
+               " re-bind the kernel to change memory arguments",
+               (arg.size() == 1)
+               && !arg[0].modeMemory
+               && !arg[0].isNull()
+               && !boundArg.modeMemory
+               && !boundArg.isNull());
+    OCCA_ERROR("(" << kernel_.name() << ") Bound argument [" << (index + 1)
+               << "] expects [" << boundArg.size << "] bytes,"
+               << " received [" << arg[0].size << ']',
+               arg[0].size == boundArg.size);
+
+    boundArg = arg[0];
+  }
+
+  void boundKernel::run() const {
+    modeKernel_t *modeKernel = kernel_.getModeKernel();
+    OCCA_ERROR("Bound kernel not initialized or has been freed",
+               modeKernel != NULL);
+
+    // Freed memory NULLs its wrappers, including the ones we hold
+    const int memoryCount = (int) memoryArgs.size();
+    for (int i = 0; i < memoryCount; ++i) {
+      OCCA_ERROR("(" << modeKernel->name << ") Bound memory argument ["
+                 << (memoryArgs[i] + 1) << "] has been freed",
+                 memoryRefs[i].isInitialized());
+    }
+
+    // Assignment keeps the kernel's argument buffer capacity
+    modeKernel->arguments = arguments;
+
+    const int managedCount = (int) managedArgs.size();
+    for (int i = 0; i < managedCount; ++i) {
+      modeKernel->arguments[managedArgs[i]].setupForKernelCall(
+        managedArgIsConst[i]
+      );
+    }
+
+    modeKernel->run();
+  }
+
+  void boundKernel::operator () () const {
+    run();
+  }
+  //====================================
+
+
   //---[ Kernel Properties ]------------
   // Properties:
   //   defines       : Object
@@ -18,7 +18,12 @@ namespace occa {
       modeMemory(other.modeMemory),
       data(other.data),
       size(other.size),
-      info(other.info) {}
+      info(other.info),
+      ownedData(other.ownedData) {
+    if (ownedData.size()) {
+      data.void_ = &(ownedData[0]);
+    }
+  }
 
   kernelArgData& kernelArgData::operator = (const kernelArgData &other) {
     modeMemory = other.modeMemory;
@@ -27,6 +32,11 @@ namespace occa {
     size = other.size;
     info = other.info;
 
+    ownedData = other.ownedData;
+    if (ownedData.size()) {
+      data.void_ = &(ownedData[0]);
+    }
+
     return *this;
   }
 
@@ -58,6 +68,15 @@ namespace occa {
     return (info & kArgInfo::isNull);
   }
 
+  void kernelArgData::setOwnedData(const void *src,
+                                   const udim_t bytes) {
+    ownedData.assign((const char*) src,
+                     (const char*) src + bytes);
+    data.void_ = &(ownedData[0]);
+    size = bytes;
+    info = kArgInfo::usePointer;
+  }
+
   void kernelArgData::setupForKernelCall(const bool isConst) const {
     if (!modeMemory              ||
         !modeMemory->isManaged() ||
@@ -65,7 +84,7 @@ namespace occa {
       return;
     }
     if (!modeMemory->inDevice()) {
-      modeMemory->copyFrom(modeMemory->uvaPtr, modeMemory->size);
+      syncDirtyRanges(modeMemory, true);
       modeMemory->memInfo |= uvaFlag::inDevice;
     }
     if (!isConst && !modeMemory->isStale()) {
@@ -74,6 +93,41 @@ namespace occa {
     }
   }
 
+  kArgVector::kArgVector() :
+    argCount(0) {}
+
+  int kArgVector::size() const {
+    return argCount;
+  }
+
+  kernelArgData& kArgVector::operator [] (const int index) {
+    if (index < inlineCapacity) {
+      return inlineArgs[index];
+    }
+    return heapArgs[index - inlineCapacity];
+  }
+
+  const kernelArgData& kArgVector::operator [] (const int index) const {
+    if (index < inlineCapacity) {
+      return inlineArgs[index];
+    }
+    return heapArgs[index - inlineCapacity];
+  }
+
+  void kArgVector::push_back(const kernelArgData &arg) {
+    if (argCount < inlineCapacity) {
+      inlineArgs[argCount] = arg;
+    } else {
+      heapArgs.push_back(arg);
+    }
+    ++argCount;
+  }
+
+  void kArgVector::clear() {
+    argCount = 0;
+    heapArgs.clear();
+  }
+
   kernelArg::kernelArg() {}
   kernelArg::~kernelArg() {}
 
@@ -104,11 +158,11 @@ namespace occa {
   }
 
   int kernelArg::size() const {
-    return (int) args.size();
+    return args.size();
   }
 
   device kernelArg::getDevice() const {
-    const int argCount = (int) args.size();
+    const int argCount = args.size();
 
     for (int i = 0; i < argCount; ++i) {
       const kernelArgData &arg = args[i];
@@ -206,7 +260,7 @@ namespace occa {
   }
 
   void kernelArg::add(const kernelArg &arg) {
-    const int newArgs = (int) arg.args.size();
+    const int newArgs = arg.args.size();
     for (int i = 0; i < newArgs; ++i) {
       args.push_back(arg.args[i]);
     }
@@ -224,10 +278,7 @@ namespace occa {
     if (argIsUva) {
       modeMemory = (modeMemory_t*) arg;
     } else if (lookAtUva) {
-      ptrRangeMap::iterator it = uvaMap.find(arg);
-      if (it != uvaMap.end()) {
-        modeMemory = it->second;
-      }
+      modeMemory = uvaMap.find(arg);
     }
 
     if (modeMemory) {
@@ -241,6 +292,12 @@ namespace occa {
     }
   }
 
+  void kernelArg::addValue(const void *arg, size_t bytes) {
+    kernelArgData kArg;
+    kArg.setOwnedData(arg, bytes);
+    args.push_back(kArg);
+  }
+
   int kernelArg::argumentCount(const std::vector<kernelArg> &arguments) {
     const int kArgCount = (int) arguments.size();
     int argc = 0;
@@ -91,6 +91,37 @@ namespace occa {
     return build(device, hash(device));
   }
 
+  void kernelBuilder::buildAll(occa::device device,
+                               const std::vector<kernelBuilder*> &builders) {
+    const hash_t deviceHash = hash(device);
+    const int builderCount = (int) builders.size();
+
+    // Submit all builds before waiting on any of them
+    std::vector<kernelFuture> futures(builderCount);
+    for (int i = 0; i < builderCount; ++i) {
+      kernelBuilder &builder = *(builders[i]);
+      hashedKernelMapIterator it = builder.kernelMap.find(deviceHash);
+      if ((it != builder.kernelMap.end()) && it->second.isInitialized()) {
+        continue;
+      }
+      if (builder.buildingFromFile) {
+        futures[i] = device.buildKernelAsync(builder.source_,
+                                             builder.function_,
+                                             builder.defaultProps);
+      } else {
+        futures[i] = device.buildKernelFromStringAsync(builder.source_,
+                                                       builder.function_,
+                                                       builder.defaultProps);
+      }
+    }
+
+    for (int i = 0; i < builderCount; ++i) {
+      if (futures[i].isInitialized()) {
+        builders[i]->kernelMap[deviceHash] = futures[i].get();
+      }
+    }
+  }
+
   void kernelBuilder::run(occa::scope &scope) {
     occa::kernel kernel = build(scope.getDevice(),
                                 scope.props);
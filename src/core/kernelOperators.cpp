@@ -10,8 +10,8 @@ void kernel::operator() () const {
 
 void kernel::operator() (const kernelArg &arg1) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1
+  const kernelArg *args[] = {
+    &arg1
   };
   modeKernel->setArguments(args, 1);
   run();
@@ -19,8 +19,8 @@ void kernel::operator() (const kernelArg &arg1) const {
 
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2
+  const kernelArg *args[] = {
+    &arg1, &arg2
   };
   modeKernel->setArguments(args, 2);
   run();
@@ -28,8 +28,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2) const {
 
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3
   };
   modeKernel->setArguments(args, 3);
   run();
@@ -37,8 +37,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4
   };
   modeKernel->setArguments(args, 4);
   run();
@@ -46,8 +46,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5
   };
   modeKernel->setArguments(args, 5);
   run();
@@ -56,8 +56,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
                          const kernelArg &arg6) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6
   };
   modeKernel->setArguments(args, 6);
   run();
@@ -66,8 +66,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
                          const kernelArg &arg6, const kernelArg &arg7) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7
   };
   modeKernel->setArguments(args, 7);
   run();
@@ -76,8 +76,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8
   };
   modeKernel->setArguments(args, 8);
   run();
@@ -86,8 +86,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9
   };
   modeKernel->setArguments(args, 9);
   run();
@@ -96,8 +96,8 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
 void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10
   };
   modeKernel->setArguments(args, 10);
   run();
@@ -107,9 +107,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
                          const kernelArg &arg11) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11
   };
   modeKernel->setArguments(args, 11);
   run();
@@ -119,9 +119,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
                          const kernelArg &arg11, const kernelArg &arg12) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12
   };
   modeKernel->setArguments(args, 12);
   run();
@@ -131,9 +131,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13
   };
   modeKernel->setArguments(args, 13);
   run();
@@ -143,9 +143,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14
   };
   modeKernel->setArguments(args, 14);
   run();
@@ -155,9 +155,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15
   };
   modeKernel->setArguments(args, 15);
   run();
@@ -168,9 +168,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
                          const kernelArg &arg16) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16
   };
   modeKernel->setArguments(args, 16);
   run();
@@ -181,9 +181,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
                          const kernelArg &arg16, const kernelArg &arg17) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17
   };
   modeKernel->setArguments(args, 17);
   run();
@@ -194,9 +194,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18
   };
   modeKernel->setArguments(args, 18);
   run();
@@ -207,9 +207,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19
   };
   modeKernel->setArguments(args, 19);
   run();
@@ -220,9 +220,9 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20
   };
   modeKernel->setArguments(args, 20);
   run();
@@ -234,10 +234,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
                          const kernelArg &arg21) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21
   };
   modeKernel->setArguments(args, 21);
   run();
@@ -249,10 +249,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
                          const kernelArg &arg21, const kernelArg &arg22) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22
   };
   modeKernel->setArguments(args, 22);
   run();
@@ -264,10 +264,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23
   };
   modeKernel->setArguments(args, 23);
   run();
@@ -279,10 +279,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24
   };
   modeKernel->setArguments(args, 24);
   run();
@@ -294,10 +294,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25
   };
   modeKernel->setArguments(args, 25);
   run();
@@ -310,10 +310,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
                          const kernelArg &arg26) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26
   };
   modeKernel->setArguments(args, 26);
   run();
@@ -326,10 +326,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
                          const kernelArg &arg26, const kernelArg &arg27) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27
   };
   modeKernel->setArguments(args, 27);
   run();
@@ -342,10 +342,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28
   };
   modeKernel->setArguments(args, 28);
   run();
@@ -358,10 +358,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29
   };
   modeKernel->setArguments(args, 29);
   run();
@@ -374,10 +374,10 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30
   };
   modeKernel->setArguments(args, 30);
   run();
@@ -391,11 +391,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
                          const kernelArg &arg31) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31
   };
   modeKernel->setArguments(args, 31);
   run();
@@ -409,11 +409,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
                          const kernelArg &arg31, const kernelArg &arg32) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32
   };
   modeKernel->setArguments(args, 32);
   run();
@@ -427,11 +427,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33
   };
   modeKernel->setArguments(args, 33);
   run();
@@ -445,11 +445,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34
   };
   modeKernel->setArguments(args, 34);
   run();
@@ -463,11 +463,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35
   };
   modeKernel->setArguments(args, 35);
   run();
@@ -482,11 +482,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
                          const kernelArg &arg36) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36
   };
   modeKernel->setArguments(args, 36);
   run();
@@ -501,11 +501,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
                          const kernelArg &arg36, const kernelArg &arg37) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37
   };
   modeKernel->setArguments(args, 37);
   run();
@@ -520,11 +520,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38
   };
   modeKernel->setArguments(args, 38);
   run();
@@ -539,11 +539,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39
   };
   modeKernel->setArguments(args, 39);
   run();
@@ -558,11 +558,11 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40
   };
   modeKernel->setArguments(args, 40);
   run();
@@ -578,12 +578,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
                          const kernelArg &arg41) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41
   };
   modeKernel->setArguments(args, 41);
   run();
@@ -599,12 +599,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
                          const kernelArg &arg41, const kernelArg &arg42) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42
   };
   modeKernel->setArguments(args, 42);
   run();
@@ -620,12 +620,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43
   };
   modeKernel->setArguments(args, 43);
   run();
@@ -641,12 +641,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44
   };
   modeKernel->setArguments(args, 44);
   run();
@@ -662,12 +662,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44, arg45
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45
   };
   modeKernel->setArguments(args, 45);
   run();
@@ -684,12 +684,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
                          const kernelArg &arg46) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44, arg45, arg46
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46
   };
   modeKernel->setArguments(args, 46);
   run();
@@ -706,12 +706,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
                          const kernelArg &arg46, const kernelArg &arg47) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44, arg45, arg46, arg47
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47
   };
   modeKernel->setArguments(args, 47);
   run();
@@ -728,12 +728,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
                          const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44, arg45, arg46, arg47, arg48
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47, &arg48
   };
   modeKernel->setArguments(args, 48);
   run();
@@ -750,12 +750,12 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
                          const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44, arg45, arg46, arg47, arg48, arg49
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47, &arg48, &arg49
   };
   modeKernel->setArguments(args, 49);
   run();
@@ -772,14 +772,744 @@ void kernel::operator() (const kernelArg &arg1, const kernelArg &arg2, const ker
                          const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
                          const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49, const kernelArg &arg50) const {
   assertInitialized();
-  kernelArg args[] = {
-    arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8, arg9, arg10,
-    arg11, arg12, arg13, arg14, arg15, arg16, arg17, arg18, arg19, arg20,
-    arg21, arg22, arg23, arg24, arg25, arg26, arg27, arg28, arg29, arg30,
-    arg31, arg32, arg33, arg34, arg35, arg36, arg37, arg38, arg39, arg40,
-    arg41, arg42, arg43, arg44, arg45, arg46, arg47, arg48, arg49, arg50
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47, &arg48, &arg49, &arg50
   };
   modeKernel->setArguments(args, 50);
   run();
 }
 
+boundKernel kernel::bind() const {
+  assertInitialized();
+  return boundKernel(*this, NULL, 0);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1
+  };
+  return boundKernel(*this, args, 1);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2
+  };
+  return boundKernel(*this, args, 2);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3
+  };
+  return boundKernel(*this, args, 3);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4
+  };
+  return boundKernel(*this, args, 4);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5
+  };
+  return boundKernel(*this, args, 5);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6
+  };
+  return boundKernel(*this, args, 6);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7
+  };
+  return boundKernel(*this, args, 7);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8
+  };
+  return boundKernel(*this, args, 8);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9
+  };
+  return boundKernel(*this, args, 9);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10
+  };
+  return boundKernel(*this, args, 10);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11
+  };
+  return boundKernel(*this, args, 11);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12
+  };
+  return boundKernel(*this, args, 12);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13
+  };
+  return boundKernel(*this, args, 13);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14
+  };
+  return boundKernel(*this, args, 14);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15
+  };
+  return boundKernel(*this, args, 15);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16
+  };
+  return boundKernel(*this, args, 16);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17
+  };
+  return boundKernel(*this, args, 17);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18
+  };
+  return boundKernel(*this, args, 18);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19
+  };
+  return boundKernel(*this, args, 19);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20
+  };
+  return boundKernel(*this, args, 20);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21
+  };
+  return boundKernel(*this, args, 21);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22
+  };
+  return boundKernel(*this, args, 22);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23
+  };
+  return boundKernel(*this, args, 23);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24
+  };
+  return boundKernel(*this, args, 24);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25
+  };
+  return boundKernel(*this, args, 25);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26
+  };
+  return boundKernel(*this, args, 26);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27
+  };
+  return boundKernel(*this, args, 27);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28
+  };
+  return boundKernel(*this, args, 28);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29
+  };
+  return boundKernel(*this, args, 29);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30
+  };
+  return boundKernel(*this, args, 30);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31
+  };
+  return boundKernel(*this, args, 31);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32
+  };
+  return boundKernel(*this, args, 32);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33
+  };
+  return boundKernel(*this, args, 33);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34
+  };
+  return boundKernel(*this, args, 34);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35
+  };
+  return boundKernel(*this, args, 35);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36
+  };
+  return boundKernel(*this, args, 36);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37
+  };
+  return boundKernel(*this, args, 37);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38
+  };
+  return boundKernel(*this, args, 38);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39
+  };
+  return boundKernel(*this, args, 39);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40
+  };
+  return boundKernel(*this, args, 40);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41
+  };
+  return boundKernel(*this, args, 41);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42
+  };
+  return boundKernel(*this, args, 42);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43
+  };
+  return boundKernel(*this, args, 43);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44
+  };
+  return boundKernel(*this, args, 44);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45
+  };
+  return boundKernel(*this, args, 45);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                         const kernelArg &arg46) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46
+  };
+  return boundKernel(*this, args, 46);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                         const kernelArg &arg46, const kernelArg &arg47) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47
+  };
+  return boundKernel(*this, args, 47);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                         const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47, &arg48
+  };
+  return boundKernel(*this, args, 48);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                         const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47, &arg48, &arg49
+  };
+  return boundKernel(*this, args, 49);
+}
+
+boundKernel kernel::bind(const kernelArg &arg1, const kernelArg &arg2, const kernelArg &arg3, const kernelArg &arg4, const kernelArg &arg5,
+                         const kernelArg &arg6, const kernelArg &arg7, const kernelArg &arg8, const kernelArg &arg9, const kernelArg &arg10,
+                         const kernelArg &arg11, const kernelArg &arg12, const kernelArg &arg13, const kernelArg &arg14, const kernelArg &arg15,
+                         const kernelArg &arg16, const kernelArg &arg17, const kernelArg &arg18, const kernelArg &arg19, const kernelArg &arg20,
+                         const kernelArg &arg21, const kernelArg &arg22, const kernelArg &arg23, const kernelArg &arg24, const kernelArg &arg25,
+                         const kernelArg &arg26, const kernelArg &arg27, const kernelArg &arg28, const kernelArg &arg29, const kernelArg &arg30,
+                         const kernelArg &arg31, const kernelArg &arg32, const kernelArg &arg33, const kernelArg &arg34, const kernelArg &arg35,
+                         const kernelArg &arg36, const kernelArg &arg37, const kernelArg &arg38, const kernelArg &arg39, const kernelArg &arg40,
+                         const kernelArg &arg41, const kernelArg &arg42, const kernelArg &arg43, const kernelArg &arg44, const kernelArg &arg45,
+                         const kernelArg &arg46, const kernelArg &arg47, const kernelArg &arg48, const kernelArg &arg49, const kernelArg &arg50) const {
+  assertInitialized();
+  const kernelArg *args[] = {
+    &arg1, &arg2, &arg3, &arg4, &arg5, &arg6, &arg7, &arg8, &arg9, &arg10,
+    &arg11, &arg12, &arg13, &arg14, &arg15, &arg16, &arg17, &arg18, &arg19, &arg20,
+    &arg21, &arg22, &arg23, &arg24, &arg25, &arg26, &arg27, &arg28, &arg29, &arg30,
+    &arg31, &arg32, &arg33, &arg34, &arg35, &arg36, &arg37, &arg38, &arg39, &arg40,
+    &arg41, &arg42, &arg43, &arg44, &arg45, &arg46, &arg47, &arg48, &arg49, &arg50
+  };
+  return boundKernel(*this, args, 50);
+}
+
@@ -1,6 +1,7 @@
 #include <map>
 
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/core/launchedDevice.hpp>
 #include <occa/core/launchedKernel.hpp>
 #include <occa/lang/primitive.hpp>
@@ -20,7 +21,10 @@ namespace occa {
                                        lang::sourceMetadata_t &launcherMetadata,
                                        lang::sourceMetadata_t &deviceMetadata) {
     lang::okl::withLauncher &parser = *(createParser(kernelProps));
-    parser.parseFile(filename);
+    {
+      buildStats::stageTimer timer(buildStage::parsing);
+      parser.parseFile(filename);
+    }
 
     // Verify if parsing succeeded
     if (!parser.succeeded()) {
@@ -31,6 +35,7 @@ namespace occa {
       return false;
     }
 
+    buildStats::stageTimer timer(buildStage::codegen);
     if (!io::isFile(outputFile)) {
       hash_t hash = occa::hash(outputFile);
       io::lock_t lock(hash, "device-parser-device");
@@ -95,10 +100,7 @@ namespace occa {
     const std::string binaryFilename = hashDir + kc::binaryFile;
 
     // Check if binary exists and is finished
-    bool foundBinary = (
-      io::cachedFileIsComplete(hashDir, kc::binaryFile)
-      && io::isFile(binaryFilename)
-    );
+    bool foundBinary = io::cachedFileIsComplete(hashDir, kc::binaryFile);
 
     io::lock_t lock;
     if (!foundBinary) {
@@ -108,6 +110,7 @@ namespace occa {
 
     const bool verbose = kernelProps.get("verbose", false);
     if (foundBinary) {
+      buildStats::addDiskCacheHit();
       if (verbose) {
         io::stdout << "Loading cached ["
                    << kernelName
@@ -188,6 +191,7 @@ namespace occa {
       );
     }
 
+    buildStats::addCacheMiss();
     modeKernel_t *k = buildKernelFromProcessedSource(kernelHash,
                                                      hashDir,
                                                      kernelName,
@@ -205,6 +209,54 @@ namespace occa {
     return k;
   }
 
+  bool launchedModeDevice_t::buildKernels(const std::string &filename,
+                                          const hash_t kernelHash,
+                                          const occa::properties &kernelProps,
+                                          std::vector<modeKernel_t*> &kernels) {
+    OCCA_ERROR("Only OKL sources can be built without a kernel name",
+               kernelProps.get("okl/enabled", true));
+
+    const std::string hashDir = io::hashDir(filename, kernelHash);
+    const std::string launcherBuildFile = hashDir + kc::launcherBuildFile;
+
+    lang::sourceMetadata_t launcherMetadata;
+    if (io::isFile(launcherBuildFile)) {
+      launcherMetadata = lang::sourceMetadata_t::fromBuildFile(launcherBuildFile);
+    } else {
+      // Find the kernel names, buildKernel() reuses the transformed sources
+      lang::sourceMetadata_t deviceMetadata;
+      const std::string sourceFilename = (
+        io::cacheFile(filename,
+                      kc::cppRawSourceFile,
+                      kernelHash,
+                      assembleKernelHeader(kernelProps))
+      );
+      bool valid = parseFile(sourceFilename,
+                             hashDir + kc::sourceFile,
+                             hashDir + kc::launcherSourceFile,
+                             kernelProps,
+                             launcherMetadata,
+                             deviceMetadata);
+      if (!valid) {
+        return false;
+      }
+    }
+
+    lang::kernelMetadataMap &kernelsMetadata = launcherMetadata.kernelsMetadata;
+    lang::kernelMetadataMap::iterator it = kernelsMetadata.begin();
+    while (it != kernelsMetadata.end()) {
+      modeKernel_t *k = buildKernel(filename,
+                                    it->first,
+                                    kernelHash,
+                                    kernelProps);
+      if (k) {
+        kernels.push_back(k);
+      }
+      ++it;
+    }
+    return true;
+  }
+
   modeKernel_t* launchedModeDevice_t::buildLauncherKernel(
     const hash_t kernelHash,
     const std::string &hashDir,
@@ -37,20 +37,27 @@ namespace occa {
   }
 
   void launchedModeKernel_t::launcherRun() const {
+    // Write directly into the launcher's argument buffer to avoid
+    //   building a temporary kernelArg on every launch
+    std::vector<kernelArgData> &launcherArgs = launcherKernel->arguments;
+    launcherArgs.clear();
+
     // Add the kernel array as the first argument
-    kernelArg launcherArgs(&(deviceKernels[0]));
+    launcherArgs.push_back(
+      kernelArg(&(deviceKernels[0]))[0]
+    );
 
     const int argCount = (int) arguments.size();
     for (int i = 0; i < argCount; ++i) {
       const kernelArgData &arg = arguments[i];
       if (arg.modeMemory) {
-        launcherArgs.add((void*) arg.modeMemory);
+        launcherArgs.push_back(
+          kernelArg((void*) arg.modeMemory)[0]
+        );
       } else {
-        launcherArgs.add(arg);
+        launcherArgs.push_back(arg);
       }
     }
-    launcherKernel->arguments = launcherArgs.args;
-
 
     int kernelCount = (int) deviceKernels.size();
     for (int i = 0; i < kernelCount; ++i) {
@@ -3,6 +3,7 @@
 #include <occa/core/base.hpp>
 #include <occa/core/memory.hpp>
 #include <occa/core/device.hpp>
+#include <occa/core/graph.hpp>
 #include <occa/modes/serial/memory.hpp>
 #include <occa/tools/uva.hpp>
 #include <occa/tools/sys.hpp>
@@ -19,17 +20,17 @@ namespace occa {
     modeDevice(modeDevice_),
     dtype_(&dtype::byte),
     size(size_),
-    isOrigin(true) {
+    isOrigin(true),
+    isPooled(false) {
     modeDevice->addMemoryRef(this);
   }
 
   modeMemory_t::~modeMemory_t() {
-    // NULL all wrappers
-    while (memoryRing.head) {
-      memory *mem = (memory*) memoryRing.head;
-      memoryRing.removeRef(mem);
-      mem->modeMemory = NULL;
+    // Deleted outside the pool, such as on device teardown
+    if (isPooled && modeDevice) {
+      modeDevice->memoryPool.remove(this);
     }
+    removeMemoryRefs();
     // Remove ref from device
     if (modeDevice) {
       modeDevice->removeMemoryRef(this);
@@ -56,6 +57,14 @@ namespace occa {
     return memoryRing.needsFree();
   }
 
+  void modeMemory_t::removeMemoryRefs() {
+    while (memoryRing.head) {
+      memory *mem = (memory*) memoryRing.head;
+      memoryRing.removeRef(mem);
+      mem->modeMemory = NULL;
+    }
+  }
+
   bool modeMemory_t::isManaged() const {
     return (memInfo & uvaFlag::isManaged);
   }
@@ -76,9 +85,9 @@ namespace occa {
 
   memory::memory(void *uvaPtr) :
       modeMemory(NULL) {
-    ptrRangeMap::iterator it = uvaMap.find(uvaPtr);
-    if (it != uvaMap.end()) {
-      setModeMemory(it->second);
+    modeMemory_t *uvaMemory = uvaMap.find(uvaPtr);
+    if (uvaMemory) {
+      setModeMemory(uvaMemory);
     } else {
       setModeMemory((modeMemory_t*) uvaPtr);
     }
@@ -262,12 +271,12 @@ namespace occa {
     range.start = modeMemory->uvaPtr;
     range.end   = (range.start + modeMemory->size);
 
-    uvaMap[range] = modeMemory;
-    modeMemory->modeDevice->uvaMap[range] = modeMemory;
+    uvaMap.insert(range, modeMemory);
+    modeMemory->modeDevice->uvaMap.insert(range, modeMemory);
 
     // Needed for kernelArg.void_ -> modeMemory checks
     if (modeMemory->uvaPtr != modeMemory->ptr) {
-      uvaMap[modeMemory->ptr] = modeMemory;
+      uvaMap.insert(modeMemory->ptr, modeMemory);
     }
   }
 
@@ -306,7 +315,12 @@ namespace occa {
       return;
     }
 
-    copyFrom(modeMemory->uvaPtr, bytes_, offset);
+    if (bytes_ == modeMemory->size) {
+      syncDirtyRanges(modeMemory, true);
+    } else {
+      copyFrom(modeMemory->uvaPtr + offset, bytes_, offset);
+      modeMemory->dirtyRanges.remove(offset, bytes_);
+    }
 
     modeMemory->memInfo |=  uvaFlag::inDevice;
     modeMemory->memInfo &= ~uvaFlag::isStale;
@@ -337,7 +351,12 @@ namespace occa {
       return;
     }
 
-    copyTo(modeMemory->uvaPtr, bytes_, offset);
+    if (bytes_ == modeMemory->size) {
+      syncDirtyRanges(modeMemory, false);
+    } else {
+      copyTo(modeMemory->uvaPtr + offset, bytes_, offset);
+      modeMemory->dirtyRanges.remove(offset, bytes_);
+    }
 
     modeMemory->memInfo &= ~uvaFlag::inDevice;
     modeMemory->memInfo &= ~uvaFlag::isStale;
@@ -345,6 +364,28 @@ namespace occa {
     removeFromStaleMap(modeMemory);
   }
 
+  void memory::markDirty(const dim_t bytes,
+                         const dim_t offset) {
+    if (!modeMemory
+        || !(modeMemory->memInfo & uvaFlag::tracksDirty)) {
+      return;
+    }
+    const udim_t bytes_ = ((bytes == -1) ? modeMemory->size : bytes);
+
+    OCCA_ERROR("Memory has size [" << modeMemory->size << "],"
+               << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
+               (offset >= 0) && ((bytes_ + offset) <= modeMemory->size));
+
+    modeMemory->dirtyRanges.add(offset, bytes_, modeMemory->size);
+  }
+
+  const dirtyRanges_t& memory::dirtyRanges() const {
+    static const dirtyRanges_t noRanges;
+    return (modeMemory
+            ? modeMemory->dirtyRanges
+            : noRanges);
+  }
+
   bool memory::uvaIsStale() const {
     return (modeMemory && modeMemory->isStale());
   }
@@ -430,6 +471,15 @@ namespace occa {
                << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
                (bytes_ + offset) <= modeMemory->size);
 
+    graph_t *captureGraph = modeMemory->modeDevice->getCaptureGraph();
+    if (captureGraph) {
+      captureGraph->addCopy(*this, memory(),
+                            NULL, src,
+                            bytes_, offset, 0,
+                            props);
+      return;
+    }
+
     modeMemory->copyFrom(src, bytes_, offset, props);
   }
 
@@ -459,6 +509,15 @@ namespace occa {
                << " trying to access [" << destOffset << ", " << (destOffset + bytes_) << "]",
                (bytes_ + destOffset) <= modeMemory->size);
 
+    graph_t *captureGraph = modeMemory->modeDevice->getCaptureGraph();
+    if (captureGraph) {
+      captureGraph->addCopy(*this, src,
+                            NULL, NULL,
+                            bytes_, destOffset, srcOffset,
+                            props);
+      return;
+    }
+
     modeMemory->copyFrom(src.modeMemory, bytes_, destOffset, srcOffset, props);
   }
 
@@ -480,6 +539,15 @@ namespace occa {
                << " trying to access [" << offset << ", " << (offset + bytes_) << "]",
                (bytes_ + offset) <= modeMemory->size);
 
+    graph_t *captureGraph = modeMemory->modeDevice->getCaptureGraph();
+    if (captureGraph) {
+      captureGraph->addCopy(memory(), *this,
+                            dest, NULL,
+                            bytes_, 0, offset,
+                            props);
+      return;
+    }
+
     modeMemory->copyTo(dest, bytes_, offset, props);
   }
 
@@ -509,6 +577,15 @@ namespace occa {
                << " trying to access [" << destOffset << ", " << (destOffset + bytes_) << "]",
                (bytes_ + destOffset) <= dest.modeMemory->size);
 
+    graph_t *captureGraph = modeMemory->modeDevice->getCaptureGraph();
+    if (captureGraph) {
+      captureGraph->addCopy(dest, *this,
+                            NULL, NULL,
+                            bytes_, destOffset, srcOffset,
+                            props);
+      return;
+    }
+
     dest.modeMemory->copyFrom(modeMemory, bytes_, destOffset, srcOffset, props);
   }
 
@@ -566,6 +643,14 @@ namespace occa {
     if (modeMemory->isOrigin) {
       modeDevice->bytesAllocated -= (modeMemory->size);
 
+      // Pooled blocks are kept for reuse, UVA pointers aren't reused
+      if (freeMemory
+          && !modeMemory->uvaPtr
+          && modeDevice->memoryPool.free(modeMemory)) {
+        modeMemory = NULL;
+        return;
+      }
+
       if (modeMemory->uvaPtr) {
         void *memPtr = modeMemory->ptr;
         void *uvaPtr = modeMemory->uvaPtr;
@@ -582,6 +667,11 @@ namespace occa {
         }
       }
 
+      // Detached or UVA blocks leave the pool
+      if (modeMemory->isPooled) {
+        modeDevice->memoryPool.remove(modeMemory);
+      }
+
       if (!freeMemory) {
         modeMemory->detach();
       }
@@ -0,0 +1,202 @@
+#include <occa/core/device.hpp>
+#include <occa/core/memory.hpp>
+#include <occa/core/memoryPool.hpp>
+#include <occa/core/stream.hpp>
+#include <occa/tools/properties.hpp>
+#include <occa/tools/string.hpp>
+
+namespace occa {
+  namespace {
+    udim_t getPoolMaxBytes(const occa::properties &props) {
+      const json &maxBytes = props["pool_max_bytes"];
+      if (maxBytes.isString()) {
+        return parseBytes(maxBytes.string());
+      }
+      if (maxBytes.isNumber()) {
+        const double bytes = (double) maxBytes;
+        return (bytes > 0) ? (udim_t) bytes : 0;
+      }
+      return 0;
+    }
+
+    // Waits on work queued in [modeStream] which could still use a freed block
+    void finishStream(modeDevice_t *modeDevice,
+                      modeStream_t *modeStream) {
+      stream currentStream = modeDevice->currentStream;
+      modeDevice->currentStream = stream(modeStream);
+      modeDevice->finish();
+      modeDevice->currentStream = currentStream;
+    }
+  }
+
+  memoryPoolStats_t::memoryPoolStats_t() :
+    cachedBytes(0),
+    cachedBlocks(0),
+    reusedBlocks(0),
+    allocatedBlocks(0),
+    releasedBlocks(0) {}
+
+  json memoryPoolStats_t::toJson() const {
+    json j(json::object_);
+    j.set("cached_bytes", (double) cachedBytes);
+    j.set("cached_blocks", (double) cachedBlocks);
+    j.set("reused_blocks", (double) reusedBlocks);
+    j.set("allocated_blocks", (double) allocatedBlocks);
+    j.set("released_blocks", (double) releasedBlocks);
+    return j;
+  }
+
+  //---[ memoryPool_t ]-----------------
+  memoryPool_t::block_t::block_t(modeMemory_t *modeMemory_,
+                                 modeStream_t *modeStream_) :
+    modeMemory(modeMemory_),
+    modeStream(modeStream_) {}
+
+  memoryPool_t::memoryPool_t(modeDevice_t *modeDevice_) :
+    modeDevice(modeDevice_) {}
+
+  udim_t memoryPool_t::sizeClass(const udim_t bytes) {
+    if (bytes <= minBlockBytes) {
+      return minBlockBytes;
+    }
+    // 4 size classes between powers of 2
+    int topBit = 0;
+    for (udim_t b = (bytes - 1); b > 1; b >>= 1) {
+      ++topBit;
+    }
+    const udim_t step = ((udim_t) 1) << (topBit - 2);
+    return step * ((bytes + step - 1) / step);
+  }
+
+  bool memoryPool_t::isEnabled(const occa::properties &props) {
+    // Host pointers belong to the caller
+    return (props.get("pool", false)
+            && !props.get("use_host_pointer", false));
+  }
+
+  modeMemory_t* memoryPool_t::malloc(const udim_t bytes,
+                                     const void *src,
+                                     const occa::properties &props) {
+    const blockKey_t key(sizeClass(bytes), occa::hash(props));
+    modeStream_t *currentStream = modeDevice->currentStream.getModeStream();
+
+    modeMemory_t *modeMemory = NULL;
+    blockMap::iterator it = freeBlocks.find(key);
+    if (it != freeBlocks.end()) {
+      std::vector<block_t> &blocks = it->second;
+
+      // Blocks freed on the current stream are ready to use
+      int index = (int) blocks.size() - 1;
+      for (int i = index; i >= 0; --i) {
+        if (blocks[i].modeStream == currentStream) {
+          index = i;
+          break;
+        }
+      }
+
+      block_t block = blocks[index];
+      blocks.erase(blocks.begin() + index);
+      if (blocks.empty()) {
+        freeBlocks.erase(it);
+      }
+      if (block.modeStream && (block.modeStream != currentStream)) {
+        finishStream(modeDevice, block.modeStream);
+      }
+
+      modeMemory = block.modeMemory;
+      modeMemory->size = bytes;
+      stats.cachedBytes -= key.first;
+      --stats.cachedBlocks;
+      ++stats.reusedBlocks;
+
+      if (src) {
+        modeMemory->copyFrom(src, bytes, 0, props);
+      }
+      return modeMemory;
+    }
+
+    modeMemory = modeDevice->malloc(key.first, NULL, props);
+    modeMemory->size = bytes;
+    modeMemory->isPooled = true;
+    blockKeys[modeMemory] = key;
+    ++stats.allocatedBlocks;
+
+    if (src) {
+      modeMemory->copyFrom(src, bytes, 0, props);
+    }
+    return modeMemory;
+  }
+
+  bool memoryPool_t::free(modeMemory_t *modeMemory) {
+    std::map<modeMemory_t*, blockKey_t>::iterator it = blockKeys.find(modeMemory);
+    if (it == blockKeys.end()) {
+      return false;
+    }
+    const blockKey_t &key = it->second;
+
+    modeMemory->removeMemoryRefs();
+    freeBlocks[key].push_back(
+      block_t(modeMemory,
+              modeDevice->currentStream.getModeStream())
+    );
+    stats.cachedBytes += key.first;
+    ++stats.cachedBlocks;
+
+    const udim_t maxBytes = getPoolMaxBytes(modeMemory->properties);
+    if (maxBytes && (stats.cachedBytes > maxBytes)) {
+      trim(maxBytes);
+    }
+    return true;
+  }
+
+  void memoryPool_t::remove(modeMemory_t *modeMemory) {
+    std::map<modeMemory_t*, blockKey_t>::iterator it = blockKeys.find(modeMemory);
+    if (it == blockKeys.end()) {
+      return;
+    }
+    // Blocks are freed with the size they were allocated with
+    modeMemory->size = it->second.first;
+    modeMemory->isPooled = false;
+    blockKeys.erase(it);
+  }
+
+  void memoryPool_t::trim(const udim_t bytes) {
+    while ((stats.cachedBytes > bytes) && freeBlocks.size()) {
+      // Free the largest blocks first
+      blockMap::iterator it = --freeBlocks.end();
+      std::vector<block_t> &blocks = it->second;
+
+      const udim_t blockBytes = it->first.first;
+      modeMemory_t *modeMemory = blocks.back().modeMemory;
+      blocks.pop_back();
+      if (blocks.empty()) {
+        freeBlocks.erase(it);
+      }
+
+      stats.cachedBytes -= blockBytes;
+      --stats.cachedBlocks;
+      ++stats.releasedBlocks;
+      remove(modeMemory);
+      delete modeMemory;
+    }
+  }
+
+  void memoryPool_t::removeStream(modeStream_t *modeStream) {
+    blockMap::iterator it = freeBlocks.begin();
+    while (it != freeBlocks.end()) {
+      std::vector<block_t> &blocks = it->second;
+      const int blockCount = (int) blocks.size();
+      for (int i = 0; i < blockCount; ++i) {
+        if (blocks[i].modeStream == modeStream) {
+          blocks[i].modeStream = NULL;
+        }
+      }
+      ++it;
+    }
+  }
+
+  const memoryPoolStats_t& memoryPool_t::getStats() const {
+    return stats;
+  }
+  //====================================
+}
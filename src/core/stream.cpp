@@ -1,16 +1,20 @@
 #include <occa/core/stream.hpp>
 #include <occa/core/device.hpp>
+#include <occa/core/graph.hpp>
 
 namespace occa {
   //---[ modeStream_t ]-----------------
   modeStream_t::modeStream_t(modeDevice_t *modeDevice_,
                              const occa::properties &properties_) :
     properties(properties_),
-    modeDevice(modeDevice_) {
+    modeDevice(modeDevice_),
+    captureGraph(NULL) {
     modeDevice->addStreamRef(this);
   }
 
   modeStream_t::~modeStream_t() {
+    delete captureGraph;
+
     // NULL all wrappers
     while (streamRing.head) {
       stream *mem = (stream*) streamRing.head;
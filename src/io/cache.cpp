@@ -1,14 +1,279 @@
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <sys/stat.h>
+#include <sys/types.h>
+
 #include <occa/defines.hpp>
 #include <occa/io/cache.hpp>
+#include <occa/io/cacheIndex.hpp>
 #include <occa/io/lock.hpp>
 #include <occa/io/utils.hpp>
 #include <occa/tools/hash.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/lex.hpp>
 #include <occa/tools/properties.hpp>
+#include <occa/tools/string.hpp>
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+#  include <fcntl.h>
+#  include <sys/file.h>
+#  include <sys/time.h>
+#  include <unistd.h>
+#endif
 
 namespace occa {
   namespace io {
+    namespace {
+      std::mutex accessMutex;
+      std::unordered_set<std::string> accessedDirs;
+
+      bool isCacheEntry(const std::string &hashDir) {
+        const std::string &cPath = cachePath();
+        return ((hashDir.size() > cPath.size())
+                && startsWith(hashDir, cPath));
+      }
+
+      // Last path component of a directory, without the trailing slash
+      std::string dirName(const std::string &dir) {
+        std::string name = dir;
+        if (name.size() && (name[name.size() - 1] == '/')) {
+          name.resize(name.size() - 1);
+        }
+        const size_t slash = name.rfind('/');
+        if (slash != std::string::npos) {
+          name = name.substr(slash + 1);
+        }
+        return name;
+      }
+
+      udim_t directoryBytes(const std::string &dir) {
+        udim_t bytes = 0;
+
+        strVector files = io::files(dir);
+        const int fileCount = (int) files.size();
+        for (int i = 0; i < fileCount; ++i) {
+          struct stat buffer;
+          if (!::stat(files[i].c_str(), &buffer)) {
+            bytes += buffer.st_size;
+          }
+        }
+
+        strVector directories = io::directories(dir);
+        const int dirCount = (int) directories.size();
+        for (int i = 0; i < dirCount; ++i) {
+          bytes += directoryBytes(directories[i]);
+        }
+        return bytes;
+      }
+
+      double modifiedTime(const std::string &path) {
+        struct stat buffer;
+        if (::stat(path.c_str(), &buffer)) {
+          return 0;
+        }
+        return (double) buffer.st_mtime;
+      }
+
+      double age(const double timestamp) {
+        return ::difftime(::time(NULL), (time_t) timestamp);
+      }
+
+      // Maps entry names to their lock directories
+      typedef std::unordered_map<std::string, strVector> lockDirMap;
+
+      lockDirMap getLockDirs() {
+        lockDirMap lockDirs;
+        strVector dirs = io::directories(env::OCCA_CACHE_DIR + "locks/");
+        const int dirCount = (int) dirs.size();
+        for (int i = 0; i < dirCount; ++i) {
+          const std::string name = dirName(dirs[i]);
+          const size_t underscore = name.find('_');
+          if (underscore != std::string::npos) {
+            lockDirs[name.substr(0, underscore)].push_back(dirs[i]);
+          }
+        }
+        return lockDirs;
+      }
+
+      bool hasHeldLock(const strVector &lockDirs) {
+        const int dirCount = (int) lockDirs.size();
+        for (int i = 0; i < dirCount; ++i) {
+          if (lock_t::isHeld(lockDirs[i])) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      bool evictCacheEntry(const cacheEntry_t &entry) {
+        // Entries could have been locked after they were listed
+        lockDirMap lockDirs = getLockDirs();
+        if (hasHeldLock(lockDirs[dirName(entry.hashDir)])) {
+          return false;
+        }
+
+        // Move the entry out of the way first so others never load a partial entry
+        std::string evictedDir = cachePath();
+        evictedDir += ".evicted_";
+        evictedDir += dirName(entry.hashDir);
+        evictedDir += '_';
+        evictedDir += toString(sys::getPID());
+
+        std::string hashDir = entry.hashDir;
+        if (hashDir[hashDir.size() - 1] == '/') {
+          hashDir.resize(hashDir.size() - 1);
+        }
+        if (::rename(hashDir.c_str(), evictedDir.c_str())) {
+          return false;
+        }
+        cacheIndex().removeDir(entry.hashDir);
+        sys::rmdir(evictedDir + "/", true);
+        return true;
+      }
+
+      bool copyFile(const std::string &src,
+                    const std::string &dest) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+        // Cached files are never modified, share them when possible
+        if (!::link(src.c_str(), dest.c_str())) {
+          return true;
+        }
+#endif
+        std::ifstream in(src.c_str(), std::ios::binary);
+        std::ofstream out(dest.c_str(), std::ios::binary);
+        if (!in || !out) {
+          return false;
+        }
+        // Streaming an empty file sets the failbit
+        if (in.peek() != std::ifstream::traits_type::eof()) {
+          out << in.rdbuf();
+        }
+        out.close();
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+        struct stat buffer;
+        if (!::stat(src.c_str(), &buffer)) {
+          ::chmod(dest.c_str(), buffer.st_mode & 0777);
+        }
+#endif
+        return !out.fail();
+      }
+
+      bool copyDirectory(const std::string &src,
+                         const std::string &dest) {
+        sys::mkpath(dest);
+
+        strVector files = io::files(src);
+        const int fileCount = (int) files.size();
+        for (int i = 0; i < fileCount; ++i) {
+          if (!copyFile(files[i], dest + io::basename(files[i]))) {
+            return false;
+          }
+        }
+
+        strVector directories = io::directories(src);
+        const int dirCount = (int) directories.size();
+        for (int i = 0; i < dirCount; ++i) {
+          if (!copyDirectory(directories[i],
+                             dest + dirName(directories[i]) + "/")) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      // Copies [src] into a temporary sibling and renames it into [dest]
+      //   so readers never see a partial copy
+      bool copyDirectoryAtomically(const std::string &src,
+                                   const std::string &dest,
+                                   const std::string &tempPrefix) {
+        std::string destDir = dest;
+        if (destDir[destDir.size() - 1] == '/') {
+          destDir.resize(destDir.size() - 1);
+        }
+        const std::string tempDir = (
+          io::dirname(destDir)
+          + tempPrefix
+          + dirName(destDir)
+          + '_'
+          + toString(sys::getPID())
+        );
+
+        if (copyDirectory(src, tempDir + "/")
+            && !::rename(tempDir.c_str(), destDir.c_str())) {
+          return true;
+        }
+        sys::rmdir(tempDir + "/", true);
+        return false;
+      }
+
+      bool compareLastAccess(const cacheEntry_t &a, const cacheEntry_t &b) {
+        return (a.lastAccess < b.lastAccess);
+      }
+
+      class exitEviction_t {
+      public:
+        std::mutex mutex;
+        bool addedEntries;
+        udim_t maxBytes;
+        int maxEntries;
+        double minAge;
+
+        exitEviction_t() :
+          addedEntries(false),
+          maxBytes(0),
+          maxEntries(0),
+          minAge(0) {
+          // Make sure these are destroyed after the eviction
+          cachePath();
+          cacheIndex();
+        }
+
+        ~exitEviction_t() {
+          if (!addedEntries || (!maxBytes && !maxEntries)) {
+            return;
+          }
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+          // Only one process evicts at a time, others can skip it
+          const std::string gcLockFile = env::OCCA_CACHE_DIR + "locks/cache-gc";
+          const int fd = ::open(gcLockFile.c_str(),
+                                O_RDWR | O_CREAT | O_CLOEXEC,
+                                0644);
+          if (fd < 0) {
+            return;
+          }
+          if (!::flock(fd, LOCK_EX | LOCK_NB)) {
+            evictCacheEntries(maxBytes, maxEntries, minAge);
+          }
+          ::close(fd);
+#else
+          evictCacheEntries(maxBytes, maxEntries, minAge);
+#endif
+        }
+
+        void entryAdded() {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (addedEntries) {
+            return;
+          }
+          // Settings are thread-local and might be gone on exit
+          addedEntries = true;
+          maxBytes = getCacheMaxBytes();
+          maxEntries = getCacheMaxEntries();
+          minAge = getCacheMinAge();
+        }
+      };
+
+      exitEviction_t& exitEviction() {
+        static exitEviction_t eviction;
+        return eviction;
+      }
+    }
+
     bool isCached(const std::string &filename) {
       // Directory, not file
       if (filename.size() == 0) {
@@ -93,15 +358,34 @@ namespace occa {
 
       successFile += filename;
       io::write(successFile, "");
+
+      cacheIndex().markComplete(hashDir, filename);
+
+      if (isCacheEntry(hashDir)) {
+        markCacheAccess(hashDir);
+        exitEviction().entryAdded();
+      }
     }
 
     bool cachedFileIsComplete(const std::string &hashDir,
                               const std::string &filename) {
+      if (cacheIndex().isComplete(hashDir, filename)) {
+        markCacheAccess(hashDir);
+        return true;
+      }
+
+      // Fallback to the directory layout
       std::string successFile = hashDir;
       successFile += ".success/";
       successFile += filename;
 
-      return io::exists(successFile);
+      if (!io::exists(successFile)
+          || !io::isFile(hashDir + filename)) {
+        return false;
+      }
+      cacheIndex().markComplete(hashDir, filename);
+      markCacheAccess(hashDir);
+      return true;
     }
 
     void setBuildProps(occa::json &props) {
@@ -122,5 +406,260 @@ namespace occa {
         info.write(filename);
       }
     }
+
+    void writeBuildStats(const std::string &filename,
+                         const hash_t &hash,
+                         const occa::json &stats) {
+      io::lock_t lock(hash, "kernel-info");
+      if (!lock.isMine() ||
+          !io::isFile(filename)) {
+        return;
+      }
+      occa::json info = occa::json::read(filename);
+      info["build"].set("stats", stats);
+
+      // Readers never see a partially written build file
+      const std::string tempFilename = (
+        filename + ".stats_" + toString(sys::getPID())
+      );
+      info.write(tempFilename);
+      if (::rename(tempFilename.c_str(), filename.c_str())) {
+        std::remove(tempFilename.c_str());
+      }
+    }
+
+    //---[ Cache Eviction ]-------------
+    cacheEntry_t::cacheEntry_t() :
+      bytes(0),
+      lastAccess(0),
+      isComplete(false),
+      isLocked(false) {}
+
+    void markCacheAccess(const std::string &hashDir) {
+      if (!isCacheEntry(hashDir)) {
+        return;
+      }
+      {
+        std::lock_guard<std::mutex> lock(accessMutex);
+        if (!accessedDirs.insert(hashDir).second) {
+          return;
+        }
+      }
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      ::utimes(hashDir.c_str(), NULL);
+#endif
+    }
+
+    cacheEntryVector getCacheEntries() {
+      cacheEntryVector entries;
+      lockDirMap lockDirs = getLockDirs();
+
+      strVector dirs = io::directories(cachePath());
+      const int dirCount = (int) dirs.size();
+      for (int i = 0; i < dirCount; ++i) {
+        const std::string name = dirName(dirs[i]);
+        // Skip evicted entries being removed
+        if (!name.size() || (name[0] == '.')) {
+          continue;
+        }
+
+        cacheEntry_t entry;
+        entry.hashDir = dirs[i];
+        entry.bytes = directoryBytes(dirs[i]);
+        entry.lastAccess = modifiedTime(dirs[i]);
+        entry.isComplete = io::files(dirs[i] + ".success/").size();
+
+        lockDirMap::iterator it = lockDirs.find(name);
+        entry.isLocked = ((it != lockDirs.end())
+                          && hasHeldLock(it->second));
+
+        entries.push_back(entry);
+      }
+      return entries;
+    }
+
+    udim_t getCacheMaxBytes() {
+      const json &settings_ = settings();
+      const json &maxSize = settings_["cache/max_size"];
+      if (maxSize.isString()) {
+        return parseBytes(maxSize.string());
+      }
+      if (maxSize.isNumber()) {
+        const double bytes = (double) maxSize;
+        return (bytes > 0) ? (udim_t) bytes : 0;
+      }
+      return 0;
+    }
+
+    int getCacheMaxEntries() {
+      const int maxEntries = settings().get("cache/max_entries", 0);
+      return (maxEntries > 0) ? maxEntries : 0;
+    }
+
+    double getCacheMinAge() {
+      return settings().get("cache/min_age", 60.0);
+    }
+
+    int evictCacheEntries(const udim_t maxBytes,
+                          const int maxEntries,
+                          const double minAge) {
+      if (!maxBytes && !maxEntries) {
+        return 0;
+      }
+
+      cacheEntryVector entries = getCacheEntries();
+      std::sort(entries.begin(), entries.end(), compareLastAccess);
+
+      udim_t totalBytes = 0;
+      int totalEntries = (int) entries.size();
+      for (int i = 0; i < totalEntries; ++i) {
+        totalBytes += entries[i].bytes;
+      }
+
+      int evictedEntries = 0;
+      const int entryCount = totalEntries;
+      for (int i = 0; i < entryCount; ++i) {
+        if ((!maxBytes || (totalBytes <= maxBytes))
+            && (!maxEntries || (totalEntries <= maxEntries))) {
+          break;
+        }
+        const cacheEntry_t &entry = entries[i];
+        if (entry.isLocked
+            || (age(entry.lastAccess) < minAge)
+            || !evictCacheEntry(entry)) {
+          continue;
+        }
+        totalBytes -= entry.bytes;
+        --totalEntries;
+        ++evictedEntries;
+      }
+      return evictedEntries;
+    }
+
+    int evictCacheEntries() {
+      return evictCacheEntries(getCacheMaxBytes(),
+                               getCacheMaxEntries(),
+                               getCacheMinAge());
+    }
+
+    int pruneCache(const double minAge) {
+      int removed = 0;
+
+      // Entries which never finished building
+      cacheEntryVector entries = getCacheEntries();
+      const int entryCount = (int) entries.size();
+      for (int i = 0; i < entryCount; ++i) {
+        const cacheEntry_t &entry = entries[i];
+        if (!entry.isComplete
+            && !entry.isLocked
+            && (age(entry.lastAccess) >= minAge)
+            && evictCacheEntry(entry)) {
+          ++removed;
+        }
+      }
+
+      // Leftovers from interrupted evictions and library installs
+      strVector dirs = io::directories(cachePath());
+      const int dirCount = (int) dirs.size();
+      for (int i = 0; i < dirCount; ++i) {
+        const std::string name = dirName(dirs[i]);
+        if ((startsWith(name, ".evicted_") || startsWith(name, ".installing_"))
+            && (age(modifiedTime(dirs[i])) >= minAge)) {
+          sys::rmdir(dirs[i], true);
+        }
+      }
+
+      // Locks left behind by holders without flock() support
+      lockDirMap lockDirs = getLockDirs();
+      lockDirMap::iterator it = lockDirs.begin();
+      while (it != lockDirs.end()) {
+        const strVector &entryLockDirs = it->second;
+        const int lockCount = (int) entryLockDirs.size();
+        for (int i = 0; i < lockCount; ++i) {
+          const std::string &lockDir = entryLockDirs[i];
+          if (!lock_t::isHeld(lockDir)
+              && (age(modifiedTime(lockDir)) >= minAge)) {
+            sys::rmdir(lockDir, true);
+            ++removed;
+          }
+        }
+        ++it;
+      }
+
+      cacheIndex().compact();
+      return removed;
+    }
+    //==================================
+
+    //---[ Binary Sharing ]-------------
+    bool sharesBinaries() {
+      return settings().get("cache/share_binaries", true);
+    }
+
+    std::string linkCachedBinary(const hash_t &contentHash,
+                                 const std::string &binaryFilename) {
+      std::string cachedBinary;
+      if (!cacheIndex().getBinary(contentHash, cachedBinary)
+          || (cachedBinary == binaryFilename)
+          || !cachedFileIsComplete(io::dirname(cachedBinary),
+                                   io::basename(cachedBinary))) {
+        return "";
+      }
+
+      // Rename the link into place in case an older binary is still there
+      const std::string tempFilename = (
+        binaryFilename + ".linking_" + toString(sys::getPID())
+      );
+      std::remove(tempFilename.c_str());
+      if (copyFile(cachedBinary, tempFilename)
+          && !::rename(tempFilename.c_str(), binaryFilename.c_str())) {
+        markCacheAccess(io::dirname(cachedBinary));
+        return cachedBinary;
+      }
+      std::remove(tempFilename.c_str());
+      return "";
+    }
+
+    void addCachedBinary(const hash_t &contentHash,
+                         const std::string &binaryFilename) {
+      cacheIndex().setBinary(contentHash, binaryFilename);
+    }
+    //==================================
+
+    //---[ Kernel Libraries ]-----------
+    std::string libraryCachePath(const std::string &library) {
+      OCCA_ERROR("Library name cannot be empty",
+                 library.size());
+      OCCA_ERROR("Library name cannot have / characters",
+                 library.find('/') == std::string::npos);
+      return libraryPath() + library + "/";
+    }
+
+    bool addCacheEntryToLibrary(const std::string &hashDir,
+                                const std::string &library) {
+      const std::string libraryDir = libraryCachePath(library);
+      const std::string libraryEntryDir = libraryDir + dirName(hashDir) + "/";
+      if (io::isDir(libraryEntryDir)) {
+        return true;
+      }
+      sys::mkpath(libraryDir);
+      return (copyDirectoryAtomically(hashDir, libraryEntryDir, ".adding_")
+              || io::isDir(libraryEntryDir));
+    }
+
+    std::string installLibraryCacheEntry(const std::string &libraryEntryDir) {
+      const std::string hashDir = cachePath() + dirName(libraryEntryDir) + "/";
+      if (io::isDir(hashDir)) {
+        return hashDir;
+      }
+      sys::mkpath(cachePath());
+      // Another process could have installed it first
+      if (copyDirectoryAtomically(libraryEntryDir, hashDir, ".installing_")
+          || io::isDir(hashDir)) {
+        return hashDir;
+      }
+      return "";
+    }
+    //==================================
   }
 }
@@ -0,0 +1,728 @@
+#include <cstddef>
+#include <cstring>
+#include <errno.h>
+#include <sstream>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <occa/defines.hpp>
+#include <occa/io/cacheIndex.hpp>
+#include <occa/io/utils.hpp>
+#include <occa/tools/hash.hpp>
+#include <occa/tools/lex.hpp>
+#include <occa/tools/string.hpp>
+#include <occa/tools/sys.hpp>
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+#  include <fcntl.h>
+#  include <sys/file.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace occa {
+  namespace io {
+    namespace {
+      struct indexHeader_t {
+        char magic[12];
+        uint32_t version;
+        uint64_t generation;
+      };
+
+      struct recordHeader_t {
+        uint32_t magic;
+        uint32_t type;
+        uint32_t keyBytes;
+        uint32_t valueBytes;
+        uint64_t checksum;
+      };
+
+      const char indexMagic[12] = "occa-index";
+      const uint32_t indexVersion = 2;
+      const uint32_t recordMagic = 0x4f434958; // OCIX
+
+      // Records start at aligned offsets to resync after crashed writers
+      const udim_t recordAlignment = 8;
+      const udim_t maxRecordBytes = (1 << 20);
+
+      udim_t alignRecordBytes(const udim_t bytes) {
+        return ((bytes + recordAlignment - 1) / recordAlignment) * recordAlignment;
+      }
+
+      // FNV-1a, kept separate from occa::hash to keep the format stable
+      uint64_t checksum(const uint32_t type,
+                        const char *key,
+                        const udim_t keyBytes,
+                        const char *value,
+                        const udim_t valueBytes) {
+        uint64_t h = 14695981039346656037ULL;
+        h = (h ^ type) * 1099511628211ULL;
+        for (udim_t i = 0; i < keyBytes; ++i) {
+          h = (h ^ (unsigned char) key[i]) * 1099511628211ULL;
+        }
+        for (udim_t i = 0; i < valueBytes; ++i) {
+          h = (h ^ (unsigned char) value[i]) * 1099511628211ULL;
+        }
+        return h;
+      }
+
+      std::string serializeRecord(const int type,
+                                  const std::string &key,
+                                  const std::string &value) {
+        recordHeader_t header;
+        header.magic = recordMagic;
+        header.type = type;
+        header.keyBytes = key.size();
+        header.valueBytes = value.size();
+        header.checksum = checksum(type,
+                                   key.c_str(), key.size(),
+                                   value.c_str(), value.size());
+
+        std::string record((const char*) &header, sizeof(header));
+        record += key;
+        record += value;
+        record.resize(alignRecordBytes(record.size()), '\0');
+        return record;
+      }
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      bool writeAll(const int fd, const std::string &content) {
+        const char *c = content.c_str();
+        udim_t bytesLeft = content.size();
+        while (bytesLeft) {
+          const ssize_t bytes = ::write(fd, c, bytesLeft);
+          if (bytes < 0) {
+            if (errno == EINTR) {
+              continue;
+            }
+            return false;
+          }
+          c += bytes;
+          bytesLeft -= bytes;
+        }
+        return true;
+      }
+#endif
+
+      // Completed files are recorded with their stamp to detect files which
+      //   were removed or replaced without going through the index
+      std::string getFileStamp(const std::string &filename) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+        struct stat buffer;
+        if (::stat(filename.c_str(), &buffer)
+            || !S_ISREG(buffer.st_mode)) {
+          return "";
+        }
+#  if (OCCA_OS & OCCA_MACOS_OS)
+        const struct timespec &mtime = buffer.st_mtimespec;
+#  else
+        const struct timespec &mtime = buffer.st_mtim;
+#  endif
+        std::stringstream ss;
+        ss << buffer.st_dev << ':' << buffer.st_ino
+           << ':' << buffer.st_size
+           << ':' << mtime.tv_sec << '.' << mtime.tv_nsec;
+        return ss.str();
+#else
+        return io::isFile(filename) ? "file" : "";
+#endif
+      }
+    }
+
+    //---[ cacheIndex_t ]---------------
+    cacheIndex_t::cacheIndex_t() :
+      isDisabled(false),
+      fd(-1),
+      mappedPtr(NULL),
+      mappedBytes(0),
+      parsedBytes(0),
+      verifiedBytes(0),
+      verifiedGeneration(0) {}
+
+    cacheIndex_t::~cacheIndex_t() {
+      close();
+    }
+
+    bool cacheIndex_t::isComplete(const std::string &hashDir,
+                                  const std::string &cachedFile) {
+      const std::string key = hashDir + cachedFile;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = completedFiles.find(key);
+      if (it == completedFiles.end()) {
+        refresh();
+        it = completedFiles.find(key);
+        if (it == completedFiles.end()) {
+          return false;
+        }
+      }
+
+      // Only check the file again after the index changed
+      const uint64_t generation = mappedGeneration();
+      if ((verifiedBytes != mappedBytes)
+          || (verifiedGeneration != generation)) {
+        verifiedFiles.clear();
+        verifiedBytes = mappedBytes;
+        verifiedGeneration = generation;
+      }
+      if (verifiedFiles.count(key)) {
+        return true;
+      }
+
+      // The file was removed or rebuilt since it was recorded, for example
+      //   after an 'rm -rf' of its cache directory
+      const std::string stamp = getFileStamp(key);
+      if (!stamp.size() || (stamp != it->second)) {
+        completedFiles.erase(it);
+        return false;
+      }
+      verifiedFiles.insert(key);
+      return true;
+    }
+
+    void cacheIndex_t::markComplete(const std::string &hashDir,
+                                    const std::string &cachedFile) {
+      const std::string key = hashDir + cachedFile;
+      const std::string stamp = getFileStamp(key);
+      if (!stamp.size()) {
+        return;
+      }
+
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = completedFiles.find(key);
+      if ((it == completedFiles.end()) || (it->second != stamp)) {
+        append(completedFileRecord, key, stamp);
+      }
+    }
+
+    bool cacheIndex_t::getDependencies(const hash_t &kernelHash,
+                                       jsonObject &dependencyHashes) {
+      const std::string key = kernelHash.getFullString();
+      std::string value;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unordered_map<std::string, std::string>::iterator it = dependencies.find(key);
+        if (it == dependencies.end()) {
+          refresh();
+          it = dependencies.find(key);
+          if (it == dependencies.end()) {
+            return false;
+          }
+        }
+        value = it->second;
+      }
+
+      json dependenciesJson = json::parse(value);
+      dependencyHashes = (
+        dependenciesJson.isObject()
+        ? dependenciesJson.object()
+        : jsonObject()
+      );
+      return true;
+    }
+
+    void cacheIndex_t::setDependencies(const hash_t &kernelHash,
+                                       const json &dependencyHashes) {
+      const std::string key = kernelHash.getFullString();
+      const std::string value = (
+        dependencyHashes.isObject()
+        ? dependencyHashes.toString()
+        : "{}"
+      );
+
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = dependencies.find(key);
+      if ((it == dependencies.end()) || (it->second != value)) {
+        append(dependenciesRecord, key, value);
+      }
+    }
+
+    bool cacheIndex_t::getFileHash(const std::string &path,
+                                   std::string &value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = fileHashes.find(path);
+      if (it == fileHashes.end()) {
+        refresh();
+        it = fileHashes.find(path);
+        if (it == fileHashes.end()) {
+          return false;
+        }
+      }
+      value = it->second;
+      return true;
+    }
+
+    void cacheIndex_t::setFileHash(const std::string &path,
+                                   const std::string &value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = fileHashes.find(path);
+      if ((it == fileHashes.end()) || (it->second != value)) {
+        append(fileHashRecord, path, value);
+      }
+    }
+
+    bool cacheIndex_t::getBinary(const hash_t &contentHash,
+                                 std::string &binaryFilename) {
+      const std::string key = contentHash.getFullString();
+
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = binaries.find(key);
+      if (it == binaries.end()) {
+        refresh();
+        it = binaries.find(key);
+        if (it == binaries.end()) {
+          return false;
+        }
+      }
+      binaryFilename = it->second;
+      return true;
+    }
+
+    void cacheIndex_t::setBinary(const hash_t &contentHash,
+                                 const std::string &binaryFilename) {
+      const std::string key = contentHash.getFullString();
+
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = binaries.find(key);
+      if ((it == binaries.end()) || (it->second != binaryFilename)) {
+        append(binaryRecord, key, binaryFilename);
+      }
+    }
+
+    bool cacheIndex_t::getToolchain(const std::string &compiler,
+                                    std::string &value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = toolchains.find(compiler);
+      if (it == toolchains.end()) {
+        refresh();
+        it = toolchains.find(compiler);
+        if (it == toolchains.end()) {
+          return false;
+        }
+      }
+      value = it->second;
+      return true;
+    }
+
+    void cacheIndex_t::setToolchain(const std::string &compiler,
+                                    const std::string &value) {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_map<std::string, std::string>::iterator it = toolchains.find(compiler);
+      if ((it == toolchains.end()) || (it->second != value)) {
+        append(toolchainRecord, compiler, value);
+      }
+    }
+
+    void cacheIndex_t::removeDir(const std::string &hashDir) {
+      // Other processes don't need a record, the new generation makes them
+      //   check their hits against the files again
+      std::lock_guard<std::mutex> lock(mutex);
+      forgetDir(hashDir);
+      if (!open()) {
+        return;
+      }
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      ::flock(fd, LOCK_EX);
+      bumpGeneration();
+      ::flock(fd, LOCK_UN);
+#endif
+    }
+
+    void cacheIndex_t::compact() {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!open()) {
+        return;
+      }
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      // Block writers while the index is rewritten
+      const int oldFd = fd;
+      ::flock(oldFd, LOCK_EX);
+      refresh();
+
+      std::unordered_map<std::string, std::string> liveFiles;
+      std::unordered_map<std::string, std::string>::iterator fileIt = completedFiles.begin();
+      while (fileIt != completedFiles.end()) {
+        if (getFileStamp(fileIt->first) == fileIt->second) {
+          liveFiles[fileIt->first] = fileIt->second;
+        }
+        ++fileIt;
+      }
+
+      std::unordered_map<std::string, std::string> liveDependencies;
+      const std::string &cPath = cachePath();
+      std::unordered_map<std::string, std::string>::iterator depIt = dependencies.begin();
+      while (depIt != dependencies.end()) {
+        const std::string &kernelHash = depIt->first;
+        if (io::isDir(cPath + kernelHash.substr(0, 16))) {
+          liveDependencies[kernelHash] = depIt->second;
+        }
+        ++depIt;
+      }
+
+      std::unordered_map<std::string, std::string> liveFileHashes;
+      std::unordered_map<std::string, std::string>::iterator hashIt = fileHashes.begin();
+      while (hashIt != fileHashes.end()) {
+        if (io::exists(hashIt->first)) {
+          liveFileHashes[hashIt->first] = hashIt->second;
+        }
+        ++hashIt;
+      }
+
+      std::unordered_map<std::string, std::string> liveBinaries;
+      std::unordered_map<std::string, std::string>::iterator binaryIt = binaries.begin();
+      while (binaryIt != binaries.end()) {
+        if (io::exists(binaryIt->second)) {
+          liveBinaries[binaryIt->first] = binaryIt->second;
+        }
+        ++binaryIt;
+      }
+
+      std::string content;
+      indexHeader_t indexHeader;
+      ::memset(&indexHeader, 0, sizeof(indexHeader));
+      ::memcpy(indexHeader.magic, indexMagic, sizeof(indexMagic));
+      indexHeader.version = indexVersion;
+      content.assign((const char*) &indexHeader, sizeof(indexHeader));
+
+      for (fileIt = liveFiles.begin(); fileIt != liveFiles.end(); ++fileIt) {
+        content += serializeRecord(completedFileRecord, fileIt->first, fileIt->second);
+      }
+      for (depIt = liveDependencies.begin(); depIt != liveDependencies.end(); ++depIt) {
+        content += serializeRecord(dependenciesRecord, depIt->first, depIt->second);
+      }
+      for (hashIt = liveFileHashes.begin(); hashIt != liveFileHashes.end(); ++hashIt) {
+        content += serializeRecord(fileHashRecord, hashIt->first, hashIt->second);
+      }
+      for (binaryIt = liveBinaries.begin(); binaryIt != liveBinaries.end(); ++binaryIt) {
+        content += serializeRecord(binaryRecord, binaryIt->first, binaryIt->second);
+      }
+      // Outdated toolchains are replaced when they're detected again
+      std::unordered_map<std::string, std::string>::iterator toolchainIt = toolchains.begin();
+      for (; toolchainIt != toolchains.end(); ++toolchainIt) {
+        content += serializeRecord(toolchainRecord, toolchainIt->first, toolchainIt->second);
+      }
+
+      // Processes still mapping the old index check their hits again
+      bumpGeneration();
+
+      const std::string tempFilename = filename + "." + toString(sys::getPID());
+      const int tempFd = ::open(tempFilename.c_str(),
+                                O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                                0644);
+      if (tempFd >= 0) {
+        const bool wroteIndex = writeAll(tempFd, content);
+        ::close(tempFd);
+        if (!wroteIndex || ::rename(tempFilename.c_str(), filename.c_str())) {
+          ::remove(tempFilename.c_str());
+        }
+      }
+      ::flock(oldFd, LOCK_UN);
+
+      // Reload the new index
+      close();
+      completedFiles.clear();
+      dependencies.clear();
+      fileHashes.clear();
+      binaries.clear();
+      toolchains.clear();
+      refresh();
+#endif
+    }
+
+    int cacheIndex_t::completedFileCount() {
+      std::lock_guard<std::mutex> lock(mutex);
+      refresh();
+      return (int) completedFiles.size();
+    }
+
+    bool cacheIndex_t::open() {
+      if (fd >= 0) {
+        return true;
+      }
+      if (isDisabled) {
+        return false;
+      }
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      if (!filename.size()) {
+        filename = cachePath() + "index";
+      }
+      const int flags = O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC;
+      fd = ::open(filename.c_str(), flags, 0644);
+      if ((fd < 0) && (errno == ENOENT)) {
+        sys::mkpath(cachePath());
+        fd = ::open(filename.c_str(), flags, 0644);
+      }
+      if (fd < 0) {
+        // Read-only caches can still use an existing index
+        fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+      }
+#endif
+      isDisabled = (fd < 0);
+      return !isDisabled;
+    }
+
+    void cacheIndex_t::close() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      if (mappedPtr) {
+        ::munmap(mappedPtr, mappedBytes);
+      }
+      if (fd >= 0) {
+        ::close(fd);
+      }
+#endif
+      fd = -1;
+      mappedPtr = NULL;
+      mappedBytes = 0;
+      parsedBytes = 0;
+      verifiedFiles.clear();
+    }
+
+    void cacheIndex_t::refresh() {
+      if (!open()) {
+        return;
+      }
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      struct stat fdStat, pathStat;
+      if (::fstat(fd, &fdStat)) {
+        return;
+      }
+      if (::stat(filename.c_str(), &pathStat)
+          || (fdStat.st_dev != pathStat.st_dev)
+          || (fdStat.st_ino != pathStat.st_ino)) {
+        // The index was removed, for example by `occa clear`
+        close();
+        completedFiles.clear();
+        dependencies.clear();
+        fileHashes.clear();
+        binaries.clear();
+        toolchains.clear();
+        if (!open() || ::fstat(fd, &fdStat)) {
+          return;
+        }
+      }
+
+      const udim_t fileBytes = fdStat.st_size;
+      if (fileBytes <= mappedBytes) {
+        return;
+      }
+
+      if (mappedPtr) {
+        ::munmap(mappedPtr, mappedBytes);
+        mappedPtr = NULL;
+        mappedBytes = 0;
+      }
+      void *ptr = ::mmap(NULL, fileBytes, PROT_READ, MAP_SHARED, fd, 0);
+      if (ptr == MAP_FAILED) {
+        return;
+      }
+      mappedPtr = (char*) ptr;
+      mappedBytes = fileBytes;
+
+      if (!parsedBytes) {
+        if (mappedBytes < sizeof(indexHeader_t)) {
+          return;
+        }
+        indexHeader_t header;
+        ::memcpy(&header, mappedPtr, sizeof(header));
+        if (::memcmp(header.magic, indexMagic, sizeof(indexMagic))
+            || (header.version != indexVersion)) {
+          // Fallback to the directory layout for unknown index formats
+          close();
+          isDisabled = true;
+          return;
+        }
+        parsedBytes = sizeof(indexHeader_t);
+      }
+
+      parseRecords();
+#endif
+    }
+
+    uint64_t cacheIndex_t::mappedGeneration() const {
+      if (!mappedPtr || (mappedBytes < sizeof(indexHeader_t))) {
+        return 0;
+      }
+      uint64_t generation;
+      ::memcpy(&generation,
+               mappedPtr + offsetof(indexHeader_t, generation),
+               sizeof(generation));
+      return generation;
+    }
+
+    void cacheIndex_t::bumpGeneration() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      // Writes at an offset are ignored by [fd] since it's opened with O_APPEND
+      const int headerFd = ::open(filename.c_str(), O_RDWR | O_CLOEXEC);
+      if (headerFd < 0) {
+        return;
+      }
+      struct stat fdStat, headerStat;
+      uint64_t generation;
+      const off_t offset = offsetof(indexHeader_t, generation);
+      if (!::fstat(fd, &fdStat)
+          && !::fstat(headerFd, &headerStat)
+          && (fdStat.st_dev == headerStat.st_dev)
+          && (fdStat.st_ino == headerStat.st_ino)
+          && (::pread(headerFd, &generation, sizeof(generation), offset)
+              == (ssize_t) sizeof(generation))) {
+        ++generation;
+        ::pwrite(headerFd, &generation, sizeof(generation), offset);
+      }
+      ::close(headerFd);
+#endif
+    }
+
+    void cacheIndex_t::parseRecords() {
+      udim_t offset = parsedBytes;
+      while ((offset + sizeof(recordHeader_t)) <= mappedBytes) {
+        recordHeader_t header;
+        ::memcpy(&header, mappedPtr + offset, sizeof(header));
+
+        const udim_t contentBytes = header.keyBytes + (udim_t) header.valueBytes;
+        if ((header.magic != recordMagic)
+            || (contentBytes > maxRecordBytes)) {
+          // Skip padding or a record left by a crashed writer
+          offset += recordAlignment;
+          continue;
+        }
+
+        const udim_t recordBytes = alignRecordBytes(sizeof(header) + contentBytes);
+        if ((offset + recordBytes) > mappedBytes) {
+          // Still being written
+          break;
+        }
+
+        const char *key = mappedPtr + offset + sizeof(header);
+        const char *value = key + header.keyBytes;
+        if (header.checksum != checksum(header.type,
+                                        key, header.keyBytes,
+                                        value, header.valueBytes)) {
+          offset += recordAlignment;
+          continue;
+        }
+
+        applyRecord(header.type,
+                    std::string(key, header.keyBytes),
+                    std::string(value, header.valueBytes));
+        offset += recordBytes;
+      }
+      parsedBytes = offset;
+    }
+
+    void cacheIndex_t::applyRecord(const int type,
+                                   const std::string &key,
+                                   const std::string &value) {
+      switch (type) {
+      case completedFileRecord:
+        completedFiles[key] = value;
+        break;
+      case dependenciesRecord:
+        dependencies[key] = value;
+        break;
+      case fileHashRecord:
+        fileHashes[key] = value;
+        break;
+      case binaryRecord:
+        binaries[key] = value;
+        break;
+      case toolchainRecord:
+        toolchains[key] = value;
+        break;
+      }
+    }
+
+    void cacheIndex_t::forgetDir(const std::string &hashDir) {
+      std::unordered_map<std::string, std::string>::iterator fileIt = completedFiles.begin();
+      while (fileIt != completedFiles.end()) {
+        if (startsWith(fileIt->first, hashDir)) {
+          fileIt = completedFiles.erase(fileIt);
+        } else {
+          ++fileIt;
+        }
+      }
+      std::unordered_map<std::string, std::string>::iterator binaryIt = binaries.begin();
+      while (binaryIt != binaries.end()) {
+        if (startsWith(binaryIt->second, hashDir)) {
+          binaryIt = binaries.erase(binaryIt);
+        } else {
+          ++binaryIt;
+        }
+      }
+      // Dependencies are keyed by the kernel hash, which names its directory
+      const std::string &cPath = cachePath();
+      if (startsWith(hashDir, cPath)) {
+        std::string dirName = hashDir.substr(cPath.size());
+        if (dirName.size() && (dirName[dirName.size() - 1] == '/')) {
+          dirName.resize(dirName.size() - 1);
+        }
+        std::unordered_map<std::string, std::string>::iterator depIt = dependencies.begin();
+        while (depIt != dependencies.end()) {
+          if (dirName.size() && startsWith(depIt->first, dirName)) {
+            depIt = dependencies.erase(depIt);
+          } else {
+            ++depIt;
+          }
+        }
+      }
+    }
+
+    void cacheIndex_t::append(const int type,
+                              const std::string &key,
+                              const std::string &value) {
+      // Reopen the index if it was removed or compacted, otherwise the
+      //   record is written to the unlinked file
+      refresh();
+      if (!open()) {
+        return;
+      }
+      applyRecord(type, key, value);
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const std::string record = serializeRecord(type, key, value);
+
+      // The index could be replaced between refresh() and flock()
+      for (int attempt = 0; attempt < 3; ++attempt) {
+        ::flock(fd, LOCK_EX);
+        struct stat fdStat, pathStat;
+        if (::fstat(fd, &fdStat)) {
+          ::flock(fd, LOCK_UN);
+          return;
+        }
+        if (::stat(filename.c_str(), &pathStat)
+            || (fdStat.st_dev != pathStat.st_dev)
+            || (fdStat.st_ino != pathStat.st_ino)) {
+          ::flock(fd, LOCK_UN);
+          refresh();
+          if (!open()) {
+            return;
+          }
+          continue;
+        }
+
+        const udim_t fileBytes = fdStat.st_size;
+        std::string prefix;
+        if (!fileBytes) {
+          indexHeader_t indexHeader;
+          ::memset(&indexHeader, 0, sizeof(indexHeader));
+          ::memcpy(indexHeader.magic, indexMagic, sizeof(indexMagic));
+          indexHeader.version = indexVersion;
+          prefix.assign((const char*) &indexHeader, sizeof(indexHeader));
+        } else if (fileBytes % recordAlignment) {
+          // Realign after a crashed writer
+          prefix.assign(recordAlignment - (fileBytes % recordAlignment), '\0');
+        }
+        writeAll(fd, prefix + record);
+        ::flock(fd, LOCK_UN);
+        return;
+      }
+#endif
+    }
+    //==================================
+
+    cacheIndex_t& cacheIndex() {
+      static cacheIndex_t index;
+      return index;
+    }
+  }
+}
@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <errno.h>
+#include <fstream>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -10,23 +13,79 @@
 #include <occa/tools/env.hpp>
 
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <sys/file.h>
 #  include <unistd.h>
+#  if (OCCA_OS & OCCA_LINUX_OS)
+#    include <sys/inotify.h>
+#  endif
 #else
 #  include <windows.h> // Sleep
 #endif
 
 namespace occa {
   namespace io {
+    namespace {
+      // Backoff when waiting without inotify
+      const int minWaitMicroseconds = 1000;
+      const int maxWaitMicroseconds = 50000;
+
+      void sleepMicroseconds(const int microseconds) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+        ::usleep(microseconds);
+#else
+        Sleep(microseconds < 1000 ? 1 : (microseconds / 1000));
+#endif
+      }
+
+      // Lock holders without flock() are only tracked by their PID file,
+      //   which stores [<pid> <hostname>]
+      // PIDs can only be checked on the holder's host, otherwise the
+      //   holder is stale once the lock is older than [staleAge]
+      bool holderIsAlive(const std::string &lockDir,
+                         const float staleAge) {
+        int pid = -1;
+        std::string hostname;
+        std::ifstream pidIn((lockDir + "/pid").c_str());
+        if ((pidIn >> pid >> hostname)
+            && (hostname == sys::getHostname())) {
+          return sys::pidExists(pid);
+        }
+
+        struct stat buffer;
+        if (::stat(lockDir.c_str(), &buffer)) {
+          return false;
+        }
+        const double age = ::difftime(::time(NULL),
+                                      buffer.st_ctime);
+        return (std::abs(age) < staleAge);
+      }
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      // Checks if the path wasn't removed or replaced after opening it
+      bool isSameFile(const int fd, const std::string &path) {
+        struct stat fdStat, pathStat;
+        return (!::fstat(fd, &fdStat)
+                && !::stat(path.c_str(), &pathStat)
+                && (fdStat.st_dev == pathStat.st_dev)
+                && (fdStat.st_ino == pathStat.st_ino));
+      }
+#endif
+    }
+
     lock_t::lock_t() :
       isMineCached(false),
-      released(true) {}
+      released(true),
+      lockFd(-1) {}
 
     lock_t::lock_t(const hash_t &hash,
                    const std::string &tag,
                    const float staleAge_) :
       isMineCached(false),
       staleAge(staleAge_),
-      released(false) {
+      released(false),
+      lockFd(-1) {
 
       lockDir = env::OCCA_CACHE_DIR;
       lockDir += "locks/";
@@ -43,6 +102,26 @@ namespace occa {
       }
     }
 
+    lock_t::lock_t(const lock_t &other) :
+      lockDir(other.lockDir),
+      isMineCached(false),
+      staleWarning(other.staleWarning),
+      staleAge(other.staleAge),
+      released(other.released || other.isMineCached),
+      lockFd(-1) {}
+
+    lock_t& lock_t::operator = (const lock_t &other) {
+      if (this != &other) {
+        release();
+        lockDir = other.lockDir;
+        isMineCached = false;
+        staleWarning = other.staleWarning;
+        staleAge = other.staleAge;
+        released = (other.released || other.isMineCached);
+      }
+      return *this;
+    }
+
     lock_t::~lock_t() {
       release();
     }
@@ -55,28 +134,34 @@ namespace occa {
       return lockDir;
     }
 
+    std::string lock_t::pidFile() const {
+      return lockDir + "/pid";
+    }
+
     void lock_t::release() const {
-      if (!released) {
-        sys::rmdir(lockDir);
-        released = true;
+      if (released) {
+        return;
+      }
+      // Remove the lock before unlocking it so waiters
+      //   know the holder is done
+      if (isMineCached) {
+        removeLockDir();
       }
+      closeLockFd();
+      released = true;
     }
 
     bool lock_t::isMine() {
       if (isMineCached) {
         return true;
       }
-      sys::mkpath(env::OCCA_CACHE_DIR + "locks/");
-
       while (true) {
-        int mkdirStatus = sys::mkdir(lockDir);
-
-        if (!mkdirStatus
-            || (errno != EEXIST)) {
+        if (tryLock()) {
           isMineCached = true;
+          std::ofstream pidOut(pidFile().c_str());
+          pidOut << sys::getPID() << ' ' << sys::getHostname();
           return true;
         }
-
         if (isReleased()) {
           break;
         }
@@ -84,44 +169,159 @@ namespace occa {
       return false;
     }
 
+    bool lock_t::tryLock() {
+      int mkdirStatus = sys::mkdir(lockDir);
+      if (mkdirStatus && (errno == ENOENT)) {
+        // Only create the locks directory when it's missing
+        sys::mkpath(env::OCCA_CACHE_DIR + "locks/");
+        mkdirStatus = sys::mkdir(lockDir);
+      }
+      if (mkdirStatus && (errno != EEXIST)) {
+        // Unable to create locks, don't block the caller
+        return true;
+      }
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      closeLockFd();
+      lockFd = ::open(lockDir.c_str(), O_RDONLY | O_CLOEXEC);
+      if (lockFd < 0) {
+        // Lock was released between the mkdir and open
+        return false;
+      }
+
+      if (!::flock(lockFd, LOCK_EX | LOCK_NB)) {
+        if (isSameFile(lockFd, lockDir)) {
+          return true;
+        }
+        // The holder removed the lock before we locked it
+        closeLockFd();
+        return false;
+      }
+      if (errno == EWOULDBLOCK) {
+        // Keep the file descriptor to wait on the holder
+        return false;
+      }
+
+      // flock() isn't supported, the directory is the lock
+      closeLockFd();
+#endif
+      return !mkdirStatus;
+    }
+
     bool lock_t::isReleased() {
-      const char *c_lockDir = lockDir.c_str();
-      double startTime = sys::currentTime();
+      const double startTime = sys::currentTime();
+      bool printedWarning = false;
       bool isStale = false;
 
-      struct stat buffer;
-      while(!stat(c_lockDir, &buffer)) {
-        const double age = ::difftime(::time(NULL),
-                                      buffer.st_ctime);
-        if (std::abs(age) >= staleAge) {
+#if (OCCA_OS & OCCA_LINUX_OS)
+      // Wake up on lock removal and when holders close the lock
+      int inotifyFd = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+      if ((inotifyFd >= 0)
+          && (::inotify_add_watch(inotifyFd,
+                                  lockDir.c_str(),
+                                  (IN_DELETE_SELF | IN_MOVE_SELF
+                                   | IN_DELETE | IN_CLOSE)) < 0)) {
+        ::close(inotifyFd);
+        inotifyFd = -1;
+      }
+#endif
+
+      int waitMicroseconds = minWaitMicroseconds;
+      while (io::isDir(lockDir)) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+        if (lockFd >= 0) {
+          if (!::flock(lockFd, LOCK_EX | LOCK_NB)) {
+            // Holder exited without releasing the lock
+            isStale = isSameFile(lockFd, lockDir);
+            break;
+          }
+        } else
+#endif
+        if (holderIsStale()) {
+          // Only holders without flock() leave a lock behind
+          removeLockDir();
           isStale = true;
           break;
         }
+
         // Print warning only once
-        if ((sys::currentTime() - startTime) > staleWarning) {
-          io::stderr << "Located possible stale hash: ["
+        if (!printedWarning
+            && ((sys::currentTime() - startTime) > staleWarning)) {
+          io::stderr << "Waiting on lock: ["
                      << lockDir
                      << "]\n";
-          staleWarning = staleAge + 10;
+          printedWarning = true;
         }
 
-        // Wait 0.5 seconds before trying again
-#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-        ::usleep(500000);
-#else
-        Sleep(500);
+#if (OCCA_OS & OCCA_LINUX_OS)
+        if (inotifyFd >= 0) {
+          struct pollfd pollFd;
+          pollFd.fd = inotifyFd;
+          pollFd.events = POLLIN;
+          pollFd.revents = 0;
+
+          // Time out in case the lock lives in a filesystem without inotify
+          if (::poll(&pollFd, 1, maxWaitMicroseconds / 1000) > 0) {
+            char events[4096];
+            while (::read(inotifyFd, events, sizeof(events)) > 0) {}
+          }
+          continue;
+        }
 #endif
+        sleepMicroseconds(waitMicroseconds);
+        waitMicroseconds = std::min(2 * waitMicroseconds,
+                                    maxWaitMicroseconds);
       }
 
-      // Other process released the hash
-      if (!isStale) {
+#if (OCCA_OS & OCCA_LINUX_OS)
+      if (inotifyFd >= 0) {
+        ::close(inotifyFd);
+      }
+#endif
+      closeLockFd();
+
+      // Stale locks are taken over by the next tryLock()
+      return !isStale;
+    }
+
+    bool lock_t::isHeld(const std::string &lockDir) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const int fd = ::open(lockDir.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd < 0) {
+        return false;
+      }
+      if (!::flock(fd, LOCK_EX | LOCK_NB)) {
+        ::close(fd);
+        return false;
+      }
+      const bool wouldBlock = (errno == EWOULDBLOCK);
+      ::close(fd);
+      if (wouldBlock) {
         return true;
       }
-      // Delete lock and recreate it
-      release();
-      released = false;
+#endif
+      // flock() isn't supported, use the holder's PID file
+      const float staleAge = settings()["locks"].get("stale_age",
+                                                     (float) 20.0);
+      return holderIsAlive(lockDir, staleAge);
+    }
 
-      return false;
+    bool lock_t::holderIsStale() const {
+      return !holderIsAlive(lockDir, staleAge);
+    }
+
+    void lock_t::removeLockDir() const {
+      std::remove(pidFile().c_str());
+      sys::rmdir(lockDir);
+    }
+
+    void lock_t::closeLockFd() const {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      if (lockFd >= 0) {
+        ::close(lockFd);
+      }
+#endif
+      lockFd = -1;
     }
   }
 }
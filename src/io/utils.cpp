@@ -32,6 +32,9 @@ namespace occa {
     const std::string launcherSourceFile = "launcher_source.cpp";
     const std::string buildFile          = "build.json";
     const std::string launcherBuildFile  = "launcher_build.json";
+    const std::string buildLogFile       = "build.log";
+    const std::string pchHeaderFile      = "pch.hpp";
+    const std::string pchDependenciesFile = "pch_dependencies.json";
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
     const std::string binaryFile         = "binary";
     const std::string launcherBinaryFile = "launcher_binary";
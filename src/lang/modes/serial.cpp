@@ -1,11 +1,14 @@
+#include <occa/tools/string.hpp>
 #include <occa/lang/modes/serial.hpp>
 #include <occa/lang/modes/okl.hpp>
 #include <occa/lang/builtins/types.hpp>
+#include <occa/lang/expr.hpp>
 
 namespace occa {
   namespace lang {
     namespace okl {
       const std::string serialParser::exclusiveIndexName = "_occa_exclusive_index";
+      const std::string serialParser::kernelEntryPrefix = "_occa_entry_";
 
       serialParser::serialParser(const occa::properties &settings_) :
         parser_t(settings_) {
@@ -24,6 +27,9 @@ namespace occa {
         if (!success) return;
         setupKernels();
 
+        if (!success) return;
+        setupKernelEntries();
+
         if (!success) return;
         setupExclusives();
       }
@@ -69,7 +75,27 @@ namespace occa {
                              kernelSmnts);
         const int kernels = (int) kernelSmnts.size();
         for (int i = 0; i < kernels; ++i) {
-          setupKernel(*((functionDeclStatement*) kernelSmnts[i]));
+          functionDeclStatement &kernelSmnt = *((functionDeclStatement*) kernelSmnts[i]);
+          setupKernel(kernelSmnt);
+          if (!success) {
+            break;
+          }
+        }
+      }
+
+      void serialParser::setupKernelEntries() {
+        // Ran after kernel arguments are final, launcher parsers modify
+        //   them after setupKernels()
+        statementPtrVector kernelSmnts;
+        findStatementsByAttr(statementType::functionDecl,
+                             "kernel",
+                             root,
+                             kernelSmnts);
+        const int kernels = (int) kernelSmnts.size();
+        for (int i = 0; i < kernels; ++i) {
+          setupKernelEntry(
+            *((functionDeclStatement*) kernelSmnts[i])
+          );
           if (!success) {
             break;
           }
@@ -110,6 +136,101 @@ namespace occa {
         }
       }
 
+      void serialParser::setupKernelEntry(functionDeclStatement &kernelSmnt) {
+        // Add an extern "C" entry taking the packed argument array:
+        //   extern "C" void _occa_entry_foo(void **args) {
+        //     foo(*((const int *) args[0]), (float *) args[1]);
+        //   }
+        // The runtime calls it directly instead of going through sys::runFunction
+        function_t &func = kernelSmnt.function;
+        token_t *source = kernelSmnt.source;
+        const fileOrigin &origin = source->origin;
+
+        // Multi-dimensional array arguments can't be casted from void*,
+        //   the runtime falls back to sys::runFunction for these kernels
+        const int argCount = (int) func.args.size();
+        for (int i = 0; i < argCount; ++i) {
+          if (func.args[i]->vartype.arrays.size() > 1) {
+            return;
+          }
+        }
+
+        // void _occa_entry_foo(void **args)
+        vartype_t returnType(identifierToken(origin, "void"), void_);
+#if OCCA_OS == OCCA_WINDOWS_OS
+        returnType.add(origin, dllexport_);
+#endif
+        returnType.add(0, origin, externC);
+
+        identifierToken entrySource(origin, kernelEntryName(func.name()));
+        function_t &entryFunc = *(new function_t(returnType, entrySource));
+
+        identifierToken argsSource(origin, "args");
+        vartype_t argsType(identifierToken(origin, "void"), void_);
+        argsType += pointer_t();
+        argsType += pointer_t();
+        entryFunc.addArgument(variable_t(argsType, &argsSource));
+        variableNode argsNode(source, *(entryFunc.args[0]));
+
+        exprNodeVector callArgs;
+        for (int i = 0; i < argCount; ++i) {
+          vartype_t argType = func.args[i]->vartype;
+          // Non-pointer arguments are passed by reference, unpack them by value
+          const bool isPointer = argType.isPointerType();
+          if (argType.arrays.size()) {
+            argType.arrays.clear();
+            argType += pointer_t();
+          }
+          if (argType.isReference()) {
+            delete argType.referenceToken;
+            argType.referenceToken = NULL;
+          }
+          if (!isPointer) {
+            argType += pointer_t();
+          }
+
+          // (type*) args[i] or *((type*) args[i])
+          subscriptNode argNode(source,
+                                argsNode,
+                                primitiveNode(source, i));
+          parenCastNode castNode(source, argType, argNode);
+          if (isPointer) {
+            callArgs.push_back(castNode.clone());
+          } else {
+            callArgs.push_back(
+              new leftUnaryOpNode(source,
+                                  op::dereference,
+                                  parenthesesNode(source, castNode))
+            );
+          }
+        }
+
+        // foo(...)
+        callNode kernelCall(source,
+                            functionNode(source, func),
+                            callArgs);
+        freeExprNodeVector(callArgs);
+
+        blockStatement &parent = *(kernelSmnt.up);
+        functionDeclStatement &entrySmnt = *(
+          new functionDeclStatement(&parent, entryFunc)
+        );
+        entrySmnt.add(
+          *(new expressionStatement(&entrySmnt,
+                                    *(kernelCall.clone())))
+        );
+
+        if (!entrySmnt.addFunctionToParentScope()) {
+          success = false;
+          return;
+        }
+        parent.addAfter(kernelSmnt, entrySmnt);
+      }
+
+      std::string serialParser::kernelEntryName(const std::string &kernelName) {
+        return kernelEntryPrefix + kernelName;
+      }
+
       void serialParser::setupExclusives() {
         // Get @exclusive declarations
         statementExprMap exprMap;
@@ -114,6 +114,13 @@ namespace occa {
           if (!success) return;
         }
 
+        // Entries need the launcher arguments
+        launcherParser.setupKernelEntries();
+        if (!launcherParser.success) {
+          success = false;
+          return;
+        }
+
         setupLauncherHeaders();
       }
 
@@ -311,10 +318,11 @@ namespace occa {
 
         // Add kernel array as the first argument
         identifierToken kernelVarSource(kernelSmnt.source->origin,
-                                        "*deviceKernel");
+                                        "deviceKernel");
         variable_t &kernelVar = *(new variable_t(kernelType,
                                                  &kernelVarSource));
         kernelVar += pointer_t();
+        kernelVar += pointer_t();
 
         func.args.insert(func.args.begin(),
                          &kernelVar);
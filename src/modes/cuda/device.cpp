@@ -1,4 +1,5 @@
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/misc.hpp>
 #include <occa/tools/sys.hpp>
@@ -329,7 +330,11 @@ namespace occa {
         io::stdout << sCommand << '\n';
       }
 
-      const int compileError = system(sCommand.c_str());
+      int compileError;
+      {
+        buildStats::stageTimer timer(buildStage::compiling);
+        compileError = system(sCommand.c_str());
+      }
 
       lock.release();
       if (compileError) {
@@ -353,7 +358,10 @@ namespace occa {
       CUmodule cuModule;
       CUresult error;
 
-      error = cuModuleLoad(&cuModule, binaryFilename.c_str());
+      {
+        buildStats::stageTimer timer(buildStage::loading);
+        error = cuModuleLoad(&cuModule, binaryFilename.c_str());
+      }
       if (error) {
         lock.release();
         OCCA_CUDA_ERROR("Kernel [" + kernelName + "]: Loading Module",
@@ -1,4 +1,5 @@
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/io/output.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/misc.hpp>
@@ -301,7 +302,11 @@ namespace occa {
         io::stdout << sCommand << '\n';
       }
 
-      const int compileError = system(sCommand.c_str());
+      int compileError;
+      {
+        buildStats::stageTimer timer(buildStage::compiling);
+        compileError = system(sCommand.c_str());
+      }
 
       lock.release();
       if (compileError) {
@@ -325,7 +330,10 @@ namespace occa {
       hipModule_t hipModule;
       hipError_t error;
 
-      error = hipModuleLoad(&hipModule, binaryFilename.c_str());
+      {
+        buildStats::stageTimer timer(buildStage::loading);
+        error = hipModuleLoad(&hipModule, binaryFilename.c_str());
+      }
       if (error) {
         lock.release();
         OCCA_HIP_ERROR("Kernel [" + kernelName + "]: Loading Module",
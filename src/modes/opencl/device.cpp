@@ -1,4 +1,5 @@
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/sys.hpp>
 #include <occa/modes/opencl/device.hpp>
@@ -170,13 +171,16 @@ namespace occa {
       // Build OpenCL program
       std::string source = io::read(sourceFilename, true);
 
-      opencl::buildProgramFromSource(clInfo,
-                                     source,
-                                     kernelName,
-                                     kernelProps["compiler_flags"],
-                                     sourceFilename,
-                                     kernelProps,
-                                     lock);
+      {
+        buildStats::stageTimer timer(buildStage::compiling);
+        opencl::buildProgramFromSource(clInfo,
+                                       source,
+                                       kernelName,
+                                       kernelProps["compiler_flags"],
+                                       sourceFilename,
+                                       kernelProps,
+                                       lock);
+      }
 
       opencl::saveProgramBinary(clInfo,
                                 binaryFilename,
@@ -1,3 +1,4 @@
+#include <occa/core/buildStats.hpp>
 #include <occa/io/output.hpp>
 #include <occa/lang/modes/openmp.hpp>
 #include <occa/modes/serial/device.hpp>
@@ -21,7 +22,10 @@ namespace occa {
                            const occa::properties &kernelProps,
                            lang::sourceMetadata_t &metadata) {
       lang::okl::openmpParser parser(kernelProps);
-      parser.parseFile(filename);
+      {
+        buildStats::stageTimer timer(buildStage::parsing);
+        parser.parseFile(filename);
+      }
 
       // Verify if parsing succeeded
       if (!parser.succeeded()) {
@@ -31,6 +35,7 @@ namespace occa {
         return false;
       }
 
+      buildStats::stageTimer timer(buildStage::codegen);
       if (!io::isFile(outputFile)) {
         hash_t hash = occa::hash(outputFile);
         io::lock_t lock(hash, "openmp-parser");
@@ -44,34 +49,47 @@ namespace occa {
       return true;
     }
 
-    modeKernel_t* device::buildKernel(const std::string &filename,
-                                      const std::string &kernelName,
-                                      const hash_t kernelHash,
-                                      const occa::properties &kernelProps) {
-
+    occa::properties device::openmpKernelProps(const occa::properties &kernelProps,
+                                              bool &usingOpenMP) {
       occa::properties allKernelProps = properties + kernelProps;
 
       std::string compiler = allKernelProps["compiler"];
-      int vendor = allKernelProps["vendor"];
+      int vendor = allKernelProps["compiler_vendor"];
       // Check if we need to re-compute the vendor
       if (kernelProps.has("compiler")) {
         vendor = sys::compilerVendor(compiler);
       }
 
-      if (compiler != lastCompiler) {
-        lastCompiler = compiler;
-        lastCompilerOpenMPFlag = openmp::compilerFlag(vendor, compiler);
-
-        if (lastCompilerOpenMPFlag == openmp::notSupported) {
-          io::stderr << "Compiler [" << (std::string) allKernelProps["compiler"]
-                     << "] does not support OpenMP, defaulting to [Serial] mode\n";
+      std::string compilerOpenMPFlag;
+      {
+        // Kernels can be built concurrently
+        std::lock_guard<std::mutex> lock(kernelMutex);
+        if (compiler != lastCompiler) {
+          lastCompiler = compiler;
+          lastCompilerOpenMPFlag = openmp::compilerFlag(vendor, compiler);
+
+          if (lastCompilerOpenMPFlag == openmp::notSupported) {
+            io::stderr << "Compiler [" << (std::string) allKernelProps["compiler"]
+                       << "] does not support OpenMP, defaulting to [Serial] mode\n";
+          }
         }
+        compilerOpenMPFlag = lastCompilerOpenMPFlag;
       }
 
-      const bool usingOpenMP = (lastCompilerOpenMPFlag != openmp::notSupported);
+      usingOpenMP = (compilerOpenMPFlag != openmp::notSupported);
       if (usingOpenMP) {
-        allKernelProps["compiler_flags"] += " " + lastCompilerOpenMPFlag;
+        allKernelProps["compiler_flags"] += " " + compilerOpenMPFlag;
       }
+      return allKernelProps;
+    }
+
+    modeKernel_t* device::buildKernel(const std::string &filename,
+                                      const std::string &kernelName,
+                                      const hash_t kernelHash,
+                                      const occa::properties &kernelProps) {
+      bool usingOpenMP = false;
+      occa::properties allKernelProps = openmpKernelProps(kernelProps,
+                                                          usingOpenMP);
 
       modeKernel_t *k = serial::device::buildKernel(filename,
                                                     kernelName,
@@ -86,5 +104,19 @@ namespace occa {
 
       return k;
     }
+
+    bool device::buildKernels(const std::string &filename,
+                              const hash_t kernelHash,
+                              const occa::properties &kernelProps,
+                              std::vector<modeKernel_t*> &kernels) {
+      bool usingOpenMP = false;
+      occa::properties allKernelProps = openmpKernelProps(kernelProps,
+                                                          usingOpenMP);
+
+      return serial::device::buildKernels(filename,
+                                          kernelHash,
+                                          allKernelProps,
+                                          kernels);
+    }
   }
 }
@@ -35,6 +35,11 @@ namespace occa {
                              const std::string &compiler) {
 
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      std::string cachedFlag;
+      if (sys::getCompilerCapability(compiler, "openmp_flag", cachedFlag)) {
+        return cachedFlag;
+      }
+
       const std::string safeCompiler = io::slashToSnake(compiler);
       std::stringstream ss;
 
@@ -56,17 +61,18 @@ namespace occa {
         ss << compiler
            << ' '    << flag
            << ' '    << srcFilename
-           << " -o " << binaryFilename
-           << " > /dev/null 2>&1";
+           << " -o " << binaryFilename;
 
-        const std::string compileLine = ss.str();
-        const int compileError = system(compileLine.c_str());
+        const sys::spawnResult compileResult = sys::spawn(ss.str());
+        io::write(io::dirname(srcFilename) + kc::buildLogFile,
+                  compileResult.output);
 
-        if (compileError) {
+        if (!compileResult.succeeded()) {
           flag = openmp::notSupported;
         }
 
         io::write(outFilename, flag);
+        sys::setCompilerCapability(compiler, "openmp_flag", flag);
 
         return flag;
       }
@@ -74,6 +80,7 @@ namespace occa {
       std::string flag = openmp::notSupported;
       ss << io::read(outFilename);
       ss >> flag;
+      sys::setCompilerCapability(compiler, "openmp_flag", flag);
 
       return flag;
 #elif (OCCA_OS == OCCA_WINDOWS_OS)
@@ -1,6 +1,14 @@
+#include <occa/defines.hpp>
+
+#if OCCA_OPENMP_ENABLED
+#  include <omp.h>
+#endif
+
 #include <occa/core/base.hpp>
+#include <occa/core/buildStats.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/io.hpp>
+#include <occa/tools/lex.hpp>
 #include <occa/tools/sys.hpp>
 #include <occa/modes/serial/device.hpp>
 #include <occa/modes/serial/kernel.hpp>
@@ -11,6 +19,30 @@
 
 namespace occa {
   namespace serial {
+    namespace {
+      // Removes [-x <language>] flags, which would override [-x c++-header]
+      std::string removeLanguageFlags(const std::string &flags) {
+        std::string result;
+        const char *start = flags.c_str();
+        const char *c = start;
+        while (*c != '\0') {
+          if ((c[0] == '-') && (c[1] == 'x')
+              && ((c == start) || lex::isWhitespace(c[-1]))) {
+            c += 2;
+            while (lex::isWhitespace(*c)) {
+              ++c;
+            }
+            while ((*c != '\0') && !lex::isWhitespace(*c)) {
+              ++c;
+            }
+            continue;
+          }
+          result += *(c++);
+        }
+        return result;
+      }
+    }
+
     device::device(const occa::properties &properties_) :
       occa::modeDevice_t(properties_) {
 
@@ -129,7 +161,9 @@ namespace occa {
 
     device::~device() {}
 
-    void device::finish() const {}
+    void device::finish() const {
+      getSerialStream().finish();
+    }
 
     bool device::hasSeparateMemorySpace() const {
       return false;
@@ -160,10 +194,21 @@ namespace occa {
     }
 
     occa::streamTag device::tagStream() {
-      return new occa::serial::streamTag(this, sys::currentTime());
+      stream &stream_ = getSerialStream();
+      if (!stream_.isAsynchronous()) {
+        return new occa::serial::streamTag(this, sys::currentTime());
+      }
+      occa::serial::streamTag *tag = new occa::serial::streamTag(this, &stream_);
+      stream_.enqueue(new tagJob(tag));
+      return tag;
     }
 
-    void device::waitFor(occa::streamTag tag) {}
+    void device::waitFor(occa::streamTag tag) {
+      occa::serial::streamTag *srTag = (
+        dynamic_cast<occa::serial::streamTag*>(tag.getModeStreamTag())
+      );
+      srTag->wait();
+    }
 
     double device::timeBetween(const occa::streamTag &startTag,
                                const occa::streamTag &endTag) {
@@ -174,8 +219,27 @@ namespace occa {
         dynamic_cast<occa::serial::streamTag*>(endTag.getModeStreamTag())
       );
 
+      srStartTag->wait();
+      srEndTag->wait();
+
       return (srEndTag->time - srStartTag->time);
     }
+
+    stream& device::getSerialStream() const {
+      return *((stream*) currentStream.getModeStream());
+    }
+
+    void device::finishAllStreams() const {
+      gc::ringEntry_t *head = streamRing.head;
+      if (!head) {
+        return;
+      }
+      gc::ringEntry_t *entry = head;
+      do {
+        ((stream*) entry)->finish();
+        entry = entry->rightRingEntry;
+      } while (entry != head);
+    }
     //==================================
 
     //---[ Kernel ]---------------------
@@ -184,7 +248,10 @@ namespace occa {
                            const occa::properties &kernelProps,
                            lang::sourceMetadata_t &metadata) {
       lang::okl::serialParser parser(kernelProps);
-      parser.parseFile(filename);
+      {
+        buildStats::stageTimer timer(buildStage::parsing);
+        parser.parseFile(filename);
+      }
 
       // Verify if parsing succeeded
       if (!parser.succeeded()) {
@@ -193,6 +260,7 @@ namespace occa {
         return false;
       }
 
+      buildStats::stageTimer timer(buildStage::codegen);
       if (!io::isFile(outputFile)) {
         hash_t hash = occa::hash(outputFile);
         io::lock_t lock(hash, "serial-parser");
@@ -224,6 +292,93 @@ namespace occa {
                                       const hash_t kernelHash,
                                       const occa::properties &kernelProps,
                                       const bool isLauncherKernel) {
+      lang::sourceMetadata_t metadata;
+      bool compiled = false;
+      const std::string binaryFilename = buildBinary(filename,
+                                                     kernelName,
+                                                     kernelHash,
+                                                     kernelProps,
+                                                     isLauncherKernel,
+                                                     metadata,
+                                                     compiled);
+      if (!binaryFilename.size()) {
+        return NULL;
+      }
+
+      modeKernel_t *k = (
+        compiled
+        ? buildKernelFromBinary(binaryFilename,
+                                kernelName,
+                                kernelProps,
+                                metadata.kernelsMetadata[kernelName])
+        : buildKernelFromBinary(binaryFilename,
+                                kernelName,
+                                kernelProps)
+      );
+      if (k) {
+        if (compiled) {
+          io::markCachedFileComplete(io::dirname(binaryFilename),
+                                     isLauncherKernel ? kc::launcherBinaryFile : kc::binaryFile);
+        }
+        k->sourceFilename = filename;
+      }
+      return k;
+    }
+
+    bool device::buildKernels(const std::string &filename,
+                              const hash_t kernelHash,
+                              const occa::properties &kernelProps,
+                              std::vector<modeKernel_t*> &kernels) {
+      OCCA_ERROR("Only OKL sources can be built without a kernel name",
+                 kernelProps.get("okl/enabled", true));
+
+      lang::sourceMetadata_t metadata;
+      bool compiled = false;
+      const std::string binaryFilename = buildBinary(filename,
+                                                     io::basename(filename),
+                                                     kernelHash,
+                                                     kernelProps,
+                                                     false,
+                                                     metadata,
+                                                     compiled);
+      if (!binaryFilename.size()) {
+        return false;
+      }
+      if (!compiled) {
+        metadata = lang::sourceMetadata_t::fromBuildFile(
+          io::dirname(binaryFilename) + kc::buildFile
+        );
+      }
+
+      // Every kernel uses the same binary, load it once
+      sharedDlHandle_t dlHandle = openBinary(binaryFilename);
+
+      lang::kernelMetadataMap &kernelsMetadata = metadata.kernelsMetadata;
+      lang::kernelMetadataMap::iterator it = kernelsMetadata.begin();
+      while (it != kernelsMetadata.end()) {
+        modeKernel_t *k = buildKernelFromBinary(dlHandle,
+                                                binaryFilename,
+                                                it->first,
+                                                kernelProps,
+                                                it->second);
+        k->sourceFilename = filename;
+        kernels.push_back(k);
+        ++it;
+      }
+
+      if (compiled) {
+        io::markCachedFileComplete(io::dirname(binaryFilename), kc::binaryFile);
+      }
+      return true;
+    }
+
+    std::string device::buildBinary(const std::string &filename,
+                                    const std::string &label,
+                                    const hash_t kernelHash,
+                                    const occa::properties &kernelProps,
+                                    const bool isLauncherKernel,
+                                    lang::sourceMetadata_t &metadata,
+                                    bool &compiled) {
       const std::string hashDir = io::hashDir(filename, kernelHash);
 
       const std::string &kcBinaryFile = (
@@ -232,12 +387,10 @@ namespace occa {
         : kc::binaryFile
       );
       std::string binaryFilename = hashDir + kcBinaryFile;
+      compiled = false;
 
       // Check if binary exists and is finished
-      bool foundBinary = (
-        io::cachedFileIsComplete(hashDir, kcBinaryFile)
-        && io::isFile(binaryFilename)
-      );
+      bool foundBinary = io::cachedFileIsComplete(hashDir, kcBinaryFile);
 
       io::lock_t lock;
       if (!foundBinary) {
@@ -247,24 +400,21 @@ namespace occa {
 
       const bool verbose = kernelProps.get("verbose", false);
       if (foundBinary) {
+        // Launcher binaries are counted by the launched device
+        if (!isLauncherKernel) {
+          buildStats::addDiskCacheHit();
+        }
         if (verbose) {
           io::stdout << "Loading cached ["
-                     << kernelName
+                     << label
                      << "] from ["
                      << io::shortname(filename)
                      << "] in [" << io::shortname(binaryFilename) << "]\n";
         }
-        modeKernel_t *k = buildKernelFromBinary(binaryFilename,
-                                                kernelName,
-                                                kernelProps);
-        if (k) {
-          k->sourceFilename = filename;
-        }
-        return k;
+        return binaryFilename;
       }
 
       std::string sourceFilename;
-      lang::sourceMetadata_t metadata;
       const bool compilingOkl = kernelProps.get("okl/enabled", true);
       const bool compilingCpp = (
         ((int) kernelProps["compiler_language"]) == sys::language::CPP
@@ -280,12 +430,15 @@ namespace occa {
         );
 
         // Cache raw origin
-        sourceFilename = (
-          io::cacheFile(filename,
-                        rawSourceFile,
-                        kernelHash,
-                        assembleKernelHeader(kernelProps))
-        );
+        {
+          buildStats::stageTimer timer(buildStage::codegen);
+          sourceFilename = (
+            io::cacheFile(filename,
+                          rawSourceFile,
+                          kernelHash,
+                          assembleKernelHeader(kernelProps))
+          );
+        }
 
         if (compilingOkl) {
           const std::string outputFile = hashDir + kc::sourceFile;
@@ -294,7 +447,7 @@ namespace occa {
                                  kernelProps,
                                  metadata);
           if (!valid) {
-            return NULL;
+            return "";
           }
           sourceFilename = outputFile;
 
@@ -321,6 +474,13 @@ namespace occa {
       if (!compilingOkl) {
         sys::addCompilerIncludeFlags(compilerFlags);
         sys::addCompilerLibraryFlags(compilerFlags);
+      } else if (!isLauncherKernel) {
+        const std::string headerFlags = precompiledHeaderFlags(kernelProps,
+                                                               compilerFlags);
+        if (headerFlags.size()) {
+          compilerFlags += ' ';
+          compilerFlags += headerFlags;
+        }
       }
 
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
@@ -351,31 +511,286 @@ namespace occa {
 
       const std::string &sCommand = strip(command.str());
 
+      // Builds with the same emitted source and compiler command share binaries,
+      //   such as builds with unused defines
+      hash_t contentHash;
+      const bool sharesBinary = (
+        (compilingOkl || isLauncherKernel)
+        && io::sharesBinaries()
+      );
+      if (sharesBinary) {
+        std::stringstream commandKey;
+        commandKey << OCCA_VERSION_STR << '\n'
+                   << compilerEnvScript << '\n'
+                   << compiler << '\n'
+                   << compilerFlags << '\n'
+                   << compilerLinkerFlags << '\n'
+                   << env::OCCA_DIR << '\n'
+                   << env::OCCA_INSTALL_DIR;
+        {
+          buildStats::stageTimer timer(buildStage::hashing);
+          contentHash = hashFile(sourceFilename) ^ occa::hash(commandKey.str());
+        }
+
+        const std::string sharedBinary = io::linkCachedBinary(contentHash,
+                                                              binaryFilename);
+        if (sharedBinary.size()) {
+          if (!isLauncherKernel) {
+            buildStats::addSharedBinaryHit();
+          }
+          if (verbose) {
+            io::stdout << "Reusing binary for ["
+                       << label
+                       << "] from [" << io::shortname(sharedBinary) << "]\n";
+          }
+          lock.release();
+          compiled = true;
+          return binaryFilename;
+        }
+      }
+
       if (verbose) {
-        io::stdout << "Compiling [" << kernelName << "]\n" << sCommand << "\n";
+        io::stdout << "Compiling [" << label << "]\n" << sCommand << "\n";
       }
 
+      if (!isLauncherKernel) {
+        buildStats::addCacheMiss();
+      }
+      sys::spawnResult compileResult;
+      {
+        buildStats::stageTimer timer(buildStage::compiling);
+        compileResult = sys::spawn(sCommand);
+      }
+      io::write(hashDir + kc::buildLogFile, compileResult.output);
+      if (verbose || !compileResult.succeeded()) {
+        io::stderr << compileResult.output;
+      }
+
+      lock.release();
+      if (compileResult.timedOut) {
+        OCCA_FORCE_ERROR("Timed out compiling [" << label << "],"
+                         " Command: [" << sCommand << ']');
+      }
+      if (!compileResult.succeeded()) {
+        OCCA_FORCE_ERROR("Error compiling [" << label << "],"
+                         " Command: [" << sCommand << ']');
+      }
+
+      if (sharesBinary) {
+        io::addCachedBinary(contentHash, binaryFilename);
+      }
+
+      compiled = true;
+      return binaryFilename;
+    }
+
+    std::string device::precompiledHeaderFlags(const occa::properties &kernelProps,
+                                               const std::string &compilerFlags) {
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-      const int compileError = system(sCommand.c_str());
+      if (!kernelProps.get("serial/pch", true)
+          || (((int) kernelProps["compiler_language"]) != sys::language::CPP)) {
+        return "";
+      }
+
+      const std::string compiler = kernelProps["compiler"];
+      int vendor = kernelProps["compiler_vendor"];
+      // Check if we need to re-compute the vendor
+      if (compiler != (std::string) properties["kernel/compiler"]) {
+        vendor = sys::compilerVendor(compiler);
+      }
+      if (!(vendor & (sys::vendor::GNU | sys::vendor::LLVM))) {
+        return "";
+      }
+
+      // Same headers as lang::okl::serialParser::setupHeaders()
+      std::string headerContent;
+      if (kernelProps.get("serial/include_std", true)) {
+        headerContent += (
+          "#include <cmath>\n"
+          "#include <cstdio>\n"
+          "#include <cstdlib>\n"
+          "#include <stdint.h>\n"
+        );
+      }
+      headerContent += "#include <occa.hpp>\n";
+
+      // Uses the same compiler settings as the kernel hash
+      const std::string compilerEnvScript = kernelProps["compiler_env_script"];
+      const hash_t pchHash = (
+        occa::hash(OCCA_VERSION_STR)
+        ^ kernelHash(kernelProps)
+        ^ occa::hash(compilerFlags)
+        ^ occa::hash(headerContent)
+        ^ occa::hash(env::OCCA_DIR)
+        ^ occa::hash(env::OCCA_INSTALL_DIR)
+      );
+      const std::string pchKey = pchHash.getFullString();
+      {
+        std::lock_guard<std::mutex> lock(pchMutex);
+        std::map<std::string, std::string>::iterator it = pchFlags.find(pchKey);
+        if (it != pchFlags.end()) {
+          return it->second;
+        }
+      }
+
+      const std::string hashDir = io::hashDir(pchHash);
+      const std::string headerFilename = hashDir + kc::pchHeaderFile;
+      const bool usingGcc = (vendor & sys::vendor::GNU);
+      const std::string pchFile = kc::pchHeaderFile + (usingGcc ? ".gch" : ".pch");
+      const std::string pchFilename = hashDir + pchFile;
+
+      const std::string tempFilename = pchFilename + ".building";
+      const std::string depFilename = hashDir + "pch.d";
+
+      std::stringstream command;
+      if (compilerEnvScript.size()) {
+        command << compilerEnvScript << " && ";
+      }
+      command << compiler
+              << ' '    << removeLanguageFlags(compilerFlags)
+              << " -x c++-header " << headerFilename
+              << " -o " << tempFilename
+              << " -MD -MF " << depFilename
+              << " -I"  << env::OCCA_DIR << "include"
+              << " -I"  << env::OCCA_INSTALL_DIR << "include";
+
+      // Don't retry the same compiler and command after they failed,
+      //   replacing the compiler changes its stamp
+      const std::string failedFilename = hashDir + "pch.failed";
+      const std::string failedKey = sys::compilerStamp(compiler) + '\n' + command.str();
+      bool foundPch = (
+        io::cachedFileIsComplete(hashDir, pchFile)
+        && !precompiledHeaderIsStale(hashDir)
+      );
+      if (!foundPch
+          && (!io::isFile(failedFilename)
+              || (io::read(failedFilename) != failedKey))) {
+        io::lock_t lock(pchHash, "serial-pch");
+        if (lock.isMine()) {
+          // The content is part of the hash, only a missing header is written
+          // Other processes can be reading it, rename it into place
+          if (!io::isFile(headerFilename)) {
+            const std::string tempHeaderFilename = (
+              headerFilename + ".writing_" + toString(sys::getPID())
+            );
+            io::write(tempHeaderFilename, headerContent);
+            if (::rename(tempHeaderFilename.c_str(), headerFilename.c_str())) {
+              std::remove(tempHeaderFilename.c_str());
+            }
+          }
+
+          sys::spawnResult compileResult;
+          {
+            buildStats::stageTimer timer(buildStage::compiling);
+            compileResult = sys::spawn(command.str());
+          }
+          io::write(hashDir + kc::buildLogFile, compileResult.output);
+
+          if (compileResult.succeeded()
+              && !::rename(tempFilename.c_str(), pchFilename.c_str())) {
+            writePrecompiledHeaderDependencies(hashDir, depFilename);
+            io::markCachedFileComplete(hashDir, pchFile);
+            std::remove(failedFilename.c_str());
+            foundPch = true;
+          } else {
+            io::write(failedFilename, failedKey);
+            if (kernelProps.get("verbose", false)) {
+              io::stderr << "Unable to build the precompiled header, command: ["
+                         << command.str() << "]\n";
+            }
+          }
+          std::remove(tempFilename.c_str());
+        } else {
+          foundPch = io::cachedFileIsComplete(hashDir, pchFile);
+        }
+      }
+
+      std::string headerFlags;
+      if (foundPch) {
+        io::markCacheAccess(hashDir);
+        // Compilers fall back to the header if they can't use the PCH
+        headerFlags = "-include " + headerFilename;
+      }
+
+      std::lock_guard<std::mutex> lock(pchMutex);
+      pchFlags[pchKey] = headerFlags;
+      return headerFlags;
 #else
-      const int compileError = system(("\"" +  sCommand + "\"").c_str());
+      return "";
 #endif
+    }
 
-      lock.release();
-      if (compileError) {
-        OCCA_FORCE_ERROR("Error compiling [" << kernelName << "],"
-                         " Command: [" << sCommand << ']');
+    bool device::precompiledHeaderIsStale(const std::string &hashDir) {
+      const std::string dependenciesFile = hashDir + kc::pchDependenciesFile;
+      if (!io::isFile(dependenciesFile)) {
+        return true;
       }
 
-      modeKernel_t *k = buildKernelFromBinary(binaryFilename,
-                                              kernelName,
-                                              kernelProps,
-                                              metadata.kernelsMetadata[kernelName]);
-      if (k) {
-        io::markCachedFileComplete(hashDir, kcBinaryFile);
-        k->sourceFilename = filename;
+      json dependencies = json::read(dependenciesFile);
+      if (!dependencies.isObject()) {
+        return true;
       }
-      return k;
+
+      const jsonObject &dependencyHashes = dependencies.object();
+      jsonObject::const_iterator it = dependencyHashes.begin();
+      while (it != dependencyHashes.end()) {
+        const std::string &dependency = it->first;
+        if (!io::isFile(dependency)
+            || (hashFile(dependency).getFullString() != (std::string) it->second)) {
+          return true;
+        }
+        ++it;
+      }
+      return false;
+    }
+
+    void device::writePrecompiledHeaderDependencies(const std::string &hashDir,
+                                                    const std::string &depFilename) {
+      // Make rules look like [target: dep1 dep2 \<newline> dep3]
+      //   with spaces in paths escaped as [\ ]
+      const std::string rules = io::read(depFilename);
+      const int chars = (int) rules.size();
+
+      json dependencies(json::object_);
+      std::string dependency;
+      bool foundTarget = false;
+      for (int i = 0; i <= chars; ++i) {
+        const char c = (i < chars) ? rules[i] : '\n';
+        if ((c == '\\') && ((i + 1) < chars)) {
+          const char next = rules[i + 1];
+          if (next == ' ') {
+            dependency += ' ';
+            ++i;
+            continue;
+          }
+          if ((next == '\n') || (next == '\r')) {
+            continue;
+          }
+        }
+        if ((c != ' ') && (c != '\t') && (c != '\n') && (c != '\r')) {
+          dependency += c;
+          continue;
+        }
+        if (!dependency.size()) {
+          continue;
+        }
+        if (!foundTarget) {
+          foundTarget = (dependency[dependency.size() - 1] == ':');
+        } else {
+          dependencies.set(dependency,
+                           hashFile(dependency).getFullString());
+        }
+        dependency.clear();
+      }
+
+      dependencies.write(hashDir + kc::pchDependenciesFile);
+      std::remove(depFilename.c_str());
+    }
+
+    sharedDlHandle_t device::openBinary(const std::string &filename) {
+      buildStats::stageTimer timer(buildStage::loading);
+      return sharedDlHandle_t(sys::dlopen(filename),
+                              sys::dlclose);
     }
 
     modeKernel_t* device::buildKernelFromBinary(const std::string &filename,
@@ -400,6 +815,18 @@ namespace occa {
                                                 const std::string &kernelName,
                                                 const occa::properties &kernelProps,
                                                 lang::kernelMetadata_t &metadata) {
+      return buildKernelFromBinary(openBinary(filename),
+                                   filename,
+                                   kernelName,
+                                   kernelProps,
+                                   metadata);
+    }
+
+    modeKernel_t* device::buildKernelFromBinary(sharedDlHandle_t dlHandle,
+                                                const std::string &filename,
+                                                const std::string &kernelName,
+                                                const occa::properties &kernelProps,
+                                                lang::kernelMetadata_t &metadata) {
       kernel &k = *(new kernel(this,
                                kernelName,
                                filename,
@@ -408,14 +835,118 @@ namespace occa {
       k.binaryFilename = filename;
       k.metadata = metadata;
 
-      k.dlHandle = sys::dlopen(filename);
-      k.function = sys::dlsym(k.dlHandle, kernelName);
+      buildStats::stageTimer timer(buildStage::loading);
+      k.dlHandle = dlHandle;
+      k.function = sys::dlsym(k.dlHandle.get(), kernelName);
+      // Native kernels and older binaries don't have an entry
+      //   serial/kernel_entry: false launches through sys::runFunction instead
+      if (kernelProps.get("serial/kernel_entry", true)) {
+        k.entry = (kernelEntry_t) sys::dlsymIfExists(
+          k.dlHandle.get(),
+          lang::okl::serialParser::kernelEntryName(kernelName)
+        );
+      }
 
       return &k;
     }
     //==================================
 
     //---[ Memory ]-------------------
+    namespace {
+      // Initializes pages with the static schedule used by OpenMP outer loops
+      //   so they are placed on the NUMA node of the thread using them
+      int firstTouch(char *ptr,
+                     const void *src,
+                     const udim_t bytes) {
+        const udim_t pageBytes = sys::pageBytes();
+        const dim_t pages = (dim_t) ((bytes + pageBytes - 1) / pageBytes);
+
+#if OCCA_OPENMP_ENABLED
+#pragma omp parallel for schedule(static)
+#endif
+        for (dim_t i = 0; i < pages; ++i) {
+          const udim_t offset = i * pageBytes;
+          const udim_t touchBytes = std::min(pageBytes, bytes - offset);
+          if (src) {
+            ::memcpy(ptr + offset, (const char*) src + offset, touchBytes);
+          } else {
+            ::memset(ptr + offset, 0, touchBytes);
+          }
+        }
+
+#if OCCA_OPENMP_ENABLED
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+      }
+
+      // Maps pages for the numa and huge_pages properties
+      //   numa: 'interleave' | 'first_touch' | <node>
+      //   huge_pages: true
+      // The applied layout is stored in the memory's [layout] property
+      void placedMalloc(memory &mem,
+                        const void *src) {
+        const udim_t bytes = mem.size;
+        const occa::properties &props = mem.properties;
+        const json &numa = props["numa"];
+        const bool hugePages = props.get("huge_pages", false);
+
+        const std::string numaMode = numa.isString() ? numa.string() : "";
+        OCCA_ERROR("[Serial] Memory property [numa] should be 'interleave', 'first_touch', or a node",
+                   !props.has("numa")
+                   || numa.isNumber()
+                   || (numaMode == "interleave")
+                   || (numaMode == "first_touch"));
+
+        // Policies are set on whole pages, which are mapped for this memory
+        //   alone so they don't outlive it in the heap
+        const udim_t alignment = hugePages ? sys::hugePageBytes() : sys::pageBytes();
+        const udim_t alignedBytes = alignment * ((bytes + alignment - 1) / alignment);
+        char *ptr = (char*) sys::mapPages(alignedBytes, alignment);
+        OCCA_ERROR("[Serial] Unable to allocate " << alignedBytes << " bytes",
+                   ptr != NULL);
+        mem.ptr = ptr;
+        mem.mappedPtr = ptr;
+        mem.mappedBytes = alignedBytes;
+
+        json layout(json::object_);
+        layout["alignment"] = (double) alignment;
+        layout["huge_pages"] = (hugePages
+                                && sys::adviseHugePages(ptr, alignedBytes));
+
+        // Fall back to the default policy if the NUMA policy can't be set
+        std::string policy = "default";
+        if (numa.isNumber()) {
+          const int node = (int) numa;
+          if (sys::bindMemory(ptr, alignedBytes, node)) {
+            policy = "bind";
+            layout["numa_nodes"].asArray() += node;
+          }
+        } else if (numaMode == "interleave") {
+          const intVector nodes = sys::numaNodes();
+          if (sys::interleaveMemory(ptr, alignedBytes, nodes)) {
+            policy = "interleave";
+            json &nodesJson = layout["numa_nodes"].asArray();
+            const int nodeCount = (int) nodes.size();
+            for (int i = 0; i < nodeCount; ++i) {
+              nodesJson += nodes[i];
+            }
+          }
+        } else if (numaMode == "first_touch") {
+          policy = "first_touch";
+          layout["first_touch_threads"] = firstTouch(ptr, src, bytes);
+          src = NULL;
+        }
+        layout["numa"] = policy;
+        mem.properties["layout"] = layout;
+
+        if (src) {
+          ::memcpy(ptr, src, bytes);
+        }
+      }
+    }
+
     modeMemory_t* device::malloc(const udim_t bytes,
                                  const void *src,
                                  const occa::properties &props) {
@@ -424,6 +955,8 @@ namespace occa {
       if (src && props.get("use_host_pointer", false)) {
         mem->ptr = (char*) const_cast<void*>(src);
         mem->isOrigin = props.get("own_host_pointer", false);
+      } else if (props.has("numa") || props.get("huge_pages", false)) {
+        placedMalloc(*mem, src);
       } else {
         mem->ptr = (char*) sys::malloc(bytes);
         if (src) {
@@ -434,6 +967,41 @@ namespace occa {
       return mem;
     }
 
+    modeMemory_t* device::mmap(const std::string &filename,
+                               const udim_t offset,
+                               const udim_t bytes,
+                               const occa::properties &props) {
+      // Mappings start at a page boundary
+      const udim_t pageOffset = offset % sys::pageBytes();
+      const udim_t mappedBytes = pageOffset + bytes;
+      void *mappedPtr = sys::mmapFile(filename,
+                                      offset - pageOffset,
+                                      mappedBytes,
+                                      props.get("read_only", false));
+
+      const json &advise = props["advise"];
+      strVector advice;
+      if (advise.isString()) {
+        advice.push_back(advise.string());
+      } else if (advise.isArray()) {
+        advice = advise.getArray<std::string>();
+      }
+      const int adviceCount = (int) advice.size();
+      for (int i = 0; i < adviceCount; ++i) {
+        if (!sys::adviseMemory(mappedPtr, mappedBytes, advice[i])) {
+          sys::munmap(mappedPtr, mappedBytes);
+          OCCA_FORCE_ERROR("[Serial] Unable to set memory advice [" << advice[i] << "]");
+        }
+      }
+
+      memory *mem = new memory(this, bytes, props);
+      mem->mappedPtr = mappedPtr;
+      mem->mappedBytes = mappedBytes;
+      mem->ptr = (char*) mappedPtr + pageOffset;
+
+      return mem;
+    }
+
     udim_t device::memorySize() const {
       return sys::installedRAM();
     }
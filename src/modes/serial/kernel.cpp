@@ -1,25 +1,50 @@
 #include <occa/core/base.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/io.hpp>
+#include <occa/modes/serial/device.hpp>
 #include <occa/modes/serial/kernel.hpp>
+#include <occa/modes/serial/stream.hpp>
 #include <occa/lang/modes/serial.hpp>
 
 namespace occa {
   namespace serial {
+    namespace {
+      // Keeps a copy of the arguments since they can change before the launch
+      class kernelLaunchJob : public streamJob {
+      public:
+        const kernel &kernel_;
+        std::vector<kernelArgData> arguments;
+
+        kernelLaunchJob(const kernel &kernel__,
+                        const std::vector<kernelArgData> &arguments_) :
+          kernel_(kernel__),
+          arguments(arguments_) {}
+
+        void run() {
+          const int args = (int) arguments.size();
+          std::vector<void*> vArgs(args ? args : 1);
+          for (int i = 0; i < args; ++i) {
+            vArgs[i] = arguments[i].ptr();
+          }
+          kernel_.launch(&(vArgs[0]), args);
+        }
+      };
+    }
+
     kernel::kernel(modeDevice_t *modeDevice_,
                    const std::string &name_,
                    const std::string &sourceFilename_,
                    const occa::properties &properties_) :
       occa::modeKernel_t(modeDevice_, name_, sourceFilename_, properties_),
-      dlHandle(NULL),
       function(NULL),
+      entry(NULL),
       isLauncherKernel(false) {}
 
     kernel::~kernel() {
-      if (dlHandle) {
-        sys::dlclose(dlHandle);
-        dlHandle = NULL;
+      if (!isLauncherKernel && modeDevice) {
+        ((device*) modeDevice)->finishAllStreams();
       }
+      dlHandle.reset();
     }
 
     int kernel::maxDims() const {
@@ -38,7 +63,21 @@ namespace occa {
       return metadata;
     }
 
+    bool kernel::hasArgumentLimit() const {
+      // Only sys::runFunction is limited to OCCA_MAX_ARGS arguments
+      return !entry;
+    }
+
     void kernel::run() const {
+      // Launcher kernels are ran inline by their launched kernel
+      if (!isLauncherKernel) {
+        stream &stream_ = ((device*) modeDevice)->getSerialStream();
+        if (stream_.isAsynchronous()) {
+          stream_.enqueue(new kernelLaunchJob(*this, arguments));
+          return;
+        }
+      }
+
       const int args = (int) arguments.size();
       if (!args) {
         vArgs.resize(1);
@@ -51,7 +90,16 @@ namespace occa {
         vArgs[i] = arguments[i].ptr();
       }
 
-      sys::runFunction(function, args, &(vArgs[0]));
+      launch(&(vArgs[0]), args);
+    }
+
+    void kernel::launch(void **args,
+                        const int argCount) const {
+      if (entry) {
+        entry(args);
+      } else {
+        sys::runFunction(function, argCount, args);
+      }
     }
   }
 }
@@ -1,4 +1,6 @@
+#include <occa/modes/serial/device.hpp>
 #include <occa/modes/serial/memory.hpp>
+#include <occa/modes/serial/stream.hpp>
 #include <occa/tools/sys.hpp>
 #include <occa/core/device.hpp>
 
@@ -7,11 +9,20 @@ namespace occa {
     memory::memory(modeDevice_t *modeDevice_,
                    udim_t size_,
                    const occa::properties &properties_) :
-      occa::modeMemory_t(modeDevice_, size_, properties_) {}
+      occa::modeMemory_t(modeDevice_, size_, properties_),
+      mappedPtr(NULL),
+      mappedBytes(0) {}
 
     memory::~memory() {
       if (ptr && isOrigin) {
-        sys::free(ptr);
+        if (modeDevice) {
+          ((device*) modeDevice)->finishAllStreams();
+        }
+        if (mappedPtr) {
+          sys::munmap(mappedPtr, mappedBytes);
+        } else {
+          sys::free(ptr);
+        }
       }
       ptr = NULL;
       size = 0;
@@ -42,7 +53,7 @@ namespace occa {
                         const occa::properties &props) const {
       const void *srcPtr = ptr + offset;
 
-      ::memcpy(dest, srcPtr, bytes);
+      copy(dest, srcPtr, bytes, props);
     }
 
     void memory::copyFrom(const void *src,
@@ -53,7 +64,7 @@ namespace occa {
       void *destPtr      = ptr + offset;
       const void *srcPtr = src;
 
-      ::memcpy(destPtr, srcPtr, bytes);
+      copy(destPtr, srcPtr, bytes, props);
     }
 
     void memory::copyFrom(const modeMemory_t *src,
@@ -65,12 +76,32 @@ namespace occa {
       void *destPtr      = ptr + destOffset;
       const void *srcPtr = src->ptr + srcOffset;
 
-      ::memcpy(destPtr, srcPtr, bytes);
+      copy(destPtr, srcPtr, bytes, props);
     }
 
     void memory::detach() {
+      mappedPtr = NULL;
       ptr = NULL;
       size = 0;
     }
+
+    void memory::copy(void *dest,
+                      const void *src,
+                      const udim_t bytes,
+                      const occa::properties &props) const {
+      stream &stream_ = ((device*) modeDevice)->getSerialStream();
+      if (!stream_.isAsynchronous()) {
+        ::memcpy(dest, src, bytes);
+        return;
+      }
+
+      if (props.get("async", false)) {
+        stream_.enqueue(new memcpyJob(dest, src, bytes));
+      } else {
+        // Blocking copies wait for the queued work, same as other modes
+        stream_.finish();
+        ::memcpy(dest, src, bytes);
+      }
+    }
   }
 }
@@ -1,5 +1,6 @@
 #include <occa/defines.hpp>
 
+#include <occa/modes/serial/stream.hpp>
 #include <occa/modes/serial/streamTag.hpp>
 
 namespace occa {
@@ -7,8 +8,32 @@ namespace occa {
     streamTag::streamTag(modeDevice_t *modeDevice_,
                          double time_) :
       modeStreamTag_t(modeDevice_),
-      time(time_) {}
+      time(time_),
+      stream_(NULL),
+      completed(true) {}
 
-    streamTag::~streamTag() {}
+    streamTag::streamTag(modeDevice_t *modeDevice_,
+                         stream *stream__) :
+      modeStreamTag_t(modeDevice_),
+      time(0),
+      stream_(stream__),
+      completed(false) {}
+
+    streamTag::~streamTag() {
+      // The stream worker still holds a pointer to the tag
+      wait();
+    }
+
+    bool streamTag::isCompleted() const {
+      return completed.load(std::memory_order_acquire);
+    }
+
+    void streamTag::wait() const {
+      // Streams are drained before being freed, so stream_ is
+      //   only accessed while the tag is pending
+      if (!isCompleted()) {
+        stream_->waitFor(*this);
+      }
+    }
   }
 }
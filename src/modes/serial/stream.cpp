@@ -1,11 +1,230 @@
+#include <cstring>
+
 #include <occa/modes/serial/stream.hpp>
+#include <occa/modes/serial/streamTag.hpp>
+#include <occa/tools/sys.hpp>
 
 namespace occa {
   namespace serial {
+    //---[ streamJob ]------------------
+    streamJob::streamJob() :
+      next(NULL) {}
+
+    streamJob::~streamJob() {}
+
+    memcpyJob::memcpyJob(void *dest_,
+                         const void *src_,
+                         const udim_t bytes_) :
+      dest(dest_),
+      src(src_),
+      bytes(bytes_) {}
+
+    void memcpyJob::run() {
+      ::memcpy(dest, src, bytes);
+    }
+
+    tagJob::tagJob(streamTag *tag_) :
+      tag(tag_) {}
+
+    void tagJob::run() {
+      tag->time = sys::currentTime();
+      tag->completed.store(true, std::memory_order_release);
+    }
+    //==================================
+
+    //---[ stream ]---------------------
+    namespace {
+      // Stand-in job used to keep the queue non-empty
+      class stubStreamJob : public streamJob {
+      public:
+        void run() {}
+      };
+
+      // Spin for a bit before sleeping on short waits
+      const int spinIterations = 256;
+    }
+
     stream::stream(modeDevice_t *modeDevice_,
                    const occa::properties &properties_) :
-      modeStream_t(modeDevice_, properties_) {}
+      modeStream_t(modeDevice_, properties_),
+      isAsync(properties_.get("async", false)),
+      queueTail(NULL),
+      queueHead(NULL),
+      stubJob(NULL),
+      submittedJobs(0),
+      completedJobs(0),
+      workerIsSleeping(false),
+      waitingThreads(0),
+      workerIsDone(false) {
+      if (!isAsync) {
+        return;
+      }
+      stubJob = new stubStreamJob();
+      queueHead = stubJob;
+      queueTail.store(stubJob);
+
+      worker = std::thread(&stream::runWorker, this);
+    }
+
+    stream::~stream() {
+      if (!isAsync) {
+        return;
+      }
+      finish();
+      {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        workerIsDone = true;
+      }
+      workerCondition.notify_one();
+      worker.join();
+
+      delete stubJob;
+    }
+
+    bool stream::isAsynchronous() const {
+      return isAsync;
+    }
+
+    void stream::enqueue(streamJob *job) {
+      if (!isAsync) {
+        job->run();
+        delete job;
+        return;
+      }
+      // Count the job before pushing it so the worker never sleeps on it
+      submittedJobs.fetch_add(1);
+      pushJob(job);
+
+      if (workerIsSleeping.load()) {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        workerCondition.notify_one();
+      }
+    }
+
+    void stream::finish() {
+      if (!isAsync) {
+        return;
+      }
+      const udim_t jobs = submittedJobs.load();
+      if (completedJobs.load() >= jobs) {
+        return;
+      }
+      for (int i = 0; i < spinIterations; ++i) {
+        std::this_thread::yield();
+        if (completedJobs.load() >= jobs) {
+          return;
+        }
+      }
+
+      waitingThreads.fetch_add(1);
+      {
+        std::unique_lock<std::mutex> lock(workerMutex);
+        while (completedJobs.load() < jobs) {
+          completionCondition.wait(lock);
+        }
+      }
+      waitingThreads.fetch_sub(1);
+    }
+
+    void stream::waitFor(const streamTag &tag) {
+      if (tag.isCompleted()) {
+        return;
+      }
+      for (int i = 0; i < spinIterations; ++i) {
+        std::this_thread::yield();
+        if (tag.isCompleted()) {
+          return;
+        }
+      }
+
+      waitingThreads.fetch_add(1);
+      {
+        std::unique_lock<std::mutex> lock(workerMutex);
+        while (!tag.isCompleted()) {
+          completionCondition.wait(lock);
+        }
+      }
+      waitingThreads.fetch_sub(1);
+    }
+
+    void stream::pushJob(streamJob *job) {
+      job->next.store(NULL, std::memory_order_relaxed);
+      streamJob *prev = queueTail.exchange(job, std::memory_order_acq_rel);
+      prev->next.store(job, std::memory_order_release);
+    }
+
+    streamJob* stream::popJob() {
+      streamJob *head = queueHead;
+      streamJob *next = head->next.load(std::memory_order_acquire);
+
+      // Skip the stub
+      if (head == stubJob) {
+        if (!next) {
+          return NULL;
+        }
+        queueHead = next;
+        head = next;
+        next = next->next.load(std::memory_order_acquire);
+      }
+
+      if (next) {
+        queueHead = next;
+        return head;
+      }
+
+      // A producer is still linking its job
+      if (head != queueTail.load(std::memory_order_acquire)) {
+        return NULL;
+      }
+
+      // Push the stub back to detach the last job
+      pushJob(stubJob);
+      next = head->next.load(std::memory_order_acquire);
+      if (next) {
+        queueHead = next;
+        return head;
+      }
+      return NULL;
+    }
+
+    void stream::runWorker() {
+      while (true) {
+        streamJob *job = popJob();
+        if (job) {
+          job->run();
+          delete job;
+          completedJobs.fetch_add(1);
+          notifyWaitingThreads();
+          continue;
+        }
+
+        // A job was submitted but is not linked yet
+        if (completedJobs.load() != submittedJobs.load()) {
+          std::this_thread::yield();
+          continue;
+        }
+
+        std::unique_lock<std::mutex> lock(workerMutex);
+        workerIsSleeping.store(true);
+        while (!workerIsDone
+               && (completedJobs.load() == submittedJobs.load())) {
+          workerCondition.wait(lock);
+        }
+        workerIsSleeping.store(false);
+
+        if (workerIsDone
+            && (completedJobs.load() == submittedJobs.load())) {
+          return;
+        }
+      }
+    }
 
-    stream::~stream() {}
+    void stream::notifyWaitingThreads() {
+      if (waitingThreads.load()) {
+        std::lock_guard<std::mutex> lock(workerMutex);
+        completionCondition.notify_all();
+      }
+    }
+    //==================================
   }
 }
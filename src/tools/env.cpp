@@ -68,6 +68,30 @@ namespace occa {
         settings_["kernel/verbose"] = true;
         settings_["memory/verbose"] = true;
       }
+
+      if (env::var("OCCA_BUILD_THREADS").size()) {
+        settings_["build/threads"] = env::get<int>("OCCA_BUILD_THREADS");
+      }
+
+      if (env::var("OCCA_BUILD_JOBS").size()) {
+        settings_["build/jobs"] = env::get<int>("OCCA_BUILD_JOBS");
+      }
+
+      if (env::var("OCCA_BUILD_TIMEOUT").size()) {
+        settings_["build/timeout"] = env::get<double>("OCCA_BUILD_TIMEOUT");
+      }
+
+      if (env::var("OCCA_CACHE_MAX_SIZE").size()) {
+        settings_["cache/max_size"] = env::var("OCCA_CACHE_MAX_SIZE");
+      }
+
+      if (env::var("OCCA_CACHE_MAX_ENTRIES").size()) {
+        settings_["cache/max_entries"] = env::get<int>("OCCA_CACHE_MAX_ENTRIES");
+      }
+
+      if (env::var("OCCA_CACHE_FILE_HASHES").size()) {
+        settings_["cache/persist_file_hashes"] = env::get<bool>("OCCA_CACHE_FILE_HASHES");
+      }
     }
 
     void envInitializer_t::initEnvironment() {
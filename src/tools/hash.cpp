@@ -1,12 +1,196 @@
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
 #include <sstream>
+#include <unordered_map>
 #include <stdint.h>
 
+#include <occa/defines.hpp>
 #include <occa/types.hpp>
 #include <occa/tools/hash.hpp>
 #include <occa/tools/env.hpp>
+#include <occa/tools/string.hpp>
 #include <occa/io.hpp>
 
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define OCCA_HASH_AVX2 1
+#  include <immintrin.h>
+#endif
+
 namespace occa {
+  namespace {
+    // Lanes are updated with the xxHash64 round, 8 lanes cover a 64-byte block
+    // Lanes are cross-mixed after every block so a difference in one lane
+    //   spreads to the whole 512-bit state
+    const int laneCount = 8;
+    const udim_t blockBytes = 64;
+
+    const uint64_t prime1 = 11400714785074694791ULL;
+    const uint64_t prime2 = 14029467366897019727ULL;
+    const uint64_t prime3 = 1609587929392839161ULL;
+    const uint64_t prime4 = 9650029242287828579ULL;
+    const uint64_t prime5 = 2870177450012600261ULL;
+
+    typedef void (*blockHasher_t)(uint64_t *lanes,
+                                  const char *c,
+                                  const udim_t blocks);
+
+    inline uint64_t rotl(const uint64_t x, const int r) {
+      return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t avalanche(uint64_t h) {
+      h ^= h >> 33;
+      h *= prime2;
+      h ^= h >> 29;
+      h *= prime3;
+      h ^= h >> 32;
+      return h;
+    }
+
+    void hashBlocks(uint64_t *lanes,
+                    const char *c,
+                    const udim_t blocks) {
+      for (udim_t b = 0; b < blocks; ++b) {
+        for (int i = 0; i < laneCount; ++i) {
+          uint64_t word;
+          ::memcpy(&word, c + (8 * i), 8);
+          lanes[i] = rotl(lanes[i] + (word * prime2), 31) * prime1;
+        }
+        // lo ^= hi >> 29, then hi += lo rotated by one lane
+        for (int i = 0; i < 4; ++i) {
+          lanes[i] ^= lanes[i + 4] >> 29;
+        }
+        for (int i = 0; i < 4; ++i) {
+          lanes[i + 4] += lanes[(i + 1) & 3];
+        }
+        c += blockBytes;
+      }
+    }
+
+#ifdef OCCA_HASH_AVX2
+    // AVX2 has no 64-bit multiply, build it from 32x32 -> 64-bit products
+    __attribute__((target("avx2")))
+    inline __m256i mullo64(const __m256i a, const __m256i b) {
+      const __m256i aHi = _mm256_srli_epi64(a, 32);
+      const __m256i bHi = _mm256_srli_epi64(b, 32);
+      const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(aHi, b),
+                                             _mm256_mul_epu32(a, bHi));
+      return _mm256_add_epi64(_mm256_mul_epu32(a, b),
+                              _mm256_slli_epi64(cross, 32));
+    }
+
+    __attribute__((target("avx2")))
+    void hashBlocksAvx2(uint64_t *lanes,
+                        const char *c,
+                        const udim_t blocks) {
+      const __m256i vPrime1 = _mm256_set1_epi64x((long long) prime1);
+      const __m256i vPrime2 = _mm256_set1_epi64x((long long) prime2);
+
+      __m256i lo = _mm256_loadu_si256((const __m256i*) lanes);
+      __m256i hi = _mm256_loadu_si256((const __m256i*) (lanes + 4));
+      for (udim_t b = 0; b < blocks; ++b) {
+        const __m256i wordsLo = _mm256_loadu_si256((const __m256i*) c);
+        const __m256i wordsHi = _mm256_loadu_si256((const __m256i*) (c + 32));
+
+        lo = _mm256_add_epi64(lo, mullo64(wordsLo, vPrime2));
+        hi = _mm256_add_epi64(hi, mullo64(wordsHi, vPrime2));
+        lo = _mm256_or_si256(_mm256_slli_epi64(lo, 31), _mm256_srli_epi64(lo, 33));
+        hi = _mm256_or_si256(_mm256_slli_epi64(hi, 31), _mm256_srli_epi64(hi, 33));
+        lo = mullo64(lo, vPrime1);
+        hi = mullo64(hi, vPrime1);
+
+        lo = _mm256_xor_si256(lo, _mm256_srli_epi64(hi, 29));
+        hi = _mm256_add_epi64(hi, _mm256_permute4x64_epi64(lo, _MM_SHUFFLE(0, 3, 2, 1)));
+
+        c += blockBytes;
+      }
+      _mm256_storeu_si256((__m256i*) lanes, lo);
+      _mm256_storeu_si256((__m256i*) (lanes + 4), hi);
+    }
+#endif
+
+    blockHasher_t getBlockHasher() {
+#ifdef OCCA_HASH_AVX2
+      if (__builtin_cpu_supports("avx2")) {
+        return hashBlocksAvx2;
+      }
+#endif
+      return hashBlocks;
+    }
+
+    hash_t fnvHash(const void *ptr, udim_t bytes) {
+      const char *c = (char*) ptr;
+
+      hash_t hash;
+      int *h = hash.h;
+
+      const int p[8] = {
+        102679, 102701, 102761, 102763,
+        102769, 102793, 102797, 102811
+      };
+
+      for (udim_t i = 0; i < bytes; ++i) {
+        for (int j = 0; j < 8; ++j) {
+          h[j] = (h[j] * p[j]) ^ c[i];
+        }
+      }
+      hash.initialized = true;
+
+      return hash;
+    }
+
+    hash_t lanesHash(const void *ptr, udim_t bytes) {
+      static const blockHasher_t blockHasher = getBlockHasher();
+
+      uint64_t lanes[laneCount];
+      for (int i = 0; i < laneCount; ++i) {
+        lanes[i] = prime5 + ((uint64_t) i * prime4);
+      }
+
+      const char *c = (const char*) ptr;
+      const udim_t blocks = bytes / blockBytes;
+      const udim_t tailBytes = bytes % blockBytes;
+      blockHasher(lanes, c, blocks);
+
+      if (tailBytes) {
+        // The length is mixed in below, zero-padding is safe
+        char tail[blockBytes];
+        ::memset(tail, 0, blockBytes);
+        ::memcpy(tail, c + (blocks * blockBytes), tailBytes);
+        blockHasher(lanes, tail, 1);
+      }
+
+      // Merge every lane into one value, like xxHash64 merges its lanes
+      const uint64_t length = (uint64_t) bytes;
+      uint64_t mix = length * prime5;
+      for (int i = 0; i < laneCount; ++i) {
+        mix = (rotl(mix ^ avalanche(lanes[i]), 27) * prime1) + prime4;
+      }
+
+      // Fold lanes into 4 64-bit words which each depend on every lane
+      hash_t hash;
+      for (int i = 0; i < 4; ++i) {
+        const uint64_t word = avalanche(
+          lanes[i] ^ rotl(lanes[i + 4], 32) ^ (mix + ((uint64_t) i * prime2))
+        );
+        hash.h[2 * i]     = (int) (uint32_t) word;
+        hash.h[2 * i + 1] = (int) (uint32_t) (word >> 32);
+      }
+      hash.initialized = true;
+
+      return hash;
+    }
+  }
+
   hash_t::hash_t() {
     initialized = false;
     h[0] = 101527; h[1] = 101531;
@@ -126,26 +310,25 @@ namespace occa {
     return out;
   }
 
-  hash_t hash(const void *ptr, udim_t bytes) {
-    std::stringstream ss;
-    const char *c = (char*) ptr;
-
-    hash_t hash;
-    int *h = hash.h;
+  int getHashVersion() {
+    // Read directly since hashes are used before the environment is setup
+    static const int version = (
+      ::getenv("OCCA_HASH_VERSION")
+      ? ::atoi(::getenv("OCCA_HASH_VERSION"))
+      : hashVersion::lanes
+    );
+    return version;
+  }
 
-    const int p[8] = {
-      102679, 102701, 102761, 102763,
-      102769, 102793, 102797, 102811
-    };
+  hash_t hash(const void *ptr, udim_t bytes) {
+    return hash(ptr, bytes, getHashVersion());
+  }
 
-    for (udim_t i = 0; i < bytes; ++i) {
-      for (int j = 0; j < 8; ++j) {
-        h[j] = (h[j] * p[j]) ^ c[i];
-      }
+  hash_t hash(const void *ptr, udim_t bytes, const int version) {
+    if (version == hashVersion::fnv) {
+      return fnvHash(ptr, bytes);
     }
-    hash.initialized = true;
-
-    return hash;
+    return lanesHash(ptr, bytes);
   }
 
   hash_t hash(const char *c) {
@@ -156,10 +339,140 @@ namespace occa {
     return hash(str.c_str(), str.size());
   }
 
+  namespace {
+    struct fileHash_t {
+      std::string stamp;
+      hash_t hash;
+    };
+
+    typedef std::unordered_map<std::string, fileHash_t> fileHashMap;
+
+    std::mutex& fileHashMutex() {
+      static std::mutex mutex;
+      return mutex;
+    }
+
+    fileHashMap& fileHashes() {
+      static fileHashMap hashes;
+      return hashes;
+    }
+
+    bool persistFileHashes() {
+      return settings().get("cache/persist_file_hashes", false);
+    }
+
+    hash_t readFileHash(const std::string &expFilename) {
+      // Older hashes stopped at the first NUL character
+      const bool stopsAtNull = (getHashVersion() == hashVersion::fnv);
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const int fd = ::open(expFilename.c_str(), O_RDONLY | O_CLOEXEC);
+      if (fd >= 0) {
+        struct stat buffer;
+        void *ptr = MAP_FAILED;
+        udim_t bytes = 0;
+        if (!::fstat(fd, &buffer) && (0 < buffer.st_size)) {
+          bytes = buffer.st_size;
+          ptr = ::mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+
+        if (ptr != MAP_FAILED) {
+          const char *c = (const char*) ptr;
+          hash_t ret = hash(c, stopsAtNull ? ::strnlen(c, bytes) : bytes);
+          ::munmap(ptr, bytes);
+          return ret;
+        }
+      }
+#endif
+
+      size_t chars = 0;
+      const char *c = io::c_read(expFilename, &chars, true);
+      hash_t ret = hash(c, stopsAtNull ? ::strlen(c) : chars);
+      delete [] c;
+      return ret;
+    }
+  }
+
+  // Files are rehashed when any of these change, the hash version is
+  //   included since it changes the stored hash
+  bool getFileStamp(const std::string &filename,
+                    std::string &stamp) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    struct stat buffer;
+    if (::stat(filename.c_str(), &buffer)) {
+      return false;
+    }
+#  if (OCCA_OS & OCCA_MACOS_OS)
+    const struct timespec &mtime = buffer.st_mtimespec;
+    const struct timespec &ctime = buffer.st_ctimespec;
+#  else
+    const struct timespec &mtime = buffer.st_mtim;
+    const struct timespec &ctime = buffer.st_ctim;
+#  endif
+    if (::time(NULL) <= (mtime.tv_sec + 1)) {
+      return false;
+    }
+
+    std::stringstream ss;
+    ss << buffer.st_dev << ':' << buffer.st_ino
+       << ':' << buffer.st_size
+       << ':' << mtime.tv_sec << '.' << mtime.tv_nsec
+       << ':' << ctime.tv_sec << '.' << ctime.tv_nsec
+       << ":v" << getHashVersion();
+    stamp = ss.str();
+    return true;
+#else
+    return false;
+#endif
+  }
+
   hash_t hashFile(const std::string &filename) {
-    const char *c = io::c_read(io::filename(filename));
-    hash_t ret = hash(c);
-    delete [] c;
-    return ret;
+    const std::string expFilename = io::filename(filename);
+
+    std::string stamp;
+    if (!getFileStamp(expFilename, stamp)) {
+      return readFileHash(expFilename);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(fileHashMutex());
+      fileHashMap::iterator it = fileHashes().find(expFilename);
+      if ((it != fileHashes().end()) && (it->second.stamp == stamp)) {
+        return it->second.hash;
+      }
+    }
+
+    // Persisted values are stored as "<stamp> <hash>"
+    const bool persist = persistFileHashes();
+    std::string persistedValue;
+    if (persist
+        && io::cacheIndex().getFileHash(expFilename, persistedValue)
+        && (persistedValue.size() > stamp.size())
+        && startsWith(persistedValue, stamp + ' ')) {
+      std::lock_guard<std::mutex> lock(fileHashMutex());
+      fileHash_t &entry = fileHashes()[expFilename];
+      entry.stamp = stamp;
+      entry.hash = hash_t::fromString(persistedValue.substr(stamp.size() + 1));
+      return entry.hash;
+    }
+
+    const hash_t fileHash = readFileHash(expFilename);
+    {
+      std::lock_guard<std::mutex> lock(fileHashMutex());
+      fileHash_t &entry = fileHashes()[expFilename];
+      entry.stamp = stamp;
+      entry.hash = fileHash;
+    }
+    if (persist) {
+      io::cacheIndex().setFileHash(expFilename,
+                                   stamp + ' ' + fileHash.getFullString());
+    }
+    return fileHash;
+  }
+
+  void clearFileHashCache() {
+    std::lock_guard<std::mutex> lock(fileHashMutex());
+    fileHashes().clear();
   }
 }
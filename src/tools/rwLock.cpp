@@ -0,0 +1,67 @@
+#include <occa/tools/rwLock.hpp>
+
+namespace occa {
+  rwLock_t::rwLock_t() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_init(&lock, NULL);
+#else
+    InitializeSRWLock(&lock);
+#endif
+  }
+
+  rwLock_t::~rwLock_t() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_destroy(&lock);
+#endif
+  }
+
+  void rwLock_t::lockRead() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_rdlock(&lock);
+#else
+    AcquireSRWLockShared(&lock);
+#endif
+  }
+
+  void rwLock_t::unlockRead() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_unlock(&lock);
+#else
+    ReleaseSRWLockShared(&lock);
+#endif
+  }
+
+  void rwLock_t::lockWrite() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_wrlock(&lock);
+#else
+    AcquireSRWLockExclusive(&lock);
+#endif
+  }
+
+  void rwLock_t::unlockWrite() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    pthread_rwlock_unlock(&lock);
+#else
+    ReleaseSRWLockExclusive(&lock);
+#endif
+  }
+
+  readLock::readLock(rwLock_t &lock_) :
+    lock(lock_) {
+    lock.lockRead();
+  }
+
+  readLock::~readLock() {
+    lock.unlockRead();
+  }
+
+  writeLock::writeLock(rwLock_t &lock_) :
+    lock(lock_) {
+    lock.lockWrite();
+  }
+
+  writeLock::~writeLock() {
+    lock.unlockWrite();
+  }
+}
@@ -374,6 +374,34 @@ namespace occa {
     }
   }
 
+  udim_t parseBytes(const std::string &str) {
+    const char *c = str.c_str();
+    char *end = NULL;
+    const double value = ::strtod(c, &end);
+    if ((end == c) || (value < 0)) {
+      return 0;
+    }
+
+    std::string units = lowercase(strip(std::string(end)));
+    if (units.size() && (units[units.size() - 1] == 'b')) {
+      units.resize(units.size() - 1);
+    }
+
+    double scale = 1;
+    if (units == "k") {
+      scale = (double) (((uint64_t) 1) << 10);
+    } else if (units == "m") {
+      scale = (double) (((uint64_t) 1) << 20);
+    } else if (units == "g") {
+      scale = (double) (((uint64_t) 1) << 30);
+    } else if (units == "t") {
+      scale = (double) (((uint64_t) 1) << 40);
+    } else if (units.size() && (units != "byte") && (units != "bytes")) {
+      return 0;
+    }
+    return (udim_t) (value * scale);
+  }
+
   //---[ Color Strings ]----------------
   namespace color {
     const char fgMap[9][7] = {
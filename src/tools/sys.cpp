@@ -1,25 +1,34 @@
 #include <occa/defines.hpp>
 
+#include <cstring>
 #include <fstream>
 
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
 #  include <ctime>
 #  include <cxxabi.h>
 #  include <dlfcn.h>
+#  include <errno.h>
 #  include <execinfo.h>
+#  include <limits.h>
+#  include <poll.h>
 #  include <pthread.h>
 #  include <signal.h>
+#  include <spawn.h>
 #  include <stdio.h>
+#  include <string.h>
+#  include <sys/mman.h>
 #  include <sys/types.h>
 #  include <sys/stat.h>
 #  include <sys/syscall.h>
 #  include <sys/sysctl.h>
 #  include <sys/time.h>
+#  include <sys/wait.h>
 #  include <unistd.h>
 #  if (OCCA_OS & OCCA_LINUX_OS)
 #    include <errno.h>
 #    include <sys/sysinfo.h>
 #  else // OCCA_MACOS_OS
+#    include <crt_externs.h>
 #    include <mach/mach_host.h>
 #    ifdef __clang__
 #      include <CoreServices/CoreServices.h>
@@ -33,7 +42,10 @@
 #  include <windows.h>
 #endif
 
+#include <condition_variable>
 #include <iomanip>
+#include <map>
+#include <mutex>
 #include <sstream>
 
 #include <sys/types.h>
@@ -350,7 +362,8 @@ namespace occa {
 
     bool pidExists(const int pid) {
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-      return !::kill(pid, 0);
+      // EPERM: The process exists but is owned by another user
+      return (!::kill(pid, 0) || (errno == EPERM));
 #else
       HANDLE hProc = OpenProcess(SYNCHRONIZE, FALSE, pid);
       if (!hProc) {
@@ -370,6 +383,22 @@ namespace occa {
 #endif
     }
 
+    std::string getHostname() {
+      char name[256];
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      if (::gethostname(name, sizeof(name))) {
+        return "";
+      }
+      name[sizeof(name) - 1] = '\0';
+#else
+      DWORD size = sizeof(name);
+      if (!GetComputerNameA(name, &size)) {
+        return "";
+      }
+#endif
+      return name;
+    }
+
     int getTID() {
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
       #if OCCA_OS == OCCA_MACOS_OS & (MAC_OS_X_VERSION_MAX_ALLOWED >= MAC_OS_X_VERSION_10_12)
@@ -404,6 +433,278 @@ namespace occa {
     }
     //==================================
 
+    //---[ Process Spawning ]-----------
+    spawnResult::spawnResult() :
+      exitCode(-1),
+      timedOut(false) {}
+
+    bool spawnResult::succeeded() const {
+      return !timedOut && !exitCode;
+    }
+
+    strVector splitCommand(const std::string &cmdline) {
+      strVector args;
+      std::string arg;
+      bool hasArg = false;
+
+      const char *c = cmdline.c_str();
+      while (*c != '\0') {
+        if (lex::isWhitespace(*c)) {
+          if (hasArg) {
+            args.push_back(arg);
+            arg.clear();
+            hasArg = false;
+          }
+          ++c;
+          continue;
+        }
+        hasArg = true;
+
+        if (*c == '\'') {
+          // Single quotes are taken literally
+          ++c;
+          while ((*c != '\0') && (*c != '\'')) {
+            arg += *(c++);
+          }
+        } else if (*c == '"') {
+          // Backslashes only escape [\"], [\\], [\`] and [\$] inside double quotes
+          ++c;
+          while ((*c != '\0') && (*c != '"')) {
+            if ((*c == '\\') && (c[1] != '\0')
+                && (strchr("\"\\`$", c[1]) != NULL)) {
+              ++c;
+            }
+            arg += *(c++);
+          }
+        } else if ((*c == '\\') && (c[1] != '\0')) {
+          arg += *(++c);
+        } else {
+          arg += *c;
+        }
+        if (*c != '\0') {
+          ++c;
+        }
+      }
+      if (hasArg) {
+        args.push_back(arg);
+      }
+      return args;
+    }
+
+    bool commandNeedsShell(const std::string &cmdline) {
+      return (cmdline.find_first_of("|&;<>()$`*?~\n") != std::string::npos);
+    }
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+    namespace {
+      // Keeps track of the processes spawned by all threads
+      class spawnJobLimit {
+      private:
+        std::mutex mutex;
+        std::condition_variable condition;
+        int runningJobs;
+
+      public:
+        spawnJobLimit() :
+          runningJobs(0) {}
+
+        void acquire(const int maxJobs) {
+          std::unique_lock<std::mutex> lock(mutex);
+          while (runningJobs >= maxJobs) {
+            condition.wait(lock);
+          }
+          ++runningJobs;
+        }
+
+        void release() {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            --runningJobs;
+          }
+          condition.notify_one();
+        }
+      };
+
+      spawnJobLimit& getSpawnJobLimit() {
+        static spawnJobLimit jobLimit;
+        return jobLimit;
+      }
+
+      class spawnJob {
+      public:
+        spawnJob() {
+          const int maxJobs = settings().get("build/jobs", getCoreCount());
+          getSpawnJobLimit().acquire(maxJobs > 0 ? maxJobs : 1);
+        }
+
+        ~spawnJob() {
+          getSpawnJobLimit().release();
+        }
+      };
+
+      char** getEnviron() {
+#  if (OCCA_OS & OCCA_MACOS_OS)
+        return *_NSGetEnviron();
+#  else
+        return environ;
+#  endif
+      }
+    }
+#endif
+
+    spawnResult spawn(const strVector &args,
+                      const double timeout) {
+      OCCA_ERROR("Unable to spawn an empty command",
+                 args.size());
+
+      spawnResult result;
+      const double timeout_ = (
+        (timeout < 0)
+        ? settings().get("build/timeout", 0.0)
+        : timeout
+      );
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const int argc = (int) args.size();
+      std::vector<char*> argv(argc + 1, (char*) NULL);
+      for (int i = 0; i < argc; ++i) {
+        argv[i] = const_cast<char*>(args[i].c_str());
+      }
+
+      // stdout and stderr share the same pipe
+      // Set close-on-exec atomically where possible, otherwise processes
+      //   spawned by other threads in between can inherit the pipe
+      int fds[2];
+#if (OCCA_OS == OCCA_LINUX_OS)
+      OCCA_ERROR("Unable to create pipe for [" << args[0] << "]",
+                 !::pipe2(fds, O_CLOEXEC));
+#else
+      OCCA_ERROR("Unable to create pipe for [" << args[0] << "]",
+                 !::pipe(fds));
+      ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+      ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+
+      posix_spawn_file_actions_t fileActions;
+      posix_spawn_file_actions_init(&fileActions);
+      posix_spawn_file_actions_adddup2(&fileActions, fds[1], STDOUT_FILENO);
+      posix_spawn_file_actions_adddup2(&fileActions, fds[1], STDERR_FILENO);
+
+      // Use a new process group to kill child processes on timeouts
+      posix_spawnattr_t attributes;
+      posix_spawnattr_init(&attributes);
+      posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+      posix_spawnattr_setpgroup(&attributes, 0);
+
+      spawnJob job;
+
+      pid_t pid;
+      const int spawnError = ::posix_spawnp(&pid,
+                                            argv[0],
+                                            &fileActions,
+                                            &attributes,
+                                            &(argv[0]),
+                                            getEnviron());
+      posix_spawn_file_actions_destroy(&fileActions);
+      posix_spawnattr_destroy(&attributes);
+      ::close(fds[1]);
+
+      if (spawnError) {
+        ::close(fds[0]);
+        result.exitCode = 127;
+        result.output = "Unable to run [" + args[0] + "]: " + ::strerror(spawnError) + '\n';
+        return result;
+      }
+
+      const double endTime = currentTime() + timeout_;
+      char buffer[4096];
+      while (true) {
+        int pollTimeout = -1;
+        if (timeout_ > 0) {
+          const double timeLeft = endTime - currentTime();
+          if (timeLeft <= 0) {
+            result.timedOut = true;
+            break;
+          }
+          pollTimeout = 1 + (int) (1000 * timeLeft);
+        }
+
+        struct pollfd pollFd;
+        pollFd.fd = fds[0];
+        pollFd.events = POLLIN;
+        pollFd.revents = 0;
+
+        const int pollStatus = ::poll(&pollFd, 1, pollTimeout);
+        if (pollStatus < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          break;
+        }
+        if (!pollStatus) {
+          continue;
+        }
+
+        const ssize_t bytes = ::read(fds[0], buffer, sizeof(buffer));
+        if (bytes < 0) {
+          if (errno == EINTR) {
+            continue;
+          }
+          break;
+        }
+        if (!bytes) {
+          break;
+        }
+        result.output.append(buffer, bytes);
+      }
+      ::close(fds[0]);
+
+      if (result.timedOut) {
+        ::kill(-pid, SIGKILL);
+      }
+
+      int status = 0;
+      while ((::waitpid(pid, &status, 0) < 0) && (errno == EINTR)) {}
+
+      if (WIFEXITED(status)) {
+        result.exitCode = WEXITSTATUS(status);
+      } else if (WIFSIGNALED(status)) {
+        result.exitCode = 128 + WTERMSIG(status);
+      }
+#else
+      std::stringstream ss;
+      const int argc = (int) args.size();
+      for (int i = 0; i < argc; ++i) {
+        if (i) {
+          ss << ' ';
+        }
+        ss << '"' << args[i] << '"';
+      }
+      result.exitCode = system(("\"" + ss.str() + "\"").c_str());
+#endif
+
+      return result;
+    }
+
+    spawnResult spawn(const std::string &cmdline,
+                      const double timeout) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      if (commandNeedsShell(cmdline)) {
+        strVector args;
+        args.push_back("/bin/sh");
+        args.push_back("-c");
+        args.push_back(cmdline);
+        return spawn(args, timeout);
+      }
+      return spawn(splitCommand(cmdline), timeout);
+#else
+      spawnResult result;
+      result.exitCode = system(("\"" + cmdline + "\"").c_str());
+      return result;
+#endif
+    }
+    //==================================
+
     //---[ Processor Info ]-------------
     std::string getFieldFrom(const std::string &command,
                              const std::string &field) {
@@ -644,7 +945,166 @@ namespace occa {
 #endif
     }
 
+    // The resolved compiler binary, its stat metadata and its --version output
+    //   - Upgrading the compiler replaces the binary
+    //   - Wrappers such as ccache or mpicxx keep their binary, but report the
+    //     compiler they use in --version
+    std::string compilerStamp(const std::string &compiler) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const strVector args = splitCommand(compiler);
+      if (!args.size()) {
+        return "";
+      }
+
+      std::string binary = args[0];
+      if (binary.find('/') == std::string::npos) {
+        const char *pathEnv = ::getenv("PATH");
+        const strVector paths = split(pathEnv ? pathEnv : "", ':');
+        const int pathCount = (int) paths.size();
+        for (int i = 0; i < pathCount; ++i) {
+          const std::string candidate = paths[i] + '/' + binary;
+          if (!::access(candidate.c_str(), X_OK)) {
+            binary = candidate;
+            break;
+          }
+        }
+      }
+
+      // Compilers are usually symlinks, such as g++ -> g++-12
+      char realBinary[PATH_MAX];
+      if (::realpath(binary.c_str(), realBinary)) {
+        binary = realBinary;
+      }
+
+      struct stat info;
+      if (::stat(binary.c_str(), &info)) {
+        return "";
+      }
+#  if (OCCA_OS & OCCA_MACOS_OS)
+      const struct timespec &mtime = info.st_mtimespec;
+#  else
+      const struct timespec &mtime = info.st_mtim;
+#  endif
+
+      std::stringstream ss;
+      ss << binary
+         << ':' << info.st_dev
+         << ':' << info.st_ino
+         << ':' << info.st_size
+         << ':' << mtime.tv_sec << '.' << mtime.tv_nsec
+         << ':' << OCCA_VERSION_STR;
+      const std::string fileStamp = ss.str();
+
+      // Only run --version once per compiler binary in each process
+      static std::mutex versionMutex;
+      static std::map<std::string, std::string> versionHashes;
+
+      const std::string versionKey = compiler + '\n' + fileStamp;
+      {
+        std::lock_guard<std::mutex> lock(versionMutex);
+        std::map<std::string, std::string>::iterator it = versionHashes.find(versionKey);
+        if (it != versionHashes.end()) {
+          return fileStamp + ':' + it->second;
+        }
+      }
+
+      strVector versionArgs = args;
+      versionArgs.push_back("--version");
+      const spawnResult result = spawn(versionArgs, 10);
+      const std::string versionHash = occa::hash(
+        toString(result.exitCode) + '\n' + result.output
+      ).getString();
+
+      std::lock_guard<std::mutex> lock(versionMutex);
+      versionHashes[versionKey] = versionHash;
+      return fileStamp + ':' + versionHash;
+#else
+      return "";
+#endif
+    }
+
+    namespace {
+      class toolchain_t {
+      public:
+        std::string stamp;
+        json capabilities;
+
+        toolchain_t() :
+          capabilities(json::object_) {}
+      };
+
+      typedef std::map<std::string, toolchain_t> toolchainMap;
+
+      std::mutex& toolchainMutex() {
+        static std::mutex mutex;
+        return mutex;
+      }
+
+      toolchainMap& toolchains() {
+        static toolchainMap toolchains_;
+        return toolchains_;
+      }
+
+      // Expects the toolchainMutex() to be held
+      toolchain_t* getToolchain(const std::string &compiler) {
+        const std::string stamp = compilerStamp(compiler);
+        if (!stamp.size()) {
+          return NULL;
+        }
+
+        toolchain_t &toolchain = toolchains()[compiler];
+        if (toolchain.stamp == stamp) {
+          return &toolchain;
+        }
+        toolchain.stamp = stamp;
+        toolchain.capabilities = json(json::object_);
+
+        std::string value;
+        if (io::cacheIndex().getToolchain(compiler, value)) {
+          json record = json::parse(value);
+          if (record.get<std::string>("stamp") == toolchain.stamp) {
+            toolchain.capabilities = record["capabilities"];
+          }
+        }
+        return &toolchain;
+      }
+    }
+
+    bool getCompilerCapability(const std::string &compiler,
+                               const std::string &capability,
+                               std::string &value) {
+      std::lock_guard<std::mutex> lock(toolchainMutex());
+      toolchain_t *toolchain = getToolchain(compiler);
+      if (!toolchain
+          || !toolchain->capabilities.has(capability)) {
+        return false;
+      }
+      value = (std::string) toolchain->capabilities[capability];
+      return true;
+    }
+
+    void setCompilerCapability(const std::string &compiler,
+                               const std::string &capability,
+                               const std::string &value) {
+      std::lock_guard<std::mutex> lock(toolchainMutex());
+      toolchain_t *toolchain = getToolchain(compiler);
+      if (!toolchain) {
+        return;
+      }
+      toolchain->capabilities.set(capability, value);
+
+      json record(json::object_);
+      record.set("stamp", toolchain->stamp);
+      record.set("capabilities", toolchain->capabilities);
+      io::cacheIndex().setToolchain(compiler, record.toString());
+    }
+
     int compilerVendor(const std::string &compiler) {
+      std::string cachedVendor;
+      if (getCompilerCapability(compiler, "vendor", cachedVendor)) {
+        return ::atoi(cachedVendor.c_str());
+      }
+
 #if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
       const std::string safeCompiler = io::slashToSnake(compiler);
       int vendor_ = sys::vendor::notFound;
@@ -660,12 +1120,9 @@ namespace occa {
       const std::string &hashDir = io::dirname(srcFilename);
       const std::string binaryFilename   = hashDir + "binary";
       const std::string outFilename      = hashDir + "output";
-      const std::string buildLogFilename = hashDir + "build.log";
+      const std::string buildLogFilename = hashDir + kc::buildLogFile;
 
-      bool foundOutput = (
-        io::cachedFileIsComplete(hashDir, "output")
-        && io::isFile(outFilename)
-      );
+      bool foundOutput = io::cachedFileIsComplete(hashDir, "output");
 
       // Avoid creating lockfile if possible
       if (!foundOutput) {
@@ -673,17 +1130,16 @@ namespace occa {
         if (lock.isMine()) {
           ss << compiler
              << ' '    << srcFilename
-             << " -o " << binaryFilename
-             << " > " << buildLogFilename << " 2>&1";
+             << " -o " << binaryFilename;
           const std::string compileLine = ss.str();
 
-          ignoreResult( system(compileLine.c_str()) );
+          const spawnResult compileResult = spawn(compileLine);
+          io::write(buildLogFilename, compileResult.output);
 
           OCCA_ERROR("Could not compile compilerVendorTest.cpp with following command:\n" << compileLine,
                      io::isFile(binaryFilename));
 
-          int exitStatus = system(binaryFilename.c_str());
-          int vendorBit  = WEXITSTATUS(exitStatus);
+          const int vendorBit = spawn(strVector(1, binaryFilename)).exitCode;
 
           if (vendorBit < sys::vendor::b_max) {
             vendor_ = (1 << vendorBit);
@@ -691,6 +1147,7 @@ namespace occa {
 
           io::write(outFilename, std::to_string(vendor_));
           io::markCachedFileComplete(hashDir, "output");
+          setCompilerCapability(compiler, "vendor", toString(vendor_));
 
           return vendor_;
         }
@@ -698,6 +1155,7 @@ namespace occa {
 
       ss << io::read(outFilename);
       ss >> vendor_;
+      setCompilerCapability(compiler, "vendor", toString(vendor_));
 
       return vendor_;
 
@@ -824,10 +1282,14 @@ namespace occa {
 
     //---[ Dynamic Methods ]------------
     void* malloc(udim_t bytes) {
+      return malloc(bytes, env::OCCA_MEM_BYTE_ALIGN);
+    }
+
+    void* malloc(udim_t bytes, udim_t alignment) {
       void* ptr;
 
 #if   (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
-      ignoreResult( posix_memalign(&ptr, env::OCCA_MEM_BYTE_ALIGN, bytes) );
+      ignoreResult( posix_memalign(&ptr, alignment, bytes) );
 #elif (OCCA_OS == OCCA_WINDOWS_OS)
       ptr = ::malloc(bytes);
 #endif
@@ -899,6 +1361,30 @@ namespace occa {
       return sym2;
     }
 
+    functionPtr_t dlsymIfExists(void *dlHandle,
+                                const std::string &functionName) {
+      OCCA_ERROR("dl handle is NULL",
+                 dlHandle);
+
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      void *sym = ::dlsym(dlHandle, functionName.c_str());
+      if (!sym) {
+        // Clear the error state
+        dlerror();
+        return NULL;
+      }
+#else
+      void *sym = GetProcAddress((HMODULE) dlHandle, functionName.c_str());
+      if (sym == NULL) {
+        return NULL;
+      }
+#endif
+
+      functionPtr_t sym2;
+      ::memcpy(&sym2, &sym, sizeof(sym));
+      return sym2;
+    }
+
     void dlclose(void *dlHandle) {
       if (!dlHandle) {
         return;
@@ -1019,6 +1505,233 @@ namespace occa {
       return std::string(symbol);
 #endif
     }
+    //==================================
+
+    //---[ Memory Placement ]-----------
+    namespace {
+#if (OCCA_OS & OCCA_LINUX_OS)
+      // Avoids depending on libnuma for <numaif.h>
+      static const int MPOL_BIND_       = 2;
+      static const int MPOL_INTERLEAVE_ = 3;
+      static const unsigned MPOL_MF_MOVE_ = (1 << 1);
+      static const int maxNumaNodes = 1024;
+      static const int nodeMaskBits = 8 * sizeof(unsigned long);
+
+      bool setMemoryPolicy(void *ptr,
+                           const udim_t bytes,
+                           const int policy,
+                           const intVector &nodes) {
+        // Only whole pages in the range are given the policy
+        const udim_t page = pageBytes();
+        const udim_t start = ((udim_t) ptr + page - 1) / page * page;
+        const udim_t end = ((udim_t) ptr + bytes) / page * page;
+        if (end <= start) {
+          return false;
+        }
+
+        unsigned long nodeMask[maxNumaNodes / nodeMaskBits];
+        ::memset(nodeMask, 0, sizeof(nodeMask));
+
+        const int nodeCount = (int) nodes.size();
+        for (int i = 0; i < nodeCount; ++i) {
+          const int node = nodes[i];
+          if ((node < 0) || (maxNumaNodes <= node)) {
+            return false;
+          }
+          nodeMask[node / nodeMaskBits] |= (1UL << (node % nodeMaskBits));
+        }
+
+        // Pages which were already touched are moved to the new nodes
+        return !::syscall(SYS_mbind,
+                          (void*) start,
+                          (unsigned long) (end - start),
+                          policy,
+                          nodeMask,
+                          (unsigned long) (maxNumaNodes + 1),
+                          MPOL_MF_MOVE_);
+      }
+#endif
+    }
+
+    udim_t pageBytes() {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      return (udim_t) sysconf(_SC_PAGESIZE);
+#else
+      return 4096;
+#endif
+    }
+
+    udim_t hugePageBytes() {
+      static udim_t bytes = 0;
+      if (!bytes) {
+        const std::string hugePageFile = "/sys/kernel/mm/transparent_hugepage/hpage_pmd_size";
+        if (io::isFile(hugePageFile)) {
+          bytes = occa::atoi(strip(io::read(hugePageFile)));
+        }
+        if (!bytes) {
+          bytes = 2 << 20;
+        }
+      }
+      return bytes;
+    }
+
+    void* mapPages(const udim_t bytes,
+                   const udim_t alignment) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      // Over-map and unmap the unaligned head and tail
+      const udim_t mappedBytes = bytes + alignment;
+      char *mapped = (char*) ::mmap(NULL,
+                                    mappedBytes,
+                                    PROT_READ | PROT_WRITE,
+                                    MAP_PRIVATE | MAP_ANONYMOUS,
+                                    -1,
+                                    0);
+      if (mapped == MAP_FAILED) {
+        return NULL;
+      }
+
+      char *ptr = mapped;
+      if ((udim_t) ptr % alignment) {
+        ptr += alignment - ((udim_t) ptr % alignment);
+      }
+      const udim_t headBytes = ptr - mapped;
+      const udim_t tailBytes = mappedBytes - headBytes - bytes;
+      if (headBytes) {
+        ::munmap(mapped, headBytes);
+      }
+      if (tailBytes) {
+        ::munmap(ptr + bytes, tailBytes);
+      }
+      return ptr;
+#else
+      return NULL;
+#endif
+    }
+
+    intVector numaNodes() {
+      intVector nodes;
+#if (OCCA_OS & OCCA_LINUX_OS)
+      const std::string onlineFile = "/sys/devices/system/node/online";
+      if (!io::isFile(onlineFile)) {
+        return nodes;
+      }
+      // Node ranges, such as: 0-1,4
+      const strVector ranges = split(strip(io::read(onlineFile)), ',');
+      const int rangeCount = (int) ranges.size();
+      for (int i = 0; i < rangeCount; ++i) {
+        const strVector bounds = split(ranges[i], '-');
+        if (!bounds.size() || !bounds[0].size()) {
+          continue;
+        }
+        const int first = (int) occa::atoi(bounds[0]);
+        const int last = (bounds.size() > 1) ? (int) occa::atoi(bounds[1]) : first;
+        for (int node = first; node <= last; ++node) {
+          nodes.push_back(node);
+        }
+      }
+#endif
+      return nodes;
+    }
+
+    bool interleaveMemory(void *ptr,
+                          const udim_t bytes,
+                          const intVector &nodes) {
+#if (OCCA_OS & OCCA_LINUX_OS)
+      return (nodes.size()
+              && setMemoryPolicy(ptr, bytes, MPOL_INTERLEAVE_, nodes));
+#else
+      return false;
+#endif
+    }
+
+    bool bindMemory(void *ptr,
+                    const udim_t bytes,
+                    const int node) {
+#if (OCCA_OS & OCCA_LINUX_OS)
+      return setMemoryPolicy(ptr, bytes, MPOL_BIND_, intVector(1, node));
+#else
+      return false;
+#endif
+    }
+
+    bool adviseHugePages(void *ptr,
+                         const udim_t bytes) {
+#if (OCCA_OS & OCCA_LINUX_OS) && defined(MADV_HUGEPAGE)
+      return !::madvise(ptr, bytes, MADV_HUGEPAGE);
+#else
+      return false;
+#endif
+    }
+    //==================================
+
+    //---[ Memory Mapping ]-------------
+    udim_t fileBytes(const std::string &filename) {
+      struct stat info;
+      OCCA_ERROR("Unable to read file [" << filename << "]",
+                 !::stat(io::filename(filename).c_str(), &info));
+      return (udim_t) info.st_size;
+    }
+
+    void* mmapFile(const std::string &filename,
+                   const udim_t offset,
+                   const udim_t bytes,
+                   const bool readOnly) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      const std::string expFilename = io::filename(filename);
+      // Writes go to private pages, the file itself is only read
+      const int fd = ::open(expFilename.c_str(),
+                            O_RDONLY | O_CLOEXEC);
+      OCCA_ERROR("Unable to open file [" << filename << "]",
+                 fd >= 0);
+
+      void *ptr = ::mmap(NULL,
+                         bytes,
+                         readOnly ? PROT_READ : (PROT_READ | PROT_WRITE),
+                         readOnly ? MAP_SHARED : MAP_PRIVATE,
+                         fd,
+                         (off_t) offset);
+      // The mapping keeps its own reference to the file
+      ::close(fd);
+
+      OCCA_ERROR("Unable to map [" << bytes << "] bytes from file [" << filename << "]"
+                 << " (" << strerror(errno) << ")",
+                 ptr != MAP_FAILED);
+      return ptr;
+#else
+      OCCA_FORCE_ERROR("Memory mapped files are not supported on this OS");
+      return NULL;
+#endif
+    }
+
+    void munmap(void *ptr,
+                const udim_t bytes) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      ::munmap(ptr, bytes);
+#endif
+    }
+
+    bool adviseMemory(void *ptr,
+                      const udim_t bytes,
+                      const std::string &advice) {
+#if (OCCA_OS & (OCCA_LINUX_OS | OCCA_MACOS_OS))
+      int flag;
+      if (advice == "normal") {
+        flag = MADV_NORMAL;
+      } else if (advice == "sequential") {
+        flag = MADV_SEQUENTIAL;
+      } else if (advice == "random") {
+        flag = MADV_RANDOM;
+      } else if (advice == "willneed") {
+        flag = MADV_WILLNEED;
+      } else {
+        return false;
+      }
+      return !::madvise(ptr, bytes, flag);
+#else
+      return false;
+#endif
+    }
+    //==================================
   }
 
   void _message(const std::string &header,
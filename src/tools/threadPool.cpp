@@ -0,0 +1,70 @@
+#include <occa/tools/env.hpp>
+#include <occa/tools/sys.hpp>
+#include <occa/tools/threadPool.hpp>
+
+namespace occa {
+  threadPoolJob::~threadPoolJob() {}
+
+  threadPool::threadPool(const int threadCount) :
+    isDone(false) {
+    const int threads = (threadCount > 0) ? threadCount : 1;
+    workers.reserve(threads);
+    for (int i = 0; i < threads; ++i) {
+      workers.push_back(
+        std::thread(&threadPool::runWorker, this)
+      );
+    }
+  }
+
+  threadPool::~threadPool() {
+    {
+      std::lock_guard<std::mutex> lock(jobsMutex);
+      isDone = true;
+    }
+    jobsCondition.notify_all();
+
+    const int threads = (int) workers.size();
+    for (int i = 0; i < threads; ++i) {
+      workers[i].join();
+    }
+  }
+
+  int threadPool::size() const {
+    return (int) workers.size();
+  }
+
+  void threadPool::enqueue(threadPoolJob *job) {
+    {
+      std::lock_guard<std::mutex> lock(jobsMutex);
+      jobs.push_back(job);
+    }
+    jobsCondition.notify_one();
+  }
+
+  void threadPool::runWorker() {
+    while (true) {
+      threadPoolJob *job;
+      {
+        std::unique_lock<std::mutex> lock(jobsMutex);
+        while (!isDone && jobs.empty()) {
+          jobsCondition.wait(lock);
+        }
+        // Finish pending jobs before exiting
+        if (jobs.empty()) {
+          return;
+        }
+        job = jobs.front();
+        jobs.pop_front();
+      }
+      job->run();
+      delete job;
+    }
+  }
+
+  threadPool& buildThreadPool() {
+    static threadPool pool(
+      settings().get("build/threads", sys::getCoreCount())
+    );
+    return pool;
+  }
+}
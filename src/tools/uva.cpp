@@ -1,4 +1,5 @@
-#include <map>
+#include <algorithm>
+#include <atomic>
 
 #include <occa/core/base.hpp>
 #include <occa/tools/misc.hpp>
@@ -9,6 +10,12 @@ namespace occa {
   ptrRangeMap uvaMap;
   memoryVector uvaStaleMemory;
 
+  namespace {
+    // Memory can be synced from several threads
+    std::atomic<udim_t> uvaCopiedBytes(0);
+    std::atomic<udim_t> uvaSavedBytes(0);
+  }
+
   //---[ ptrRange ]---------------------
   ptrRange::ptrRange() :
     start(NULL),
@@ -53,13 +60,292 @@ namespace occa {
   //====================================
 
 
+  //---[ ptrRangeMap ]------------------
+  ptrRangeMap::ptrRangeMap() :
+    entries(0) {}
+
+  void ptrRangeMap::insert(const ptrRange &range,
+                           occa::modeMemory_t *modeMemory) {
+    writeLock guard(lock);
+
+    entry_t entry;
+    entry.start = range.start;
+    entry.end = range.end;
+    entry.modeMemory = modeMemory;
+
+    if (!blocks.size()) {
+      blocks.push_back(entryVector(1, entry));
+      blockStarts.push_back(entry.start);
+      ++entries;
+      return;
+    }
+
+    // Ranges before the first block go into the first block
+    const int blockIndex = std::max(0, findBlock(entry.start));
+    entryVector &block = blocks[blockIndex];
+
+    const int index = findEntry(block, entry.start);
+    if ((index >= 0) && overlaps(block[index], range)) {
+      block[index] = entry;
+      blockStarts[blockIndex] = block[0].start;
+      return;
+    }
+
+    // The next range could start the next block
+    int nextBlockIndex = blockIndex;
+    int nextIndex = index + 1;
+    if (nextIndex == (int) block.size()) {
+      ++nextBlockIndex;
+      nextIndex = 0;
+    }
+    if ((nextBlockIndex < (int) blocks.size())
+        && overlaps(blocks[nextBlockIndex][nextIndex], range)) {
+      entryVector &nextBlock = blocks[nextBlockIndex];
+      nextBlock[nextIndex] = entry;
+      blockStarts[nextBlockIndex] = nextBlock[0].start;
+      return;
+    }
+
+    block.insert(block.begin() + (index + 1), entry);
+    blockStarts[blockIndex] = block[0].start;
+    ++entries;
+
+    // Split full blocks in half
+    if ((int) block.size() > maxBlockEntries) {
+      const int half = (int) block.size() / 2;
+      entryVector newBlock(block.begin() + half, block.end());
+      block.resize(half);
+
+      blocks.insert(blocks.begin() + (blockIndex + 1), entryVector());
+      blocks[blockIndex + 1].swap(newBlock);
+      blockStarts.insert(blockStarts.begin() + (blockIndex + 1),
+                         blocks[blockIndex + 1][0].start);
+    }
+  }
+
+  void ptrRangeMap::erase(void *ptr) {
+    writeLock guard(lock);
+
+    const int blockIndex = findBlock((char*) ptr);
+    if (blockIndex < 0) {
+      return;
+    }
+    entryVector &block = blocks[blockIndex];
+
+    const int index = findEntry(block, (char*) ptr);
+    if ((index < 0) || !contains(block[index], (char*) ptr)) {
+      return;
+    }
+
+    block.erase(block.begin() + index);
+    --entries;
+
+    if (block.size()) {
+      blockStarts[blockIndex] = block[0].start;
+    } else {
+      blocks.erase(blocks.begin() + blockIndex);
+      blockStarts.erase(blockStarts.begin() + blockIndex);
+    }
+  }
+
+  occa::modeMemory_t* ptrRangeMap::find(void *ptr) const {
+    readLock guard(lock);
+
+    const int blockIndex = findBlock((char*) ptr);
+    if (blockIndex < 0) {
+      return NULL;
+    }
+    const entryVector &block = blocks[blockIndex];
+
+    const int index = findEntry(block, (char*) ptr);
+    if ((index < 0) || !contains(block[index], (char*) ptr)) {
+      return NULL;
+    }
+    return block[index].modeMemory;
+  }
+
+  size_t ptrRangeMap::size() const {
+    readLock guard(lock);
+    return entries;
+  }
+
+  void ptrRangeMap::clear() {
+    writeLock guard(lock);
+    blocks.clear();
+    blockStarts.clear();
+    entries = 0;
+  }
+
+  int ptrRangeMap::findBlock(const char *ptr) const {
+    if (!blockStarts.size()) {
+      return -1;
+    }
+    // Branchless binary search, lookups are random so branches mispredict
+    char * const *starts = &(blockStarts[0]);
+    int count = (int) blockStarts.size();
+    while (count > 1) {
+      const int half = count / 2;
+      starts = (starts[half] <= ptr) ? (starts + half) : starts;
+      count -= half;
+    }
+    return (*starts <= ptr) ? (int) (starts - &(blockStarts[0])) : -1;
+  }
+
+  int ptrRangeMap::findEntry(const entryVector &block,
+                             const char *ptr) {
+    if (!block.size()) {
+      return -1;
+    }
+    const entry_t *entry = &(block[0]);
+    int count = (int) block.size();
+    while (count > 1) {
+      const int half = count / 2;
+      entry = (entry[half].start <= ptr) ? (entry + half) : entry;
+      count -= half;
+    }
+    return (entry->start <= ptr) ? (int) (entry - &(block[0])) : -1;
+  }
+
+  bool ptrRangeMap::contains(const entry_t &entry,
+                             const char *ptr) {
+    return ((entry.start <= ptr)
+            && ((ptr < entry.end) || (ptr == entry.start)));
+  }
+
+  bool ptrRangeMap::overlaps(const entry_t &entry,
+                             const ptrRange &range) {
+    if (entry.start == range.start) {
+      return true;
+    }
+    return ((entry.start < range.end)
+            && (range.start < entry.end));
+  }
+  //====================================
+
+
+  //---[ dirtyRanges_t ]----------------
+  dirtyRanges_t::dirtyRanges_t() :
+    granularity(1) {}
+
+  void dirtyRanges_t::add(const udim_t offset,
+                          const udim_t bytes,
+                          const udim_t maxBytes) {
+    const udim_t step = granularity ? granularity : 1;
+    udim_t start = step * (offset / step);
+    udim_t end = std::min(maxBytes,
+                          step * ((offset + bytes + step - 1) / step));
+    if (end <= start) {
+      return;
+    }
+
+    // Merge overlapping and adjacent ranges
+    rangeMap::iterator it = ranges.upper_bound(start);
+    if (it != ranges.begin()) {
+      --it;
+      if (it->second < start) {
+        ++it;
+      }
+    }
+    while ((it != ranges.end()) && (it->first <= end)) {
+      start = std::min(start, it->first);
+      end = std::max(end, it->second);
+      ranges.erase(it++);
+    }
+    ranges[start] = end;
+  }
+
+  void dirtyRanges_t::remove(const udim_t offset,
+                             const udim_t bytes) {
+    const udim_t start = offset;
+    const udim_t end = offset + bytes;
+    if (end <= start) {
+      return;
+    }
+
+    rangeMap::iterator it = ranges.upper_bound(start);
+    if (it != ranges.begin()) {
+      --it;
+      if (it->second <= start) {
+        ++it;
+      }
+    }
+    while ((it != ranges.end()) && (it->first < end)) {
+      const udim_t rangeStart = it->first;
+      const udim_t rangeEnd = it->second;
+      ranges.erase(it++);
+      if (rangeStart < start) {
+        ranges[rangeStart] = start;
+      }
+      if (end < rangeEnd) {
+        ranges[end] = rangeEnd;
+      }
+    }
+  }
+
+  void dirtyRanges_t::clear() {
+    ranges.clear();
+  }
+
+  bool dirtyRanges_t::isEmpty() const {
+    return ranges.empty();
+  }
+
+  udim_t dirtyRanges_t::bytes() const {
+    udim_t bytes_ = 0;
+    rangeMap::const_iterator it = ranges.begin();
+    while (it != ranges.end()) {
+      bytes_ += (it->second - it->first);
+      ++it;
+    }
+    return bytes_;
+  }
+
+  json dirtyRanges_t::toJson() const {
+    json j;
+    j.asArray();
+    rangeMap::const_iterator it = ranges.begin();
+    while (it != ranges.end()) {
+      json range;
+      range.asArray();
+      range += (double) it->first;
+      range += (double) it->second;
+      j += range;
+      ++it;
+    }
+    return j;
+  }
+
+  uvaSyncStats_t::uvaSyncStats_t() :
+    copiedBytes(0),
+    savedBytes(0) {}
+
+  json uvaSyncStats_t::toJson() const {
+    json j(json::object_);
+    j.set("copied_bytes", (double) copiedBytes);
+    j.set("saved_bytes", (double) savedBytes);
+    return j;
+  }
+
+  uvaSyncStats_t getUvaSyncStats() {
+    uvaSyncStats_t stats;
+    stats.copiedBytes = uvaCopiedBytes;
+    stats.savedBytes = uvaSavedBytes;
+    return stats;
+  }
+
+  void resetUvaSyncStats() {
+    uvaCopiedBytes = 0;
+    uvaSavedBytes = 0;
+  }
+  //====================================
+
+
   //---[ UVA ]--------------------------
   occa::modeMemory_t* uvaToMemory(void *ptr) {
     if (!ptr) {
       return NULL;
     }
-    ptrRangeMap::iterator it = uvaMap.find(ptr);
-    return (it == uvaMap.end()) ? NULL : it->second;
+    return uvaMap.find(ptr);
   }
 
   bool isManaged(void *ptr) {
@@ -116,6 +402,53 @@ namespace occa {
     }
   }
 
+  void syncDirtyRanges(occa::modeMemory_t *mem,
+                       const bool toDevice,
+                       const occa::properties &props) {
+    const bool tracksDirty = (mem->memInfo & uvaFlag::tracksDirty);
+    const bool copyRanges = (tracksDirty
+                             && (mem->memInfo & uvaFlag::wasSynced));
+
+    udim_t copiedBytes = mem->size;
+    if (!copyRanges) {
+      if (toDevice) {
+        mem->copyFrom(mem->uvaPtr, mem->size, 0, props);
+      } else {
+        mem->copyTo(mem->uvaPtr, mem->size, 0, props);
+      }
+    } else {
+      // Undeclared bytes are unchanged since the last sync
+      copiedBytes = 0;
+      dirtyRanges_t::rangeMap::const_iterator it = mem->dirtyRanges.ranges.begin();
+      while (it != mem->dirtyRanges.ranges.end()) {
+        const udim_t offset = it->first;
+        const udim_t bytes = it->second - it->first;
+        if (toDevice) {
+          mem->copyFrom(mem->uvaPtr + offset, bytes, offset, props);
+        } else {
+          mem->copyTo(mem->uvaPtr + offset, bytes, offset, props);
+        }
+        copiedBytes += bytes;
+        ++it;
+      }
+    }
+
+    uvaCopiedBytes += copiedBytes;
+    uvaSavedBytes += (mem->size - copiedBytes);
+
+    mem->dirtyRanges.clear();
+    if (tracksDirty) {
+      mem->memInfo |= uvaFlag::wasSynced;
+    }
+  }
+
+  void markDirty(void *ptr, const udim_t bytes) {
+    occa::modeMemory_t *mem = uvaToMemory(ptr);
+    if (mem) {
+      occa::memory(mem).markDirty(bytes, ptrDiff(mem->uvaPtr, ptr));
+    }
+  }
+
   bool needsSync(void *ptr) {
     occa::modeMemory_t *mem = uvaToMemory(ptr);
     return mem ? mem->isStale() : false;
@@ -137,12 +470,12 @@ namespace occa {
   }
 
   void removeFromStaleMap(void *ptr) {
-    ptrRangeMap::iterator it = uvaMap.find(ptr);
-    if (it == uvaMap.end()) {
+    modeMemory_t *modeMemory = uvaMap.find(ptr);
+    if (!modeMemory) {
       return;
     }
 
-    memory m(it->second);
+    memory m(modeMemory);
     if (!m.uvaIsStale()) {
       return;
     }
@@ -1,10 +1,41 @@
-#include <occa.hpp>
-#include <occa/tools/testing.hpp>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <occa/modes/serial/device.hpp>
+
+#include "utils.hpp"
 
 void testProperties();
+void testAsyncStreams();
+void testKernelCache();
+void testBuildKernelAsync();
+void testLoadKernels();
+void testBuildKernels();
+void testSharedBinaries();
+void testPrecompiledHeaders();
+void testBuildStats();
 
 int main(const int argc, const char **argv) {
+  // Use a private cache to know which kernels were built by these tests
+  char cacheDir[] = "/tmp/occa_device_test_XXXXXX";
+  ASSERT_TRUE(::mkdtemp(cacheDir) != NULL);
+  occa::env::OCCA_CACHE_DIR = cacheDir;
+  occa::env::OCCA_CACHE_DIR += '/';
+
+  // Runs first to start from an empty cache
+  testLoadKernels();
+
   testProperties();
+  testAsyncStreams();
+  testKernelCache();
+  testBuildKernelAsync();
+  testBuildKernels();
+  testSharedBinaries();
+  testPrecompiledHeaders();
+  testBuildStats();
+
+  occa::sys::rmdir(occa::env::OCCA_CACHE_DIR, true);
 
   return 0;
 }
@@ -97,3 +128,481 @@ void testProperties() {
     (int) device.kernelProperties()["one"]
   );
 }
+
+void testAsyncStreams() {
+  occa::device device("mode: 'Serial'");
+
+  occa::kernel addOne = device.buildKernelFromString(
+    "@kernel void addOne(const int entries, float *x) {"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {"
+    "    x[i] += 1;"
+    "  }"
+    "}",
+    "addOne"
+  );
+
+  const int entries = 100;
+  const int launches = 20;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i;
+  }
+
+  occa::stream syncStream = device.getStream();
+  occa::stream asyncStream = device.createStream("async: true");
+  device.setStream(asyncStream);
+
+  occa::memory x = device.malloc(entries * sizeof(float));
+  x.copyFrom(values, "async: true");
+
+  occa::streamTag startTag = device.tagStream();
+  for (int i = 0; i < launches; ++i) {
+    addOne(entries, x);
+  }
+  occa::streamTag endTag = device.tagStream();
+
+  float asyncValues[entries];
+  x.copyTo(asyncValues, "async: true");
+  device.finish();
+
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(asyncValues[i], (float) (i + launches));
+  }
+  ASSERT_GE(device.timeBetween(startTag, endTag), 0.0);
+
+  // Blocking copies wait for the enqueued launches
+  addOne(entries, x);
+  x.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) (i + launches + 1));
+  }
+
+  // Tags can be waited on individually
+  addOne(entries, x);
+  occa::streamTag tag = device.tagStream();
+  tag.wait();
+  x.copyTo(values, "async: true");
+  device.finish();
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) (i + launches + 2));
+  }
+
+  // The default stream stays synchronous
+  device.setStream(syncStream);
+  addOne(entries, x);
+  ASSERT_EQ(x.ptr<float>()[0], (float) (launches + 3));
+}
+
+void setModifiedTime(const std::string &filename,
+                     const int secondsAgo) {
+  struct utimbuf times;
+  times.actime = times.modtime = ::time(NULL) - secondsAgo;
+  ::utime(filename.c_str(), &times);
+}
+
+void testKernelCache() {
+  occa::device device("mode: 'Serial'");
+
+  const std::string headerFile = (
+    occa::io::cachePath() + "test-kernel-cache/header.hpp"
+  );
+  occa::io::write(headerFile, "#define VALUE 1\n");
+
+  const std::string source = (
+    "#include \"" + headerFile + "\"\n"
+    + valueKernelSource()
+  );
+
+  occa::kernel setValue = device.buildKernelFromString(source, "setValue");
+  ASSERT_TRUE(setValue.isInitialized());
+
+  // Already-built kernels come from the device cache
+  occa::kernel setValue2 = device.buildKernelFromString(source, "setValue");
+  ASSERT_TRUE(setValue == setValue2);
+
+  // Different properties build a different kernel
+  occa::kernel setValue3 = device.buildKernelFromString(source, "setValue",
+                                                        "defines: { FOO: 1 }");
+  ASSERT_FALSE(setValue == setValue3);
+
+  // Dependency changes invalidate the cached kernel
+  occa::io::write(headerFile, "#define VALUE 2\n");
+  occa::kernel setValue4 = device.buildKernelFromString(source, "setValue");
+  ASSERT_FALSE(setValue == setValue4);
+  ASSERT_EQ(runValueKernel(setValue4), 2);
+
+  // Freed kernels are removed from the cache
+  setValue4.free();
+  ASSERT_FALSE(setValue4.isInitialized());
+  setValue4 = device.buildKernelFromString(source, "setValue");
+  ASSERT_EQ(runValueKernel(setValue4), 2);
+
+  // Repeated file builds skip hashing while the files keep their stamps,
+  //   which needs files older than the stamp's timestamp tick
+  const std::string sourceFile = (
+    occa::env::OCCA_CACHE_DIR + "tests/kernel-cache/setValue.okl"
+  );
+  occa::io::write(headerFile, "#define VALUE 3\n");
+  occa::io::write(sourceFile, source);
+  setModifiedTime(headerFile, 10);
+  setModifiedTime(sourceFile, 10);
+
+  occa::kernel fileKernel = device.buildKernel(sourceFile, "setValue");
+  occa::resetBuildStats();
+  occa::kernel fileKernel2 = device.buildKernel(sourceFile, "setValue");
+  ASSERT_TRUE(fileKernel == fileKernel2);
+
+  occa::buildStats_t stats = occa::getBuildStats();
+  ASSERT_EQ(stats.memoryCacheHits, 1);
+  ASSERT_FALSE(stats.stageTimes[occa::buildStage::hashing] > 0.0);
+  ASSERT_FALSE(stats.stageTimes[occa::buildStage::dependencies] > 0.0);
+
+  // Devices with the same properties share them
+  occa::device device2("mode: 'Serial'");
+  occa::resetBuildStats();
+  occa::kernel fileKernel3 = device2.buildKernel(sourceFile, "setValue");
+  stats = occa::getBuildStats();
+  ASSERT_EQ(stats.diskCacheHits, 1);
+  ASSERT_FALSE(stats.stageTimes[occa::buildStage::hashing] > 0.0);
+
+  // Changed dependencies are hashed again
+  occa::io::write(headerFile, "#define VALUE 4\n");
+  setModifiedTime(headerFile, 5);
+  fileKernel2 = device.buildKernel(sourceFile, "setValue");
+  ASSERT_FALSE(fileKernel == fileKernel2);
+  ASSERT_EQ(runValueKernel(fileKernel2), 4);
+
+  occa::sys::rmrf(occa::io::cachePath() + "test-kernel-cache");
+  occa::sys::rmrf(occa::env::OCCA_CACHE_DIR + "tests/kernel-cache");
+}
+
+void testBuildKernelAsync() {
+  occa::device device("mode: 'Serial'");
+
+  const std::string source = valueKernelSource();
+
+  const int kernelCount = 8;
+  std::vector<occa::kernelFuture> futures;
+  for (int i = 0; i < kernelCount; ++i) {
+    occa::properties props;
+    props["defines/VALUE"] = i;
+    futures.push_back(
+      device.buildKernelFromStringAsync(source, "setValue", props)
+    );
+  }
+
+  for (int i = 0; i < kernelCount; ++i) {
+    ASSERT_TRUE(futures[i].isInitialized());
+
+    occa::kernel setValue = futures[i].get();
+    ASSERT_TRUE(futures[i].isReady());
+    ASSERT_EQ(runValueKernel(setValue, -1), i);
+  }
+
+  // Built kernels are cached
+  occa::properties props;
+  props["defines/VALUE"] = 0;
+  occa::kernelFuture future = device.buildKernelFromStringAsync(source, "setValue", props);
+  ASSERT_TRUE(future.isReady());
+  ASSERT_TRUE(future.get() == futures[0].get());
+
+  // Build errors are thrown when fetching the kernel
+  occa::kernelFuture badFuture = device.buildKernelFromStringAsync(
+    "@kernel void foo(int *x) { x[0] = UNDEFINED_VALUE; }",
+    "foo"
+  );
+  ASSERT_THROW(
+    badFuture.get();
+  );
+
+  // Dropping a future waits for its build
+  device.buildKernelFromStringAsync(source, "setValue", "defines: { VALUE: 100 }");
+
+  // Batch builds through kernelBuilder
+  std::vector<occa::kernelBuilder> builders;
+  std::vector<occa::kernelBuilder*> builderPtrs;
+  for (int i = 0; i < 3; ++i) {
+    occa::properties builderProps;
+    builderProps["defines/VALUE"] = 200 + i;
+    builders.push_back(
+      occa::kernelBuilder::fromString(source, "setValue", builderProps)
+    );
+  }
+  for (int i = 0; i < 3; ++i) {
+    builderPtrs.push_back(&builders[i]);
+  }
+  occa::kernelBuilder::buildAll(device, builderPtrs);
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_EQ(runValueKernel(builders[i].build(device)), 200 + i);
+  }
+
+  // Freeing the device waits for running builds and cancels queued ones
+  occa::device device2("mode: 'Serial'");
+  const int stamp = (int) ((long long) (1000 * occa::sys::currentTime()) % 1000000007);
+  std::vector<occa::kernelFuture> freedFutures;
+  for (int i = 0; i < kernelCount; ++i) {
+    occa::properties freedProps;
+    freedProps["defines/VALUE"] = i;
+    freedProps["defines/STAMP"] = stamp;
+    freedFutures.push_back(
+      device2.buildKernelFromStringAsync(source, "setValue", freedProps)
+    );
+  }
+  device2.free();
+  for (int i = 0; i < kernelCount; ++i) {
+    ASSERT_TRUE(freedFutures[i].isReady());
+    ASSERT_THROW(
+      freedFutures[i].get();
+    );
+  }
+}
+
+void testLoadKernels() {
+  const std::string source = (
+    valueKernelSource("setValue", "x[i] = 3;")
+    + valueKernelSource("addValue", "x[i] += 3;")
+  );
+
+  occa::hash_t kernelHash;
+  {
+    occa::device device("mode: 'Serial'");
+    occa::kernel setValue = device.buildKernelFromString(source, "setValue");
+    kernelHash = setValue.hash();
+  }
+
+  // New devices start with an empty kernel cache
+  occa::device device("mode: 'Serial'");
+  ASSERT_FALSE(device.getCachedKernel(kernelHash, "setValue").isInitialized());
+
+  // Every kernel from the cached binary is loaded
+  ASSERT_EQ(device.loadKernels(), 2);
+  occa::kernel setValue = device.getCachedKernel(kernelHash, "setValue");
+  occa::kernel addValue = device.getCachedKernel(kernelHash, "addValue");
+  ASSERT_TRUE(setValue.isInitialized());
+  ASSERT_TRUE(addValue.isInitialized());
+  ASSERT_TRUE(device.buildKernelFromString(source, "addValue") == addValue);
+  ASSERT_EQ(runValueKernel(setValue), 3);
+  ASSERT_EQ(runValueKernel(addValue, 3), 6);
+
+  // Library kernels are installed into the cache before loading them
+  const std::string hashDir = occa::io::hashDir(kernelHash);
+  ASSERT_TRUE(occa::io::addCacheEntryToLibrary(hashDir, "test-load-kernels"));
+  occa::sys::rmrf(hashDir);
+  ASSERT_FALSE(occa::io::isDir(hashDir));
+
+  occa::device libraryDevice("mode: 'Serial'");
+  ASSERT_EQ(libraryDevice.loadKernels("test-load-kernels"), 2);
+  ASSERT_TRUE(occa::io::isDir(hashDir));
+  ASSERT_TRUE(libraryDevice.getCachedKernel(kernelHash, "setValue").isInitialized());
+  ASSERT_TRUE(libraryDevice.getCachedKernel(kernelHash, "addValue").isInitialized());
+
+  ASSERT_EQ(libraryDevice.loadKernels("missing-library"), 0);
+
+  occa::sys::rmrf(occa::io::libraryCachePath("test-load-kernels"));
+
+  // Entries whose binary no longer loads are skipped
+  occa::hash_t staleHash;
+  {
+    occa::device staleDevice("mode: 'Serial'");
+    staleHash = staleDevice.buildKernelFromString(
+      valueKernelSource("staleValue", "x[i] = 4;"),
+      "staleValue"
+    ).hash();
+  }
+  const std::string staleDir = occa::io::hashDir(staleHash);
+  occa::io::write(staleDir + "binary", "not a binary");
+  occa::io::markCachedFileComplete(staleDir, "binary");
+
+  occa::device verboseDevice("mode: 'Serial', verbose: true");
+  ASSERT_EQ(verboseDevice.loadKernels(), 2);
+  ASSERT_FALSE(verboseDevice.getCachedKernel(staleHash, "staleValue").isInitialized());
+
+  occa::sys::rmrf(staleDir);
+}
+
+void testBuildKernels() {
+  occa::device device("mode: 'Serial'");
+
+  const std::string filename = (
+    occa::io::cachePath() + "test-build-kernels/kernels.okl"
+  );
+  occa::io::write(filename,
+                  valueKernelSource("setValue", "x[i] = 3;")
+                  + valueKernelSource("addValue", "x[i] += 3;"));
+
+  occa::namedKernelMap kernels = device.buildKernels(filename);
+  ASSERT_EQ((int) kernels.size(), 2);
+
+  occa::kernel setValue = kernels["setValue"];
+  occa::kernel addValue = kernels["addValue"];
+  ASSERT_TRUE(setValue.isInitialized());
+  ASSERT_TRUE(addValue.isInitialized());
+  ASSERT_EQ(setValue.binaryFilename(), addValue.binaryFilename());
+  ASSERT_EQ(runValueKernel(addValue, runValueKernel(setValue)), 6);
+
+  // Kernels are added to the kernel cache
+  ASSERT_TRUE(device.buildKernel(filename, "addValue") == addValue);
+
+  occa::namedKernelMap cachedKernels = device.buildKernels(filename);
+  ASSERT_TRUE(cachedKernels["setValue"] == setValue);
+  ASSERT_TRUE(cachedKernels["addValue"] == addValue);
+
+  // Kernels keep working after the others are freed
+  setValue.free();
+  kernels.clear();
+  cachedKernels.clear();
+  ASSERT_EQ(runValueKernel(addValue, 6), 9);
+
+  occa::sys::rmrf(occa::io::cachePath() + "test-build-kernels");
+}
+
+bool isSameFile(const std::string &a, const std::string &b) {
+  struct stat aStat, bStat;
+  return (!::stat(a.c_str(), &aStat)
+          && !::stat(b.c_str(), &bStat)
+          && (aStat.st_dev == bStat.st_dev)
+          && (aStat.st_ino == bStat.st_ino));
+}
+
+void testSharedBinaries() {
+  occa::device device("mode: 'Serial'");
+
+  const std::string source = valueKernelSource();
+
+  occa::properties props;
+  props["defines/VALUE"] = 4;
+  props["defines/UNUSED"] = 1;
+  occa::kernel setValue = device.buildKernelFromString(source, "setValue", props);
+
+  // Unused defines don't change the emitted source
+  props["defines/UNUSED"] = 2;
+  occa::kernel setValue2 = device.buildKernelFromString(source, "setValue", props);
+  ASSERT_NEQ(setValue.hash(), setValue2.hash());
+  ASSERT_TRUE(isSameFile(setValue.binaryFilename(), setValue2.binaryFilename()));
+
+  props["defines/VALUE"] = 5;
+  occa::kernel setValue3 = device.buildKernelFromString(source, "setValue", props);
+  ASSERT_FALSE(isSameFile(setValue.binaryFilename(), setValue3.binaryFilename()));
+
+  ASSERT_EQ(runValueKernel(setValue2), 4);
+  ASSERT_EQ(runValueKernel(setValue3), 5);
+
+  // Binaries are only shared when enabled
+  occa::settings()["cache/share_binaries"] = false;
+  props["defines/VALUE"] = 4;
+  props["defines/UNUSED"] = 3;
+  occa::kernel setValue4 = device.buildKernelFromString(source, "setValue", props);
+  ASSERT_FALSE(isSameFile(setValue.binaryFilename(), setValue4.binaryFilename()));
+  occa::settings()["cache/share_binaries"] = true;
+}
+
+void testPrecompiledHeaders() {
+  occa::device device("mode: 'Serial'");
+
+  occa::kernel setValue = device.buildKernelFromString(
+    valueKernelSource("setValue", "x[i] = (int) sqrt(49.0);"),
+    "setValue"
+  );
+  ASSERT_EQ(runValueKernel(setValue), 7);
+
+  // g++ builds the precompiled header in the cache
+  const int vendor = device.properties()["kernel/compiler_vendor"];
+  if (vendor & occa::sys::vendor::GNU) {
+    bool foundPch = false;
+    occa::strVector dirs = occa::io::directories(occa::io::cachePath());
+    for (int i = 0; i < (int) dirs.size(); ++i) {
+      if (occa::io::cachedFileIsComplete(dirs[i], "pch.hpp.gch")) {
+        foundPch = true;
+        ASSERT_FALSE(occa::serial::device::precompiledHeaderIsStale(dirs[i]));
+      }
+    }
+    ASSERT_TRUE(foundPch);
+
+    // The kernel compile uses it, even with a language flag set by the user
+    occa::properties props;
+    props["compiler_flags"] = (
+      (std::string) device.properties()["kernel/compiler_flags"]
+      + " -x c++ -H -Winvalid-pch"
+    );
+    occa::kernel pchKernel = device.buildKernelFromString(
+      valueKernelSource("setValue", "x[i] = 8;"),
+      "setValue",
+      props
+    );
+    ASSERT_EQ(runValueKernel(pchKernel), 8);
+
+    // [-H] marks headers loaded from a valid precompiled header with [!]
+    const std::string buildLog = occa::io::read(
+      occa::io::dirname(pchKernel.binaryFilename()) + occa::kc::buildLogFile
+    );
+    const size_t pchLine = buildLog.find(occa::kc::pchHeaderFile + ".gch");
+    ASSERT_TRUE(pchLine != std::string::npos);
+    ASSERT_EQ(buildLog.substr(buildLog.rfind('\n', pchLine) + 1, 2), "! ");
+  }
+
+  // Changed headers invalidate the precompiled header
+  const std::string hashDir = occa::io::cachePath() + "test-pch/";
+  const std::string headerFile = hashDir + "header.hpp";
+  occa::io::write(headerFile, "#define VALUE 1\n");
+
+  occa::json dependencies(occa::json::object_);
+  dependencies.set(headerFile,
+                   occa::hashFile(headerFile).getFullString());
+  dependencies.write(hashDir + "pch_dependencies.json");
+  ASSERT_FALSE(occa::serial::device::precompiledHeaderIsStale(hashDir));
+
+  occa::io::write(headerFile, "#define VALUE 2\n");
+  ASSERT_TRUE(occa::serial::device::precompiledHeaderIsStale(hashDir));
+
+  occa::sys::rmrf(hashDir);
+  ASSERT_TRUE(occa::serial::device::precompiledHeaderIsStale(hashDir));
+}
+
+void testBuildStats() {
+  occa::device device("mode: 'Serial'");
+  occa::resetBuildStats();
+
+  const std::string source = valueKernelSource("setStamp", "x[i] = STAMP;");
+
+  // Each run compiles a new kernel
+  const long long stamp = (long long) (1000 * occa::sys::currentTime());
+  occa::properties props;
+  props["defines/STAMP"] = (int) (stamp % 1000000007);
+
+  occa::kernel setStamp = device.buildKernelFromString(source, "setStamp", props);
+
+  occa::buildStats_t stats = occa::getBuildStats();
+  ASSERT_EQ(stats.cacheMisses, 1);
+  ASSERT_EQ(stats.memoryCacheHits, 0);
+  ASSERT_EQ(stats.diskCacheHits, 0);
+  ASSERT_TRUE(stats.stageTimes[occa::buildStage::hashing] > 0.0);
+  ASSERT_TRUE(stats.stageTimes[occa::buildStage::parsing] > 0.0);
+  ASSERT_TRUE(stats.stageTimes[occa::buildStage::codegen] > 0.0);
+  ASSERT_TRUE(stats.stageTimes[occa::buildStage::compiling] > 0.0);
+  ASSERT_TRUE(stats.stageTimes[occa::buildStage::loading] > 0.0);
+
+  // Kernels and their build.json keep the stats from their build
+  const occa::json &kernelStats = setStamp.properties()["build_stats"];
+  ASSERT_EQ((int) kernelStats["cache/misses"], 1);
+  ASSERT_TRUE((double) kernelStats["stages/compiling"] > 0.0);
+
+  occa::json buildJson = occa::json::read(
+    occa::io::dirname(setStamp.binaryFilename()) + occa::kc::buildFile
+  );
+  ASSERT_EQ((int) buildJson["build/stats/cache/misses"], 1);
+
+  device.buildKernelFromString(source, "setStamp", props);
+  ASSERT_EQ(occa::getBuildStats().memoryCacheHits, 1);
+
+  // New devices load the cached binary
+  occa::device device2("mode: 'Serial'");
+  occa::kernel setStamp2 = device2.buildKernelFromString(source, "setStamp", props);
+  stats = occa::getBuildStats();
+  ASSERT_EQ(stats.diskCacheHits, 1);
+  ASSERT_EQ(stats.cacheMisses, 1);
+  ASSERT_EQ((int) setStamp2.properties()["build_stats/cache/disk_hits"], 1);
+  ASSERT_EQ((int) setStamp2.properties()["build_stats/cache/misses"], 0);
+
+  occa::resetBuildStats();
+  ASSERT_FALSE(occa::getBuildStats().totalTime() > 0.0);
+}
@@ -0,0 +1,198 @@
+#include "utils.hpp"
+
+void testCapture();
+void testReplay();
+void testStreamCapture();
+void testErrors();
+
+occa::kernel addScalar;
+
+int main(const int argc, const char **argv) {
+  addScalar = occa::buildKernelFromString(addScalarSource(), "addScalar");
+
+  testCapture();
+  testReplay();
+  testStreamCapture();
+  testErrors();
+
+  return 0;
+}
+
+void testCapture() {
+  const int entries = 10;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = i;
+  }
+  occa::memory x = occa::malloc<float>(entries);
+  occa::memory y = occa::malloc<float>(entries);
+
+  occa::device device = occa::getDevice();
+  ASSERT_FALSE(device.isCapturing());
+
+  occa::beginCapture();
+  ASSERT_TRUE(device.isCapturing());
+
+  x.copyFrom(values);
+  addScalar(entries, (float) 1.0, x);
+  y.copyFrom(x);
+  addScalar(entries, (float) 2.0, y);
+  y.copyTo(values);
+
+  occa::graph graph = occa::endCapture();
+  ASSERT_FALSE(device.isCapturing());
+
+  ASSERT_TRUE(graph.isInitialized());
+  ASSERT_EQ(graph.size(), 5);
+  ASSERT_EQ(graph.launchCount(), 2);
+
+  // Nothing runs while capturing
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) i);
+  }
+
+  graph.run();
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) (i + 3));
+  }
+}
+
+void testReplay() {
+  const int entries = 10;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = 0;
+  }
+  occa::memory x = occa::malloc<float>(entries, values);
+
+  occa::beginCapture();
+  addScalar(entries, (float) 1.0, x);
+  addScalar(entries, (float) 1.0, x);
+  occa::graph graph = occa::endCapture();
+
+  // Copies share the recorded launches
+  occa::graph graph2 = graph;
+  graph2();
+
+  // Bind a different scalar per replay
+  for (int step = 1; step <= 3; ++step) {
+    graph.setArg(0, 1, (float) step);
+    graph.run();
+  }
+  x.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) (2 + (1 + 2 + 3) + 3));
+  }
+
+  ASSERT_TRUE(graph.getLaunch(1).getKernel() == addScalar);
+}
+
+void testStreamCapture() {
+  const int entries = 10;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = 0;
+  }
+  occa::memory x = occa::malloc<float>(entries, values);
+  occa::memory y = occa::malloc<float>(entries, values);
+
+  occa::device device = occa::getDevice();
+  occa::stream stream1 = device.getStream();
+  occa::stream stream2 = device.createStream();
+
+  // Each stream captures its own launches
+  occa::beginCapture();
+  addScalar(entries, (float) 1.0, x);
+
+  device.setStream(stream2);
+  ASSERT_FALSE(device.isCapturing());
+  occa::beginCapture();
+  addScalar(entries, (float) 2.0, y);
+  occa::graph graph2 = occa::endCapture();
+
+  // Streams which aren't capturing run their launches
+  addScalar(entries, (float) 4.0, x);
+  device.finish();
+  x.copyTo(values);
+  ASSERT_EQ(values[0], (float) 4.0);
+
+  device.setStream(stream1);
+  ASSERT_TRUE(device.isCapturing());
+  occa::graph graph1 = occa::endCapture();
+  ASSERT_EQ(graph1.launchCount(), 1);
+  ASSERT_EQ(graph2.launchCount(), 1);
+
+  graph1.run();
+  graph2.run();
+  x.copyTo(values);
+  ASSERT_EQ(values[0], (float) 5.0);
+  y.copyTo(values);
+  ASSERT_EQ(values[0], (float) 2.0);
+
+  // Freeing a capturing stream drops its graph
+  device.setStream(stream2);
+  occa::beginCapture();
+  addScalar(entries, (float) 1.0, y);
+  device.setStream(stream1);
+  stream2.free();
+  ASSERT_FALSE(device.isCapturing());
+}
+
+void testErrors() {
+  occa::graph graph;
+  ASSERT_FALSE(graph.isInitialized());
+  ASSERT_EQ(graph.size(), 0);
+  ASSERT_THROW(
+    graph.run();
+  );
+
+  ASSERT_THROW(
+    occa::endCapture();
+  );
+
+  occa::beginCapture();
+  ASSERT_THROW(
+    occa::beginCapture();
+  );
+
+  // Arguments are still validated when captured
+  occa::memory ints = occa::malloc<int>(10);
+  ASSERT_THROW(
+    addScalar(10, (float) 1.0, ints);
+  );
+  graph = occa::endCapture();
+  ASSERT_EQ(graph.size(), 0);
+
+  // Only scalars can be rebound
+  occa::memory x = occa::malloc<float>(10);
+  occa::beginCapture();
+  addScalar(10, (float) 1.0, x);
+  graph = occa::endCapture();
+  ASSERT_THROW(
+    graph.setArg(0, 2, x);
+  );
+  ASSERT_THROW(
+    graph.setArg(1, 0, 1);
+  );
+
+  // Captured memory outlives the caller's references
+  {
+    occa::memory y = occa::malloc<float>(10);
+    occa::beginCapture();
+    addScalar(10, (float) 1.0, y);
+    graph = occa::endCapture();
+  }
+  graph.run();
+
+  // Replaying after captured memory was freed throws
+  occa::memory z = occa::malloc<float>(10);
+  occa::beginCapture();
+  addScalar(10, (float) 1.0, z);
+  z.copyTo(x);
+  graph = occa::endCapture();
+  graph.run();
+  z.free();
+  ASSERT_THROW(
+    graph.run();
+  );
+}
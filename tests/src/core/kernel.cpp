@@ -1,5 +1,28 @@
-#include <occa.hpp>
-#include <occa/tools/testing.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+#include "utils.hpp"
+
+// Count heap allocations to verify the launch path is allocation-free
+static bool countAllocations = false;
+static int allocationCount = 0;
+
+void* operator new(size_t bytes) {
+  if (countAllocations) {
+    ++allocationCount;
+  }
+  void *ptr = ::malloc(bytes ? bytes : 1);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  ::free(ptr);
+}
 
 occa::kernel addVectors;
 const std::string addVectorsFile = (
@@ -12,6 +35,12 @@ void testParsingFailure();
 void testCompilingFailure();
 void testArgumentFailure();
 void testRun();
+void testLaunchAllocations();
+void testTypeValidation();
+void testBind();
+void testBindValues();
+void testManyArguments();
+void benchmarkLaunchLatency();
 
 int main(const int argc, const char **argv) {
   addVectors = occa::buildKernel(addVectorsFile,
@@ -23,6 +52,16 @@ int main(const int argc, const char **argv) {
   testCompilingFailure();
   testArgumentFailure();
   testRun();
+  testLaunchAllocations();
+  testTypeValidation();
+  testBind();
+  testBindValues();
+  testManyArguments();
+
+  // Launch latency benchmark: core-kernel --benchmark
+  if ((argc > 1) && !strcmp(argv[1], "--benchmark")) {
+    benchmarkLaunchLatency();
+  }
 
   return 0;
 }
@@ -180,3 +219,257 @@ void testRun() {
 
   occa::freeUvaPtr(uvaPtr);
 }
+
+void testLaunchAllocations() {
+  const int entries = 16;
+  occa::memory a  = occa::malloc<float>(entries);
+  occa::memory b  = occa::malloc<float>(entries);
+  occa::memory ab = occa::malloc<float>(entries);
+
+  // Warm up the kernel's argument buffer
+  addVectors(entries, a, b, ab);
+
+  countAllocations = true;
+  for (int i = 0; i < 100; ++i) {
+    addVectors(entries, a, b, ab);
+  }
+  countAllocations = false;
+
+  ASSERT_EQ(allocationCount, 0);
+}
+
+void testTypeValidation() {
+  const int entries = 16;
+  occa::memory a    = occa::malloc<float>(entries);
+  occa::memory b    = occa::malloc<float>(entries);
+  occa::memory ab   = occa::malloc<float>(entries);
+  occa::memory ints = occa::malloc<int>(entries);
+
+  addVectors(entries, a, b, ab);
+  ASSERT_THROW(
+    addVectors(entries, a, b, ints);
+  );
+  ASSERT_THROW(
+    addVectors(entries, a, b);
+  );
+  ASSERT_THROW(
+    addVectors(entries, a, b, entries);
+  );
+  addVectors(entries, a, b, ab);
+
+  // Validated once, then only re-validated when dtypes change
+  occa::kernel addVectorsOnce = occa::buildKernel(addVectorsFile,
+                                                  "addVectors",
+                                                  "type_validation: 'once'");
+  addVectorsOnce(entries, a, b, ab);
+  addVectorsOnce(entries, a, b, ab);
+  ASSERT_THROW(
+    addVectorsOnce(entries, a, b, ints);
+  );
+  ASSERT_THROW(
+    addVectorsOnce(entries, a, b);
+  );
+  ASSERT_THROW(
+    addVectorsOnce(entries, a, b, entries);
+  );
+  ASSERT_THROW(
+    addVectorsOnce(entries, a, entries, ab);
+  );
+  addVectorsOnce(entries, a, b, ab);
+}
+
+void testBind() {
+  occa::kernel addScalar = occa::buildKernelFromString(addScalarSource(), "addScalar");
+
+  const int entries = 10;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = 0;
+  }
+  occa::memory x = occa::malloc<float>(entries, values);
+  occa::memory ints = occa::malloc<int>(entries);
+
+  occa::boundKernel boundAddScalar = addScalar.bind(entries, (float) 1.0, x);
+  ASSERT_TRUE(boundAddScalar.isInitialized());
+  ASSERT_EQ(boundAddScalar.argumentCount(), 3);
+
+  boundAddScalar();
+  boundAddScalar.setArg(1, (float) 2.0);
+  boundAddScalar.run();
+
+  // Launches through the kernel don't modify the bound arguments
+  addScalar(entries, (float) 4.0, x);
+  boundAddScalar.setArg(0, entries / 2);
+  boundAddScalar();
+
+  x.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i],
+              (float) ((i < (entries / 2)) ? 9.0 : 7.0));
+  }
+
+  // Only scalars of the same size can be updated
+  ASSERT_THROW(
+    boundAddScalar.setArg(2, x);
+  );
+  ASSERT_THROW(
+    boundAddScalar.setArg(1, (double) 2.0);
+  );
+  ASSERT_THROW(
+    boundAddScalar.setArg(3, 1);
+  );
+
+  // Arguments are validated when binding
+  ASSERT_THROW(
+    addScalar.bind(entries, (float) 1.0, ints);
+  );
+  ASSERT_THROW(
+    addScalar.bind(entries, (float) 1.0);
+  );
+
+  // Bound memory outlives the caller's references
+  occa::boundKernel boundScoped;
+  {
+    occa::memory y = occa::malloc<float>(entries, values);
+    boundScoped = addScalar.bind(entries, (float) 1.0, y);
+  }
+  boundScoped();
+
+  // Launching after the memory was freed throws instead of using it
+  occa::memory z = occa::malloc<float>(entries, values);
+  occa::boundKernel boundFreed = addScalar.bind(entries, (float) 1.0, z);
+  boundFreed();
+  z.free();
+  ASSERT_THROW(
+    boundFreed();
+  );
+}
+
+occa::boundKernel bindTemporaryFloat2(occa::kernel kernel,
+                                      const int entries,
+                                      occa::memory x) {
+  return kernel.bind(entries, occa::float2(1, 2), x);
+}
+
+void overwriteStack() {
+  volatile char buffer[4096];
+  for (int i = 0; i < 4096; ++i) {
+    buffer[i] = (char) 0xFF;
+  }
+  (void) buffer[0];
+}
+
+void testBindValues() {
+  occa::kernel addFloat2 = occa::buildKernelFromString(
+    "@kernel void addFloat2(const int entries, const float2 value, float *x) {"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {"
+    "    x[i] += value.x + value.y;"
+    "  }"
+    "}",
+    "addFloat2"
+  );
+
+  const int entries = 10;
+  float values[entries];
+  for (int i = 0; i < entries; ++i) {
+    values[i] = 0;
+  }
+  occa::memory x = occa::malloc<float>(entries, values);
+
+  // Vector values are copied, the temporary is gone before the launch
+  occa::boundKernel boundAddFloat2 = bindTemporaryFloat2(addFloat2, entries, x);
+  overwriteStack();
+  boundAddFloat2();
+
+  // Copies of the bound kernel keep their own values
+  occa::boundKernel boundCopy = boundAddFloat2;
+  boundAddFloat2 = occa::boundKernel();
+  overwriteStack();
+  boundCopy();
+
+  x.copyTo(values);
+  for (int i = 0; i < entries; ++i) {
+    ASSERT_EQ(values[i], (float) 6.0);
+  }
+}
+
+void testManyArguments() {
+  // Serial kernels are launched through their generated entry
+  //   and are not limited to OCCA_MAX_ARGS arguments
+  const int argCount = OCCA_MAX_ARGS + 10;
+
+  std::stringstream ss;
+  ss << "@kernel void sumArgs(int *sum";
+  for (int i = 0; i < argCount; ++i) {
+    ss << ", const int a" << i;
+  }
+  ss << ") {"
+     << "  for (int i = 0; i < 1; ++i; @tile(1, @outer, @inner)) {"
+     << "    sum[i] = 0";
+  for (int i = 0; i < argCount; ++i) {
+    ss << " + a" << i;
+  }
+  ss << ";"
+     << "  }"
+     << "}";
+
+  occa::kernel sumArgs = occa::buildKernelFromString(ss.str(),
+                                                     "sumArgs");
+
+  int sum = 0;
+  occa::memory o_sum = occa::malloc<int>(1, &sum);
+
+  sumArgs.clearArgs();
+  sumArgs.pushArg(o_sum);
+  for (int i = 0; i < argCount; ++i) {
+    sumArgs.pushArg(i);
+  }
+  sumArgs.run();
+
+  o_sum.copyTo(&sum);
+  ASSERT_EQ(sum,
+            (argCount * (argCount - 1)) / 2);
+}
+
+void benchmarkLaunchLatency() {
+  // The same kernel launched through its generated entry
+  //   and through sys::runFunction
+  const int argCounts[3] = {1, 8, 40};
+  const int iterations = 100000;
+
+  for (int c = 0; c < 3; ++c) {
+    const int argCount = argCounts[c];
+
+    std::stringstream ss;
+    ss << "@kernel void noop(const int a0";
+    for (int i = 1; i < argCount; ++i) {
+      ss << ", const int a" << i;
+    }
+    ss << ") {"
+       << "  for (int i = 0; i < 1; ++i; @tile(1, @outer, @inner)) {}"
+       << "}";
+
+    occa::kernel kernels[2] = {
+      occa::buildKernelFromString(ss.str(), "noop"),
+      occa::buildKernelFromString(ss.str(), "noop",
+                                  "serial: { kernel_entry: false }")
+    };
+
+    for (int k = 0; k < 2; ++k) {
+      occa::kernel &kernel = kernels[k];
+      kernel.clearArgs();
+      for (int i = 0; i < argCount; ++i) {
+        kernel.pushArg(i);
+      }
+
+      const double start = occa::sys::currentTime();
+      for (int i = 0; i < iterations; ++i) {
+        kernel.run();
+      }
+      const double elapsed = occa::sys::currentTime() - start;
+      std::cout << (k ? "runFunction" : "entry")
+                << ", " << argCount << " args: "
+                << (1e9 * elapsed / iterations) << " ns/launch\n";
+    }
+  }
+}
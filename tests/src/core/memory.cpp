@@ -1,14 +1,31 @@
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <occa.hpp>
+#include <occa/modes/serial/memory.hpp>
 #include <occa/tools/testing.hpp>
 
 void testMalloc();
 void testCpuWrapMemory();
 void testSlice();
+void testMemoryPool();
+void testMemoryPlacement();
+void testMmap();
+void benchmarkMemoryPool();
 
 int main(const int argc, const char **argv) {
   testMalloc();
   testCpuWrapMemory();
   testSlice();
+  testMemoryPool();
+  testMemoryPlacement();
+  testMmap();
+
+  // Allocation benchmark: core-memory --benchmark
+  if ((argc > 1) && !strcmp(argv[1], "--benchmark")) {
+    benchmarkMemoryPool();
+  }
 
   return 0;
 }
@@ -116,3 +133,258 @@ void testSlice() {
   }
   ASSERT_SAME_SIZE(device.memoryAllocated(), 0);
 }
+
+void testMemoryPool() {
+  ASSERT_SAME_SIZE(occa::memoryPool_t::sizeClass(1), 256);
+  ASSERT_SAME_SIZE(occa::memoryPool_t::sizeClass(1000), 1024);
+  ASSERT_SAME_SIZE(occa::memoryPool_t::sizeClass(1025), 1280);
+  ASSERT_SAME_SIZE(occa::memoryPool_t::sizeClass(1 << 20), 1 << 20);
+
+  occa::device device(
+    "mode: 'Serial',"
+    "memory: {"
+    "  pool: true,"
+    "}"
+  );
+
+  int values[4] = {1, 2, 3, 4};
+  void *ptr = NULL;
+  {
+    occa::memory mem = device.malloc<int>(4, values);
+    ptr = mem.ptr();
+    ASSERT_SAME_SIZE(device.memoryAllocated(), 4 * sizeof(int));
+    ASSERT_SAME_SIZE(mem.size(), 4 * sizeof(int));
+  }
+  ASSERT_SAME_SIZE(device.memoryAllocated(), 0);
+
+  occa::memoryPoolStats_t stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.cachedBlocks, 1);
+  ASSERT_SAME_SIZE(stats.cachedBytes, 256);
+  ASSERT_SAME_SIZE(stats.allocatedBlocks, 1);
+
+  // Same size class, freed blocks are reused
+  {
+    int newValues[3] = {5, 6, 7};
+    occa::memory mem = device.malloc<int>(3, newValues);
+    ASSERT_EQ(mem.ptr(), ptr);
+    ASSERT_SAME_SIZE(mem.size(), 3 * sizeof(int));
+    ASSERT_SAME_SIZE(device.memoryAllocated(), 3 * sizeof(int));
+    ASSERT_EQ(mem.ptr<int>()[2], 7);
+
+    // Explicit frees also go to the pool and null other wrappers
+    occa::memory mem2 = mem;
+    mem.free();
+    ASSERT_FALSE(mem2.isInitialized());
+  }
+  stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.reusedBlocks, 1);
+  ASSERT_SAME_SIZE(stats.cachedBlocks, 1);
+
+  // Different properties don't share blocks
+  {
+    occa::memory mem = device.malloc<int>(4, occa::properties("tag: 1"));
+    ASSERT_NEQ(mem.ptr(), ptr);
+
+    // Allocations without the pool are unchanged
+    occa::memory unpooled = device.malloc<int>(4, occa::properties("pool: false"));
+    ASSERT_NEQ(unpooled.ptr(), ptr);
+  }
+  stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.allocatedBlocks, 2);
+  ASSERT_SAME_SIZE(stats.cachedBlocks, 2);
+
+  device.trimMemoryPool(256);
+  stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.cachedBlocks, 1);
+  ASSERT_SAME_SIZE(stats.releasedBlocks, 1);
+
+  device.trimMemoryPool();
+  stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.cachedBytes, 0);
+  ASSERT_SAME_SIZE(stats.releasedBlocks, 2);
+
+  // pool_max_bytes caps the cached bytes
+  {
+    occa::memory mem1 = device.malloc<char>(1000, occa::properties("pool_max_bytes: 1024"));
+    occa::memory mem2 = device.malloc<char>(1000, occa::properties("pool_max_bytes: 1024"));
+  }
+  stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.cachedBytes, 1024);
+  ASSERT_SAME_SIZE(device.memoryAllocated(), 0);
+
+  // Blocks freed on other streams are reused after the stream finishes
+  occa::stream stream1 = device.getStream();
+  occa::stream stream2 = device.createStream();
+  {
+    occa::memory mem = device.malloc<int>(4);
+    ptr = mem.ptr();
+  }
+  device.setStream(stream2);
+  {
+    occa::memory mem = device.malloc<int>(4);
+    ASSERT_EQ(mem.ptr(), ptr);
+  }
+  device.setStream(stream1);
+
+  // Detached blocks leave the pool
+  {
+    occa::memory mem = device.malloc<int>(4);
+    ASSERT_TRUE(mem.getModeMemory()->isPooled);
+    ptr = mem.ptr();
+    mem.detach();
+    ASSERT_FALSE(mem.isInitialized());
+    occa::sys::free(ptr);
+  }
+  stats = device.memoryPoolStats();
+  const occa::udim_t cachedBlocks = stats.cachedBlocks;
+  for (int i = 0; i < 8; ++i) {
+    occa::memory mem = device.malloc<int>(4, occa::properties("pool: false"));
+    ASSERT_FALSE(mem.getModeMemory()->isPooled);
+    mem.free();
+  }
+  stats = device.memoryPoolStats();
+  ASSERT_SAME_SIZE(stats.cachedBlocks, cachedBlocks);
+}
+
+void testMemoryPlacement() {
+  occa::device device("mode: 'Serial'");
+  const occa::udim_t pageBytes = occa::sys::pageBytes();
+
+  int values[4] = {1, 2, 3, 4};
+  occa::memory mem = device.malloc<int>(4, values, occa::properties("numa: 'first_touch'"));
+  occa::json layout = mem.properties()["layout"];
+  ASSERT_SAME_SIZE((occa::udim_t) mem.ptr() % pageBytes, 0);
+  ASSERT_EQ(mem.ptr<int>()[3], 4);
+  ASSERT_EQ((std::string) layout["numa"], "first_touch");
+  ASSERT_GT((int) layout["first_touch_threads"], 0);
+  ASSERT_SAME_SIZE(device.memoryAllocated(), 4 * sizeof(int));
+
+  // Policies fall back to the default if NUMA isn't available
+  mem = device.malloc<int>(4, values, occa::properties("numa: 'interleave'"));
+  layout = mem.properties()["layout"];
+  ASSERT_EQ(mem.ptr<int>()[3], 4);
+  ASSERT_TRUE(((std::string) layout["numa"] == "interleave")
+              || ((std::string) layout["numa"] == "default"));
+
+  mem = device.malloc<int>(4, values, occa::properties("numa: 0"));
+  layout = mem.properties()["layout"];
+  ASSERT_EQ(mem.ptr<int>()[3], 4);
+  ASSERT_TRUE(((std::string) layout["numa"] == "bind")
+              || ((std::string) layout["numa"] == "default"));
+
+  mem = device.malloc<char>(1000, occa::properties("huge_pages: true"));
+  layout = mem.properties()["layout"];
+  ASSERT_SAME_SIZE((occa::udim_t) mem.ptr() % occa::sys::hugePageBytes(), 0);
+  ASSERT_SAME_SIZE(mem.size(), 1000);
+  ASSERT_SAME_SIZE((double) layout["alignment"], occa::sys::hugePageBytes());
+
+  // Placed pages are unmapped on free with their policies
+  occa::serial::memory *serialMem = (occa::serial::memory*) mem.getModeMemory();
+  ASSERT_EQ(serialMem->mappedPtr, mem.ptr());
+  ASSERT_SAME_SIZE(serialMem->mappedBytes, occa::sys::hugePageBytes());
+
+  // Default allocations don't report a layout
+  mem = device.malloc<int>(4);
+  ASSERT_FALSE(mem.properties().has("layout"));
+
+  ASSERT_THROW(
+    device.malloc<int>(4, occa::properties("numa: 'spread'"));
+  );
+}
+
+void testMmap() {
+  const std::string filename = occa::env::OCCA_CACHE_DIR + "tests/mmap.txt";
+  const int fileBytes = 10000;
+  std::string content(fileBytes, ' ');
+  for (int i = 0; i < fileBytes; ++i) {
+    content[i] = 'a' + (i % 26);
+  }
+  occa::io::write(filename, content);
+
+  occa::device device("mode: 'Serial'");
+
+  // Offsets don't need to be page-aligned
+  {
+    occa::memory mem = device.mmap(filename, 5000, 100);
+    ASSERT_SAME_SIZE(mem.size(), 100);
+    ASSERT_SAME_SIZE(device.memoryAllocated(), 100);
+    ASSERT_EQ(mem.ptr<char>()[0], content[5000]);
+    ASSERT_EQ(mem.ptr<char>()[99], content[5099]);
+
+    // Copy-on-write mappings don't change the file
+    mem.ptr<char>()[0] = '!';
+  }
+  ASSERT_SAME_SIZE(device.memoryAllocated(), 0);
+  ASSERT_EQ(occa::io::read(filename), content);
+
+  // Copy-on-write mappings only need read access to the file,
+  //   root ignores file permissions
+  if (::geteuid() != 0) {
+    ::chmod(filename.c_str(), S_IRUSR);
+    {
+      occa::memory mem = device.mmap(filename, 0, 100);
+      mem.ptr<char>()[0] = '!';
+      ASSERT_EQ(mem.ptr<char>()[1], content[1]);
+    }
+    ::chmod(filename.c_str(), S_IRUSR | S_IWUSR);
+    ASSERT_EQ(occa::io::read(filename), content);
+  }
+
+  // The rest of the file is mapped by default
+  {
+    occa::memory mem = device.mmap(filename, 9000, 0,
+                                   occa::properties("read_only: true, advise: ['sequential', 'willneed']"));
+    ASSERT_SAME_SIZE(mem.size(), 1000);
+    ASSERT_EQ(std::string(mem.ptr<char>(), 1000), content.substr(9000));
+
+    // Mapped memory can be used like other memory
+    char buffer[10];
+    mem.slice(10, 10).copyTo(buffer);
+    ASSERT_EQ(std::string(buffer, 10), content.substr(9010, 10));
+  }
+
+  ASSERT_THROW(
+    device.mmap(filename, 9000, 2000);
+  );
+  ASSERT_THROW(
+    device.mmap(filename, 0, 0, occa::properties("advise: 'soon'"));
+  );
+  ASSERT_SAME_SIZE(device.memoryAllocated(), 0);
+
+  // Chunked uploads used by separate memory spaces
+  {
+    occa::modeMemory_t *modeMemory = device.getModeDevice()->occa::modeDevice_t::mmap(
+      filename, 123, 5000, occa::properties("chunk_bytes: 1024")
+    );
+    occa::memory mem(modeMemory);
+    ASSERT_EQ(std::string(mem.ptr<char>(), 5000), content.substr(123, 5000));
+  }
+
+  occa::sys::rmrf(filename);
+}
+
+void benchmarkMemoryPool() {
+  const int sizes[3] = {1 << 10, 1 << 20, 1 << 26};
+  const int iterations = 1000;
+
+  for (int pool = 0; pool < 2; ++pool) {
+    occa::device device(
+      occa::properties("mode: 'Serial'") + occa::properties(pool ? "memory: { pool: true }" : "")
+    );
+    for (int s = 0; s < 3; ++s) {
+      const double start = occa::sys::currentTime();
+      for (int i = 0; i < iterations; ++i) {
+        occa::memory mem = device.malloc<char>(sizes[s]);
+        // Touch each page like a temporary buffer would
+        char *ptr = mem.ptr<char>();
+        for (int j = 0; j < sizes[s]; j += 4096) {
+          ptr[j] = (char) i;
+        }
+      }
+      const double elapsed = occa::sys::currentTime() - start;
+      std::cout << (pool ? "pooled" : "unpooled")
+                << ", " << occa::stringifyBytes(sizes[s])
+                << ": " << (1e6 * elapsed / iterations) << " us\n";
+    }
+  }
+}
@@ -0,0 +1,44 @@
+#ifndef OCCA_TESTS_CORE_UTILS
+#define OCCA_TESTS_CORE_UTILS
+
+#include <occa.hpp>
+#include <occa/tools/testing.hpp>
+
+//---[ Util Methods ]-------------------
+// Source for [kernelName](int *x), which runs [statement] on x[0]
+std::string valueKernelSource(const std::string &kernelName = "setValue",
+                              const std::string &statement = "x[i] = VALUE;") {
+  return (
+    "@kernel void " + kernelName + "(int *x) {"
+    "  for (int i = 0; i < 1; ++i; @tile(1, @outer, @inner)) {"
+    "    " + statement +
+    "  }"
+    "}"
+  );
+}
+
+// Source for addScalar(entries, value, x), which adds [value] to each entry
+std::string addScalarSource() {
+  return (
+    "@kernel void addScalar(const int entries, const float value, float *x) {"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {"
+    "    x[i] += value;"
+    "  }"
+    "}"
+  );
+}
+
+// Runs a kernel from valueKernelSource() on [value] and returns the new value
+int runValueKernel(occa::kernel kernel,
+                   const int value = 0) {
+  ASSERT_TRUE(kernel.isInitialized());
+
+  int result = value;
+  occa::memory x = kernel.getDevice().malloc(sizeof(int), &result);
+  kernel(x);
+  x.copyTo(&result);
+  return result;
+}
+//======================================
+
+#endif
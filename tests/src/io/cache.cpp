@@ -1,6 +1,10 @@
 #include <stdlib.h>
+#include <sys/time.h>
 #include <time.h>
 
+#include <cstdio>
+#include <fstream>
+
 #include <occa/io.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/testing.hpp>
@@ -8,19 +12,25 @@
 void testCacheInfoMethods();
 void testHashDir();
 void testBuild();
+void testCacheIndex();
+void testCacheEviction();
 
 int main(const int argc, const char **argv) {
-#ifndef USE_CMAKE
-  occa::env::OCCA_CACHE_DIR = occa::io::dirname(__FILE__);
-#endif
+  // Tests clear the whole cache, use a private one
+  char cacheDir[] = "/tmp/occa-cache-test-XXXXXX";
+  ASSERT_TRUE(::mkdtemp(cacheDir) != NULL);
+  occa::env::OCCA_CACHE_DIR = cacheDir;
+  occa::env::OCCA_CACHE_DIR += '/';
+
   srand(time(NULL));
 
   testCacheInfoMethods();
   testHashDir();
   testBuild();
+  testCacheIndex();
+  testCacheEviction();
 
-  occa::sys::rmdir(occa::env::OCCA_CACHE_DIR + "locks",
-                   true);
+  occa::sys::rmdir(occa::env::OCCA_CACHE_DIR, true);
 
   return 0;
 }
@@ -95,3 +105,188 @@ void testBuild() {
 
   occa::sys::rmrf("build.json");
 }
+
+void testCacheIndex() {
+  occa::hash_t hash = occa::hash(occa::toString(rand()));
+  const std::string hashDir = occa::io::hashDir(hash);
+  occa::sys::mkpath(hashDir);
+  occa::io::write(hashDir + "binary", "");
+
+  ASSERT_FALSE(occa::io::cachedFileIsComplete(hashDir, "binary"));
+  occa::io::markCachedFileComplete(hashDir, "binary");
+  ASSERT_TRUE(occa::io::cachedFileIsComplete(hashDir, "binary"));
+
+  // Other processes read the same index
+  {
+    occa::io::cacheIndex_t index;
+    ASSERT_TRUE(index.isComplete(hashDir, "binary"));
+    ASSERT_FALSE(index.isComplete(hashDir, "missing"));
+  }
+
+  // Dependencies
+  occa::json dependencies;
+  dependencies.set("/path/to/header.hpp", hash.getFullString());
+  occa::io::cacheIndex().setDependencies(hash, dependencies);
+  {
+    occa::io::cacheIndex_t index;
+    occa::jsonObject dependencyHashes;
+    ASSERT_TRUE(index.getDependencies(hash, dependencyHashes));
+    ASSERT_EQ((int) dependencyHashes.size(), 1);
+    ASSERT_EQ((std::string) dependencyHashes["/path/to/header.hpp"],
+              hash.getFullString());
+
+    ASSERT_FALSE(index.getDependencies(occa::hash(hash), dependencyHashes));
+  }
+
+  // Records after a partially written record are still found
+  {
+    std::ofstream indexOut((occa::io::cachePath() + "index").c_str(),
+                           std::ios::app | std::ios::binary);
+    indexOut << "partial";
+  }
+
+  occa::io::write(hashDir + "binary2", "");
+  occa::io::markCachedFileComplete(hashDir, "binary2");
+  {
+    occa::io::cacheIndex_t index;
+    ASSERT_TRUE(index.isComplete(hashDir, "binary"));
+    ASSERT_TRUE(index.isComplete(hashDir, "binary2"));
+  }
+
+  // Files removed outside of OCCA aren't reported as complete
+  occa::sys::rmdir(hashDir, true);
+  ASSERT_FALSE(occa::io::cachedFileIsComplete(hashDir, "binary"));
+
+  // Rebuilt files are indexed again
+  occa::sys::mkpath(hashDir);
+  occa::io::write(hashDir + "binary", "");
+  ASSERT_FALSE(occa::io::cachedFileIsComplete(hashDir, "binary"));
+  {
+    occa::io::cacheIndex_t index;
+    ASSERT_FALSE(index.isComplete(hashDir, "binary"));
+  }
+  occa::io::markCachedFileComplete(hashDir, "binary");
+  ASSERT_TRUE(occa::io::cachedFileIsComplete(hashDir, "binary"));
+
+  // Checked hits are trusted until the index changes
+  {
+    occa::io::cacheIndex_t index;
+    ASSERT_TRUE(index.isComplete(hashDir, "binary"));
+    std::remove((hashDir + "binary").c_str());
+    ASSERT_TRUE(index.isComplete(hashDir, "binary"));
+
+    // Evicting other entries bumps the index generation
+    occa::io::cacheIndex().removeDir(occa::io::hashDir(occa::hash(hash)));
+    ASSERT_FALSE(index.isComplete(hashDir, "binary"));
+  }
+
+  occa::sys::rmdir(occa::io::cachePath(), true);
+}
+
+std::string makeCacheEntry(const occa::hash_t &hash,
+                           const std::string &content,
+                           const bool isComplete,
+                           const time_t lastAccess) {
+  const std::string hashDir = occa::io::hashDir(hash);
+  occa::sys::mkpath(hashDir);
+  occa::io::write(hashDir + "binary", content);
+  if (isComplete) {
+    occa::io::markCachedFileComplete(hashDir, "binary");
+  }
+
+  struct timeval times[2];
+  times[0].tv_sec = times[1].tv_sec = lastAccess;
+  times[0].tv_usec = times[1].tv_usec = 0;
+  ::utimes(hashDir.c_str(), times);
+  return hashDir;
+}
+
+std::string makeCacheEntry(const std::string &content,
+                           const bool isComplete,
+                           const time_t lastAccess) {
+  return makeCacheEntry(occa::hash(occa::toString(rand())),
+                        content, isComplete, lastAccess);
+}
+
+void testCacheEviction() {
+  const time_t now = ::time(NULL);
+  const occa::hash_t newestHash = occa::hash(occa::toString(rand()));
+  const std::string oldestDir = makeCacheEntry("a", true, now - 300);
+  const std::string olderDir  = makeCacheEntry("bb", true, now - 200);
+  const std::string newestDir = makeCacheEntry(newestHash, "ccc", true, now - 100);
+
+  occa::io::cacheEntryVector entries = occa::io::getCacheEntries();
+  ASSERT_EQ((int) entries.size(), 3);
+  occa::udim_t totalBytes = 0;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(entries[i].isComplete);
+    ASSERT_FALSE(entries[i].isLocked);
+    totalBytes += entries[i].bytes;
+  }
+  // Binaries and .success/ markers
+  ASSERT_EQ(totalBytes, (occa::udim_t) 6);
+
+  // Entries accessed recently are kept
+  ASSERT_EQ(occa::io::evictCacheEntries(0, 1, 1000), 0);
+
+  // Another process which already loaded the index
+  occa::io::cacheIndex_t otherIndex;
+  ASSERT_TRUE(otherIndex.isComplete(oldestDir, "binary"));
+
+  // Least recently used entries are evicted first
+  ASSERT_EQ(occa::io::evictCacheEntries(0, 2, 0), 1);
+  ASSERT_FALSE(occa::io::isDir(oldestDir));
+  ASSERT_TRUE(occa::io::isDir(olderDir));
+  ASSERT_FALSE(occa::io::cachedFileIsComplete(oldestDir, "binary"));
+  ASSERT_FALSE(otherIndex.isComplete(oldestDir, "binary"));
+
+  // Locked entries are never evicted
+  occa::io::lock_t lock(newestHash, "build");
+  ASSERT_TRUE(lock.isMine());
+
+  entries = occa::io::getCacheEntries();
+  ASSERT_EQ((int) entries.size(), 2);
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(entries[i].isLocked,
+              entries[i].hashDir == newestDir);
+  }
+
+  ASSERT_EQ(occa::io::evictCacheEntries(1, 0, 0), 1);
+  ASSERT_FALSE(occa::io::isDir(olderDir));
+  ASSERT_TRUE(occa::io::isDir(newestDir));
+
+  lock.release();
+  ASSERT_EQ(occa::io::evictCacheEntries(1, 0, 0), 1);
+  ASSERT_EQ((int) occa::io::getCacheEntries().size(), 0);
+
+  // Accessing an entry updates its access time
+  const std::string accessedDir = makeCacheEntry("d", false, now - 300);
+  occa::io::markCacheAccess(accessedDir);
+  entries = occa::io::getCacheEntries();
+  ASSERT_EQ((int) entries.size(), 1);
+  ASSERT_TRUE(now <= (entries[0].lastAccess + 1));
+
+  // Prune removes incomplete entries and stale locks
+  const std::string incompleteDir = makeCacheEntry("e", false, now - 100);
+  const std::string completeDir = makeCacheEntry("f", true, now - 100);
+  const std::string staleLockDir = occa::env::OCCA_CACHE_DIR + "locks/0123456789abcdef_build/";
+  occa::sys::mkpath(staleLockDir);
+
+  // Recently accessed entries are kept
+  ASSERT_EQ(occa::io::pruneCache(50), 1);
+  ASSERT_TRUE(occa::io::isDir(accessedDir));
+  ASSERT_FALSE(occa::io::isDir(incompleteDir));
+
+  ASSERT_EQ(occa::io::pruneCache(0), 2);
+  ASSERT_FALSE(occa::io::isDir(accessedDir));
+  ASSERT_FALSE(occa::io::isDir(staleLockDir));
+  ASSERT_TRUE(occa::io::isDir(completeDir));
+  ASSERT_TRUE(occa::io::cachedFileIsComplete(completeDir, "binary"));
+  {
+    // Compacted index
+    occa::io::cacheIndex_t index;
+    ASSERT_EQ(index.completedFileCount(), 1);
+  }
+
+  occa::sys::rmdir(occa::io::cachePath(), true);
+}
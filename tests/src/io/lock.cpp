@@ -1,7 +1,10 @@
 #include <stdlib.h>
+#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
+#include <thread>
+
 #include <occa/io.hpp>
 #include <occa/tools/env.hpp>
 #include <occa/tools/testing.hpp>
@@ -47,40 +50,65 @@ void testAutoRelease() {
             + hash.getString()
             + "_tag");
   ASSERT_TRUE(lock1.isMine());
+  // Test cached isMine()
+  ASSERT_TRUE(lock1.isMine());
 
   ASSERT_TRUE(occa::io::isDir(lock1.dir()));
 
+  // Waiters are woken up once the holder releases the lock
+  std::thread holder([&]() {
+    ::usleep(100000);
+    lock1.release();
+  });
   occa::io::lock_t lock2(hash, "tag");
-  ASSERT_TRUE(lock2.isMine());
+  ASSERT_FALSE(lock2.isMine());
+  holder.join();
+  ASSERT_FALSE(occa::io::isDir(lock1.dir()));
 
-  ASSERT_TRUE(occa::io::isDir(lock2.dir()));
-  lock2.release();
-  ASSERT_FALSE(occa::io::isDir(lock2.dir()));
+  occa::io::lock_t lock3(hash, "tag");
+  ASSERT_TRUE(lock3.isMine());
+
+  ASSERT_TRUE(occa::io::isDir(lock3.dir()));
+  lock3.release();
+  ASSERT_FALSE(occa::io::isDir(lock3.dir()));
 }
 
 void testStaleRelease() {
   occa::hash_t hash = occa::hash(occa::toString(rand()));
 
+  // Holder exits without releasing the lock
+  const pid_t pid = ::fork();
+  if (!pid) {
+    occa::io::lock_t lock(hash, "tag");
+    ::_exit(lock.isMine() ? 0 : 1);
+  }
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  ASSERT_TRUE(WIFEXITED(status));
+  ASSERT_EQ(WEXITSTATUS(status), 0);
+
   occa::io::lock_t lock1(hash, "tag");
+  ASSERT_TRUE(occa::io::isDir(lock1.dir()));
   ASSERT_TRUE(lock1.isMine());
-  // Test cached isMine()
-  ASSERT_TRUE(lock1.isMine());
+  lock1.release();
+  ASSERT_FALSE(occa::io::isDir(lock1.dir()));
+
+  // Locks left by dead processes without a flock()
+  occa::sys::mkpath(lock1.dir());
+  occa::io::write(lock1.dir() + "/pid",
+                  occa::toString(pid) + ' ' + occa::sys::getHostname());
 
   occa::io::lock_t lock2(hash, "tag");
   ASSERT_TRUE(lock2.isMine());
+  lock2.release();
+  ASSERT_FALSE(occa::io::isDir(lock2.dir()));
 
-  // Wait 0.5 seconds until both locks are considered stale
-  ::usleep(500000);
-
-  // Kill the stale lock
+  // Holders write their host since PIDs can't be checked across hosts
   occa::io::lock_t lock3(hash, "tag");
   ASSERT_TRUE(lock3.isMine());
-
-  lock1.release();
-  lock2.release();
+  ASSERT_EQ(occa::io::read(lock3.dir() + "/pid"),
+            occa::toString(::getpid()) + ' ' + occa::sys::getHostname());
   lock3.release();
-
-  ASSERT_FALSE(occa::io::isDir(lock1.dir()));
 }
 
 void clearLocks() {
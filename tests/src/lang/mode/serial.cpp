@@ -1,11 +1,15 @@
 #define OCCA_TEST_PARSER_TYPE okl::serialParser
 
+#include <occa.hpp>
+#include <occa/lang/modes/cuda.hpp>
 #include <occa/lang/modes/serial.hpp>
 #include "../parserUtils.hpp"
 
 void testPreprocessor();
 void testKernel();
 void testExclusives();
+void testKernelEntries();
+void testLauncherEntries();
 
 int main(const int argc, const char **argv) {
   parser.settings["serial/include_std"] = false;
@@ -17,6 +21,9 @@ int main(const int argc, const char **argv) {
   // parser.settings["okl/validate"] = true;
   // testExclusives();
 
+  testKernelEntries();
+  testLauncherEntries();
+
   return 0;
 }
 
@@ -127,3 +134,82 @@ void testExclusives() {
   );
 }
 //======================================
+
+//---[ Entries ]------------------------
+void testKernelEntries() {
+  // Entries call the kernel through expression nodes
+  okl::serialParser serialParser;
+  serialParser.settings["serial/include_std"] = false;
+  serialParser.parseSource(
+    "@kernel void addOne(const int entries, float *ab) {\n"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {\n"
+    "    ab[i] += 1;\n"
+    "  }\n"
+    "}\n"
+  );
+  ASSERT_TRUE(serialParser.success);
+
+  std::vector<functionDeclStatement*> funcSmnts;
+  blockStatement &root = serialParser.root;
+  for (int i = 0; i < (int) root.children.size(); ++i) {
+    if (root.children[i]->type() & statementType::functionDecl) {
+      funcSmnts.push_back(&(root.children[i]->to<functionDeclStatement>()));
+    }
+  }
+  ASSERT_EQ(2, (int) funcSmnts.size());
+  functionDeclStatement &kernelSmnt = *(funcSmnts[0]);
+  functionDeclStatement &entrySmnt = *(funcSmnts[1]);
+  ASSERT_EQ("_occa_entry_addOne", entrySmnt.function.name());
+  ASSERT_EQ(1, (int) entrySmnt.children.size());
+
+  exprNode *expr = entrySmnt.children[0]->to<expressionStatement>().expr;
+  ASSERT_TRUE(expr->type() & exprNodeType::call);
+
+  callNode &call = expr->to<callNode>();
+  ASSERT_TRUE(call.value->type() & exprNodeType::function);
+  ASSERT_EQ(&(kernelSmnt.function), &(call.value->to<functionNode>().value));
+  ASSERT_EQ(2, (int) call.args.size());
+  // Values are dereferenced, pointers are passed through
+  ASSERT_TRUE(call.args[0]->type() & exprNodeType::leftUnary);
+  ASSERT_TRUE(call.args[1]->type() & exprNodeType::parenCast);
+
+  // Renaming the kernel updates the call
+  kernelSmnt.function.source->value = "addTwo";
+  printer pout;
+  entrySmnt.print(pout);
+  ASSERT_NEQ(std::string::npos,
+             pout.str().find("addTwo(*((const int *) args[0]), (float *) args[1]);"));
+}
+
+void testLauncherEntries() {
+  // Launcher entries call the kernel with the launcher arguments
+  okl::cudaParser cudaParser;
+  cudaParser.parseSource(
+    "@kernel void addVectors(const int entries,\n"
+    "                        const float *a,\n"
+    "                        const float *b,\n"
+    "                        float *ab) {\n"
+    "  for (int i = 0; i < entries; ++i; @tile(16, @outer, @inner)) {\n"
+    "    ab[i] = a[i] + b[i];\n"
+    "  }\n"
+    "}\n"
+  );
+  ASSERT_TRUE(cudaParser.success);
+
+  printer pout;
+  cudaParser.launcherParser.root.print(pout);
+  const std::string launcherSource = pout.str();
+
+  ASSERT_NEQ(std::string::npos,
+             launcherSource.find("(occa::modeKernel_t **) args[0]"));
+  ASSERT_NEQ(std::string::npos,
+             launcherSource.find("(occa::modeMemory_t *) args[4]"));
+
+  // The launcher has to compile as a host kernel
+  occa::device device("mode: 'Serial'");
+  occa::kernel launcher = device.buildKernelFromString(launcherSource,
+                                                       "addVectors",
+                                                       "okl: { enabled: false }");
+  ASSERT_TRUE(launcher.isInitialized());
+}
+//======================================
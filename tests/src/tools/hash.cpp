@@ -0,0 +1,209 @@
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <vector>
+#include <sys/time.h>
+
+#include <occa.hpp>
+#include <occa/tools/testing.hpp>
+
+void testHashValues();
+void testHashMixing();
+void testHashFile();
+void testFileHashCache();
+void benchmarkHash();
+
+int main(const int argc, const char **argv) {
+  testHashValues();
+  testHashMixing();
+  testHashFile();
+  testFileHashCache();
+
+  // Throughput benchmark: tools-hash --benchmark
+  if ((argc > 1) && !strcmp(argv[1], "--benchmark")) {
+    benchmarkHash();
+  }
+
+  return 0;
+}
+
+std::string testData(const int bytes) {
+  std::string data(bytes, '\0');
+  for (int i = 0; i < bytes; ++i) {
+    data[i] = (char) ((i * 31) + (i >> 3));
+  }
+  return data;
+}
+
+void testHashValues() {
+  // Cached kernels are found through these hashes, they can't change
+  const std::string data = testData(1000);
+
+  ASSERT_EQ(occa::hash("", 0, occa::hashVersion::fnv).getFullString(),
+            "978c01009b8c01009d8c0100a18c0100b98c0100c58c0100cd8c0100df8c0100");
+  ASSERT_EQ(occa::hash("occa", 4, occa::hashVersion::fnv).getFullString(),
+            "bd4b1fe8a5453d95f3da20ffe35abee39765dd458bd9b979437177baf5851479");
+  ASSERT_EQ(occa::hash(data.c_str(), data.size(), occa::hashVersion::fnv).getFullString(),
+            "a7e07151abe441ccc522b374b13a1e1751121e0cbde9d2f72dafb04cf73b88cf");
+
+  ASSERT_EQ(occa::hash("", 0, occa::hashVersion::lanes).getFullString(),
+            "a403b13a492be5c1a032c5799a9e85485cf3a9e59c444f6b5db1ea810952b582");
+  ASSERT_EQ(occa::hash("occa", 4, occa::hashVersion::lanes).getFullString(),
+            "df8f998a65b4c48367613f80f20e50c4d16cf48da6d5b55292456fef844ae8d6");
+  ASSERT_EQ(occa::hash(data.c_str(), data.size(), occa::hashVersion::lanes).getFullString(),
+            "0615cc5421e509be3dc4f3b22ce97a12d4834fc35a840f07cbbd9cdc6b3a4006");
+
+  ASSERT_EQ(occa::hash(data), occa::hash(data.c_str(), data.size()));
+}
+
+void testHashMixing() {
+  const std::string data = testData(200);
+  const occa::hash_t dataHash = occa::hash(data.c_str(), data.size(),
+                                           occa::hashVersion::lanes);
+
+  // Zero-padded tails are distinct
+  ASSERT_NEQ(occa::hash("abc", 3, occa::hashVersion::lanes),
+             occa::hash("abc\0", 4, occa::hashVersion::lanes));
+
+  // Flipping any bit changes every word of the hash
+  const int positions[4] = {0, 63, 64, 199};
+  for (int i = 0; i < 4; ++i) {
+    std::string flipped = data;
+    flipped[positions[i]] ^= 0x10;
+    const occa::hash_t flippedHash = occa::hash(flipped.c_str(), flipped.size(),
+                                                occa::hashVersion::lanes);
+    for (int j = 0; j < 8; ++j) {
+      ASSERT_NEQ(dataHash.h[j], flippedHash.h[j]);
+    }
+  }
+
+  // Inputs which only differ in words read by the same lane don't collide,
+  //   independent lanes with 32-bit state would collide ~5 times here
+  const int variations = 200000;
+  std::string blocks = testData(128);
+  std::set<occa::hash_t> hashes;
+  uint64_t state = 1;
+  for (int i = 0; i < variations; ++i) {
+    uint64_t words[2];
+    for (int w = 0; w < 2; ++w) {
+      state = (state * 6364136223846793005ULL) + 1442695040888963407ULL;
+      words[w] = state ^ (state >> 29);
+    }
+    ::memcpy(&blocks[0], &words[0], sizeof(uint64_t));
+    ::memcpy(&blocks[64], &words[1], sizeof(uint64_t));
+    hashes.insert(occa::hash(blocks.c_str(), blocks.size(),
+                             occa::hashVersion::lanes));
+  }
+  ASSERT_EQ((int) hashes.size(), variations);
+}
+
+void testHashFile() {
+  const std::string filename = occa::env::OCCA_CACHE_DIR + "test-hash-file";
+  const std::string data = testData(5000);
+  {
+    std::ofstream out(filename.c_str(), std::ios::binary);
+    out << data;
+  }
+
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash(data));
+
+  occa::io::write(filename, "");
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash(""));
+
+  occa::sys::rmrf(filename);
+}
+
+void writeOldFile(const std::string &filename,
+                  const std::string &content) {
+  occa::io::write(filename, content);
+
+  // Recently modified files aren't memoized
+  struct timeval times[2];
+  times[0].tv_sec = times[1].tv_sec = 1000000000;
+  times[0].tv_usec = times[1].tv_usec = 0;
+  ::utimes(filename.c_str(), times);
+}
+
+void testFileHashCache() {
+  const std::string filename = occa::env::OCCA_CACHE_DIR + "test-hash-file-cache";
+
+  writeOldFile(filename, "aaaa");
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash("aaaa"));
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash("aaaa"));
+
+  // Same size and mtime, the ctime still changes
+  writeOldFile(filename, "bbbb");
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash("bbbb"));
+
+  occa::io::write(filename, "ccccc");
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash("ccccc"));
+
+  // Persisted hashes are shared through the cache index
+  occa::settings()["cache/persist_file_hashes"] = true;
+  occa::clearFileHashCache();
+
+  writeOldFile(filename, "dddd");
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash("dddd"));
+
+  std::string value;
+  ASSERT_TRUE(occa::io::cacheIndex().getFileHash(filename, value));
+  ASSERT_TRUE(occa::endsWith(value, occa::hash("dddd").getFullString()));
+
+  occa::clearFileHashCache();
+  ASSERT_EQ(occa::hashFile(filename),
+            occa::hash("dddd"));
+
+  occa::settings()["cache/persist_file_hashes"] = false;
+  occa::clearFileHashCache();
+  occa::sys::rmrf(filename);
+}
+
+void benchmarkHash() {
+  const int sizes[4] = {64, 4096, 1 << 16, 1 << 24};
+  const double minTime = 0.5;
+
+  for (int s = 0; s < 4; ++s) {
+    const std::string data = testData(sizes[s]);
+    for (int version = occa::hashVersion::fnv; version <= occa::hashVersion::lanes; ++version) {
+      int iterations = 0;
+      occa::hash_t sum;
+      const double start = occa::sys::currentTime();
+      double elapsed = 0;
+      while (elapsed < minTime) {
+        sum ^= occa::hash(data.c_str(), data.size(), version);
+        ++iterations;
+        elapsed = occa::sys::currentTime() - start;
+      }
+      const double gbPerSecond = ((double) sizes[s] * iterations) / (elapsed * 1e9);
+      std::cout << "version " << version
+                << ", " << occa::stringifyBytes(sizes[s])
+                << ": " << gbPerSecond << " GB/s"
+                << " (" << sum << ")\n";
+    }
+  }
+
+  // Memoized hashFile() on an unchanged header
+  const std::string filename = occa::env::OCCA_CACHE_DIR + "test-hash-file-benchmark";
+  writeOldFile(filename, testData(1 << 14));
+  for (int memoized = 0; memoized < 2; ++memoized) {
+    const int iterations = 10000;
+    const double start = occa::sys::currentTime();
+    for (int i = 0; i < iterations; ++i) {
+      if (!memoized) {
+        occa::clearFileHashCache();
+      }
+      occa::hashFile(filename);
+    }
+    const double elapsed = occa::sys::currentTime() - start;
+    std::cout << "hashFile (" << (memoized ? "memoized" : "rehashed")
+              << "): " << (1e6 * elapsed / iterations) << " us\n";
+  }
+  occa::sys::rmrf(filename);
+}
@@ -148,6 +148,21 @@ void testHex() {
             "4 TB");
   ASSERT_EQ(stringifyBytes(1L << 52),
             toString(1L << 52) + " bytes");
+
+  ASSERT_EQ(parseBytes("512"),
+            (udim_t) 512);
+  ASSERT_EQ(parseBytes("4 bytes"),
+            (udim_t) 4);
+  ASSERT_EQ(parseBytes("4 KB"),
+            (udim_t) (1L << 12));
+  ASSERT_EQ(parseBytes("1.5GB"),
+            (udim_t) (3L << 29));
+  ASSERT_EQ(parseBytes("2g"),
+            (udim_t) (1L << 31));
+  ASSERT_EQ(parseBytes("size"),
+            (udim_t) 0);
+  ASSERT_EQ(parseBytes("4 XB"),
+            (udim_t) 0);
 }
 
 void testJoin() {
@@ -1,17 +1,25 @@
 #include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
 #include <sstream>
 
 #include <occa.hpp>
 #include <occa/tools/testing.hpp>
 
 void testRmrf();
+void testSplitCommand();
+void testSpawn();
+void testCompilerCapabilities();
 
 int main(const int argc, const char **argv) {
   srand(time(NULL));
 
   testRmrf();
+  testSplitCommand();
+  testSpawn();
+  testCompilerCapabilities();
 
   return 0;
 }
@@ -64,3 +72,103 @@ void testRmrf() {
   occa::settings()["sys/safe_rmrf"] = false;
   occa::sys::rmrf(filename);
 }
+
+void testSplitCommand() {
+  occa::strVector args = occa::sys::splitCommand(
+    "  g++ -O3 'a b.cpp' \"-DX=\\\"y z\\\"\" c\\ d  "
+  );
+  ASSERT_EQ((int) args.size(), 5);
+  ASSERT_EQ(args[0], "g++");
+  ASSERT_EQ(args[1], "-O3");
+  ASSERT_EQ(args[2], "a b.cpp");
+  ASSERT_EQ(args[3], "-DX=\"y z\"");
+  ASSERT_EQ(args[4], "c d");
+
+  args = occa::sys::splitCommand("\"a\\nb\" \"\\\\\\$\\`\"");
+  ASSERT_EQ((int) args.size(), 2);
+  ASSERT_EQ(args[0], "a\\nb");
+  ASSERT_EQ(args[1], "\\$`");
+
+  ASSERT_EQ((int) occa::sys::splitCommand("a ''").size(), 2);
+  ASSERT_EQ((int) occa::sys::splitCommand("  ").size(), 0);
+
+  ASSERT_FALSE(occa::sys::commandNeedsShell("g++ -o binary source.cpp"));
+  ASSERT_TRUE(occa::sys::commandNeedsShell("source env.sh && g++"));
+  ASSERT_TRUE(occa::sys::commandNeedsShell("g++ > build.log"));
+}
+
+void testSpawn() {
+  occa::sys::spawnResult result = occa::sys::spawn("echo hello world");
+  ASSERT_TRUE(result.succeeded());
+  ASSERT_EQ(result.output, "hello world\n");
+
+  // stdout and stderr are both captured
+  result = occa::sys::spawn("echo out; echo err 1>&2; exit 3");
+  ASSERT_FALSE(result.succeeded());
+  ASSERT_FALSE(result.timedOut);
+  ASSERT_EQ(result.exitCode, 3);
+  ASSERT_EQ(result.output, "out\nerr\n");
+
+  // Missing programs
+  result = occa::sys::spawn("occa_missing_program_for_this_sys_test");
+  ASSERT_FALSE(result.succeeded());
+  ASSERT_EQ(result.exitCode, 127);
+
+  // Timeouts kill the process
+  const double start = occa::sys::currentTime();
+  result = occa::sys::spawn("sleep 10", 0.2);
+  ASSERT_TRUE(result.timedOut);
+  ASSERT_FALSE(result.succeeded());
+  ASSERT_LT(occa::sys::currentTime() - start, 5.0);
+}
+
+void setModifiedTime(const std::string &filename,
+                     const time_t seconds,
+                     const int microseconds) {
+  struct timeval times[2];
+  times[0].tv_sec = times[1].tv_sec = seconds;
+  times[0].tv_usec = times[1].tv_usec = microseconds;
+  ::utimes(filename.c_str(), times);
+}
+
+void testCompilerCapabilities() {
+  const std::string compiler = occa::env::OCCA_CACHE_DIR + "test-compiler";
+  const time_t modifiedTime = ::time(NULL) - 10;
+  occa::io::write(compiler, "#!/bin/sh\necho 1\n");
+  ::chmod(compiler.c_str(), 0755);
+  setModifiedTime(compiler, modifiedTime, 0);
+
+  std::string value;
+  ASSERT_FALSE(occa::sys::getCompilerCapability(compiler, "flag", value));
+
+  occa::sys::setCompilerCapability(compiler, "flag", "-fflag");
+  ASSERT_TRUE(occa::sys::getCompilerCapability(compiler, "flag", value));
+  ASSERT_EQ(value, "-fflag");
+
+  // Capabilities are stored for other processes
+  std::string record;
+  ASSERT_TRUE(occa::io::cacheIndex().getToolchain(compiler, record));
+  ASSERT_NEQ(record.find("-fflag"), std::string::npos);
+
+  // Replacing the compiler drops its capabilities, even with the same size
+  //   and within the same second
+  const std::string stamp = occa::sys::compilerStamp(compiler);
+  occa::io::write(compiler, "#!/bin/sh\necho 2\n");
+  setModifiedTime(compiler, modifiedTime, 500000);
+  ASSERT_NEQ(occa::sys::compilerStamp(compiler), stamp);
+  ASSERT_FALSE(occa::sys::getCompilerCapability(compiler, "flag", value));
+
+  // Symlinks are resolved to the compiler they point to
+  const std::string link = compiler + "-link";
+  ::symlink(compiler.c_str(), link.c_str());
+  ASSERT_EQ(occa::sys::compilerStamp(link), occa::sys::compilerStamp(compiler));
+
+  // Detected capabilities are reused
+  const int vendor = occa::sys::compilerVendor("g++");
+  ASSERT_TRUE(occa::sys::getCompilerCapability("g++", "vendor", value));
+  ASSERT_EQ(value, occa::toString(vendor));
+  ASSERT_EQ(occa::sys::compilerVendor("g++"), vendor);
+
+  occa::sys::rmrf(link);
+  occa::sys::rmrf(compiler);
+}
@@ -1,15 +1,32 @@
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <sstream>
+#include <thread>
+
 #include <occa/tools/testing.hpp>
 
 #include <occa.hpp>
+#include <occa/modes/serial/device.hpp>
 
 void testPtrRange();
+void testPtrRangeMap();
 void testUva();
 void testUvaNull();
+void testDirtyRanges();
+void benchmarkUvaLookup();
 
 int main(const int argc, const char **argv) {
   testPtrRange();
+  testPtrRangeMap();
   testUva();
   testUvaNull();
+  testDirtyRanges();
+
+  // Lookup benchmark: tools-uva --benchmark
+  if ((argc > 1) && !strcmp(argv[1], "--benchmark")) {
+    benchmarkUvaLookup();
+  }
 
   return 0;
 }
@@ -64,6 +81,96 @@ void testPtrRange() {
   std::cout << "Testing ptrRange output: " << range << '\n';
 }
 
+void testPtrRangeMap() {
+  // Ranges [100 * i, 100 * i + 50) inserted out of order to split blocks
+  const int rangeCount = 5 * occa::ptrRangeMap::maxBlockEntries;
+  std::vector<int> order;
+  for (int i = 1; i <= rangeCount; ++i) {
+    order.push_back(i);
+  }
+  std::random_shuffle(order.begin(), order.end());
+
+#define RANGE_PTR(offset) ((char*) (size_t) (offset))
+#define RANGE_MEMORY(i) ((occa::modeMemory_t*) RANGE_PTR(i))
+
+  occa::ptrRangeMap map;
+  ASSERT_EQ(map.find(RANGE_PTR(100)),
+            (occa::modeMemory_t*) NULL);
+
+  for (int i = 0; i < rangeCount; ++i) {
+    const int r = order[i];
+    map.insert(occa::ptrRange(RANGE_PTR(100 * r), 50),
+               RANGE_MEMORY(r));
+  }
+  ASSERT_EQ((int) map.size(), rangeCount);
+
+  for (int r = 1; r <= rangeCount; ++r) {
+    ASSERT_EQ(map.find(RANGE_PTR(100 * r)), RANGE_MEMORY(r));
+    ASSERT_EQ(map.find(RANGE_PTR(100 * r + 49)), RANGE_MEMORY(r));
+    ASSERT_EQ(map.find(RANGE_PTR(100 * r + 50)), (occa::modeMemory_t*) NULL);
+    ASSERT_EQ(map.find(RANGE_PTR(100 * r - 1)), (occa::modeMemory_t*) NULL);
+  }
+  ASSERT_EQ(map.find(RANGE_PTR(0)), (occa::modeMemory_t*) NULL);
+
+  // Overlapping ranges replace the existing range
+  map.insert(occa::ptrRange(RANGE_PTR(110), 10),
+             RANGE_MEMORY(0));
+  ASSERT_EQ(map.find(RANGE_PTR(115)), RANGE_MEMORY(0));
+  ASSERT_EQ(map.find(RANGE_PTR(100)), (occa::modeMemory_t*) NULL);
+  ASSERT_EQ((int) map.size(), rangeCount);
+  map.insert(occa::ptrRange(RANGE_PTR(100), 50),
+             RANGE_MEMORY(1));
+
+  // Empty ranges only match their start
+  map.insert(RANGE_PTR(75), RANGE_MEMORY(-1));
+  ASSERT_EQ(map.find(RANGE_PTR(75)), RANGE_MEMORY(-1));
+  ASSERT_EQ(map.find(RANGE_PTR(76)), (occa::modeMemory_t*) NULL);
+  map.erase(RANGE_PTR(75));
+
+  // Erase every other range from the middle of the ranges
+  for (int i = 0; i < rangeCount; ++i) {
+    const int r = order[i];
+    if (r % 2) {
+      map.erase(RANGE_PTR(100 * r + 25));
+    }
+  }
+  ASSERT_EQ((int) map.size(), rangeCount / 2);
+  for (int r = 1; r <= rangeCount; ++r) {
+    ASSERT_EQ(map.find(RANGE_PTR(100 * r + 25)),
+              (r % 2) ? (occa::modeMemory_t*) NULL : RANGE_MEMORY(r));
+  }
+
+  // Lookups run alongside inserts and erases
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t) {
+    readers.push_back(std::thread([&]() {
+      for (int i = 0; i < 20000; ++i) {
+        const int r = 2 * (1 + (i % (rangeCount / 2)));
+        if (map.find(RANGE_PTR(100 * r)) != RANGE_MEMORY(r)) {
+          OCCA_FORCE_ERROR("Range [" << r << "] wasn't found");
+        }
+      }
+    }));
+  }
+  for (int i = 0; i < 20000; ++i) {
+    const int r = 1 + 2 * (i % (rangeCount / 2));
+    map.insert(occa::ptrRange(RANGE_PTR(100 * r), 50),
+               RANGE_MEMORY(r));
+    map.erase(RANGE_PTR(100 * r));
+  }
+  for (int t = 0; t < 4; ++t) {
+    readers[t].join();
+  }
+  ASSERT_EQ((int) map.size(), rangeCount / 2);
+
+  map.clear();
+  ASSERT_EQ((int) map.size(), 0);
+  ASSERT_EQ(map.find(RANGE_PTR(200)), (occa::modeMemory_t*) NULL);
+
+#undef RANGE_PTR
+#undef RANGE_MEMORY
+}
+
 void testUva() {
   int *ptr = occa::umalloc<int>(10);
 
@@ -140,3 +247,186 @@ void testUvaNull() {
 
   delete [] ptr;
 }
+
+// Serial device which copies memory like devices with their own memory
+class separateDevice : public occa::serial::device {
+public:
+  separateDevice(const occa::properties &properties_) :
+    occa::serial::device(properties_) {}
+
+  bool hasSeparateMemorySpace() const {
+    return true;
+  }
+};
+
+std::string rangesToString(const occa::dirtyRanges_t &ranges) {
+  std::stringstream ss;
+  occa::dirtyRanges_t::rangeMap::const_iterator it = ranges.ranges.begin();
+  while (it != ranges.ranges.end()) {
+    ss << '[' << it->first << ',' << it->second << ')';
+    ++it;
+  }
+  return ss.str();
+}
+
+void testDirtyRanges() {
+  occa::dirtyRanges_t ranges;
+  ranges.granularity = 16;
+  ranges.add(20, 4, 100);
+  ranges.add(50, 4, 100);
+  ASSERT_EQ(rangesToString(ranges), "[16,32)[48,64)");
+  // Ranges are clamped to the memory size and merged if they touch
+  ranges.add(90, 20, 100);
+  ranges.add(0, 1, 100);
+  ranges.add(30, 20, 100);
+  ASSERT_EQ(rangesToString(ranges), "[0,64)[80,100)");
+  ASSERT_EQ((int) ranges.toJson().array().size(), 2);
+  ASSERT_EQ((int) ranges.bytes(), 84);
+  ranges.clear();
+  ASSERT_TRUE(ranges.isEmpty());
+
+  // Removed bytes split the ranges around them
+  ranges.add(0, 100, 100);
+  ranges.remove(20, 30);
+  ASSERT_EQ(rangesToString(ranges), "[0,20)[50,100)");
+  ranges.remove(90, 20);
+  ranges.remove(0, 20);
+  ASSERT_EQ(rangesToString(ranges), "[50,90)");
+  ranges.clear();
+
+  occa::device device(new separateDevice(occa::properties("mode: 'Serial'")));
+  device.setStream(device.createStream());
+  const int entries = 1024;
+  int *ptr = (int*) device.umalloc(entries, occa::dtype::int32,
+                                   occa::properties("dirty_tracking: true, dirty_granularity: 64"));
+  occa::memory mem(ptr);
+  int *devicePtr = mem.ptr<int>();
+  ASSERT_NEQ(ptr, devicePtr);
+
+  for (int i = 0; i < entries; ++i) {
+    ptr[i] = i;
+  }
+  occa::resetUvaSyncStats();
+
+  // The first copy sends everything
+  occa::kernelArg(ptr).args[0].setupForKernelCall(false);
+  ASSERT_TRUE(mem.inDevice());
+  ASSERT_EQ(devicePtr[entries - 1], entries - 1);
+  ASSERT_EQ((int) occa::getUvaSyncStats().copiedBytes, entries * 4);
+
+  // Device changes are copied back from the marked ranges
+  devicePtr[10] = -10;
+  devicePtr[500] = -500;
+  occa::markDirty(ptr + 10, sizeof(int));
+  ASSERT_EQ(rangesToString(mem.dirtyRanges()), "[0,64)");
+  device.finish();
+  ASSERT_FALSE(mem.inDevice());
+  ASSERT_EQ(ptr[10], -10);
+  ASSERT_EQ(ptr[500], 500);
+  ASSERT_EQ((int) occa::getUvaSyncStats().copiedBytes, entries * 4 + 64);
+  ASSERT_EQ((int) occa::getUvaSyncStats().savedBytes, entries * 4 - 64);
+
+  // Host changes are copied to the device from the marked ranges
+  ptr[600] = -600;
+  ptr[900] = -900;
+  mem.markDirty(sizeof(int), 600 * sizeof(int));
+  occa::syncToDevice(ptr);
+  ASSERT_EQ(devicePtr[600], -600);
+  ASSERT_EQ(devicePtr[900], 900);
+  ASSERT_TRUE(mem.dirtyRanges().isEmpty());
+
+  // Partial syncs keep the other dirty ranges
+  ptr[100] = -100;
+  ptr[800] = -800;
+  mem.markDirty(sizeof(int), 100 * sizeof(int));
+  mem.markDirty(sizeof(int), 800 * sizeof(int));
+  ASSERT_EQ(rangesToString(mem.dirtyRanges()), "[384,448)[3200,3264)");
+  mem.syncToDevice(64, 384);
+  ASSERT_EQ(devicePtr[100], -100);
+  ASSERT_EQ(devicePtr[800], 800);
+  ASSERT_EQ(rangesToString(mem.dirtyRanges()), "[3200,3264)");
+  occa::syncToDevice(ptr);
+  ASSERT_EQ(devicePtr[800], -800);
+  ASSERT_TRUE(mem.dirtyRanges().isEmpty());
+
+  // Explicit ranges are copied as requested
+  mem.syncToHost(sizeof(int), 500 * sizeof(int));
+  ASSERT_EQ(ptr[500], -500);
+
+  occa::freeUvaPtr(ptr);
+
+  // Memory without dirty tracking is fully copied
+  ptr = (int*) device.umalloc(entries, occa::dtype::int32);
+  occa::markDirty(ptr, sizeof(int));
+  ASSERT_TRUE(occa::memory(ptr).dirtyRanges().isEmpty());
+  occa::resetUvaSyncStats();
+  occa::syncToDevice(ptr);
+  occa::syncToDevice(ptr);
+  ASSERT_EQ((int) occa::getUvaSyncStats().copiedBytes, 2 * entries * 4);
+  ASSERT_EQ((int) occa::getUvaSyncStats().savedBytes, 0);
+  occa::freeUvaPtr(ptr);
+}
+
+void benchmarkUvaLookup() {
+  const int allocationCounts[3] = {1000, 10000, 100000};
+  const int lookups = 1000000;
+  const int threadCount = 4;
+
+  occa::device device("mode: 'Serial'");
+  for (int c = 0; c < 3; ++c) {
+    const int allocationCount = allocationCounts[c];
+
+    std::vector<int*> ptrs;
+    std::map<occa::ptrRange, occa::modeMemory_t*> rangeMap;
+    for (int i = 0; i < allocationCount; ++i) {
+      int *ptr = device.umalloc<int>(16);
+      ptrs.push_back(ptr);
+      rangeMap[occa::ptrRange(ptr, 16 * sizeof(int))] = occa::uvaToMemory(ptr);
+    }
+
+    // Random pointers inside the allocations
+    std::vector<int*> lookupPtrs;
+    for (int i = 0; i < lookups; ++i) {
+      lookupPtrs.push_back(ptrs[rand() % allocationCount] + (rand() % 16));
+    }
+
+    double start = occa::sys::currentTime();
+    size_t found = 0;
+    for (int i = 0; i < lookups; ++i) {
+      found += (rangeMap.find(lookupPtrs[i]) != rangeMap.end());
+    }
+    const double mapTime = occa::sys::currentTime() - start;
+
+    start = occa::sys::currentTime();
+    for (int i = 0; i < lookups; ++i) {
+      found += occa::isManaged(lookupPtrs[i]);
+    }
+    const double uvaTime = occa::sys::currentTime() - start;
+
+    // Each thread does the same lookups
+    start = occa::sys::currentTime();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+      threads.push_back(std::thread([&]() {
+        for (int i = 0; i < lookups; ++i) {
+          occa::uvaToMemory(lookupPtrs[i]);
+        }
+      }));
+    }
+    for (int t = 0; t < threadCount; ++t) {
+      threads[t].join();
+    }
+    const double threadedTime = occa::sys::currentTime() - start;
+
+    ASSERT_EQ((int) found, 2 * lookups);
+
+    std::cout << allocationCount << " allocations:"
+              << " std::map " << (1e9 * mapTime / lookups) << " ns,"
+              << " isManaged " << (1e9 * uvaTime / lookups) << " ns,"
+              << " " << threadCount << " threads " << (1e9 * threadedTime / lookups) << " ns per lookup\n";
+
+    for (int i = 0; i < allocationCount; ++i) {
+      occa::freeUvaPtr(ptrs[i]);
+    }
+  }
+}